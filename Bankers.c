@@ -7,11 +7,43 @@
  *
  * It uses dynamic memory allocation (malloc, free) to manage the
  * Available, Max, Allocation, and Need data structures.
+ *
+ * Each matrix lives in ONE contiguous block with spare capacity in both
+ * dimensions (rows and columns are doubled when full), so processes and
+ * resource types can be added at runtime in amortized O(1) without
+ * re-entering the whole state. Finished processes free their row (slot),
+ * which the next admitted process reuses.
+ *
+ * Usage:
+ *   ./Bankers                                  interactive simulation
+ *   ./Bankers replay <trace> [-v]              replay a recorded trace
+ *   ./Bankers generate <n> <m> <contention> <events> [seed] > trace
+ *                                              record a synthetic workload
+ *   ./Bankers bench                            safety-engine benchmark
+ *
+ * Quiet checks (replay, generate, bench) use safety kernels specialized
+ * for a constant number of resource types (1-16, 32, 64) when one exists,
+ * and oskBankerIsSafe() from oskernels.c otherwise.
+ * Build: make Bankers  (or: gcc Bankers.c oskernels.c -pthread -o Bankers)
+ *
+ * Trace format (text, '#' starts a comment line):
+ *   n m                 number of processes and resource types
+ *   T0 .. Tm-1          total instances of each resource
+ *   n rows of m values  the Max matrix (nothing is allocated at start)
+ *   then one event per line:
+ *   R pid v0 .. vm-1    request
+ *   L pid v0 .. vm-1    release
+ *   F pid               process finishes
+ *   A v0 .. vm-1        admit a new process with this Max vector
  */
 
 #include <stdio.h>
 #include <stdlib.h> // For malloc, free, and exit
 #include <stdbool.h> // For bool, true, and false
+#include <string.h> // For memcpy, memset and strcmp
+#include <time.h> // For clock_gettime in replay/bench
+#include "perfprof.h" // For perfPhase(): PERFPROF=1 prints counters per phase
+#include "oskernels.h" // For oskBankerIsSafe(), the quiet generic safety check
 
 // --- Global Variables ---
 // We use global *pointers* for the main data structures.
@@ -22,23 +54,84 @@ int **Max;        // 2D Array (matrix)
 int **Allocation; // 2D Array (matrix)
 int **Need;       // 2D Array (matrix)
 
-int numProcesses; // Total number of processes
+// When false (replay/bench), the step-by-step logs are suppressed.
+bool verboseLog = true;
+#define LOG(...) do { if (verboseLog) printf(__VA_ARGS__); } while (0)
+
+int numProcesses; // Total number of process slots (including finished ones)
 int numResources; // Total number of resource types
 
+// --- Contiguous storage behind the matrices ---
+// Max[i] == MaxData + i * resCapacity, and likewise for the others.
+int *MaxData;
+int *AllocationData;
+int *NeedData;
+int *Total;       // Total instances of each resource type
+bool *Active;     // Active[i] is false once P[i] has finished
+int *freeSlots;   // Stack of finished slots, reused by admitProcess()
+int numFreeSlots;
+int procCapacity; // Rows allocated
+int resCapacity;  // Columns allocated (the row stride)
+
+// --- Fixed-size kernels ---
+// When false, the quiet paths always use the generic loops (for bench).
+bool useFixedKernels = true;
+#define MAX_FIXED_RESOURCES 64
+
+// --- Cached safety information ---
+// A safe sequence of the active processes, kept up to date by every
+// operation so that most requests never need a full safety search.
+int *cachedSafeSequence;
+int cachedSafeLength;
+bool cacheValid;
+
 // --- Function Prototypes ---
 void allocateMemory();
 void freeMemory();
 void getUserInput();
 void calculateNeedMatrix();
 bool isSafe(int safeSequence[]);
+bool isSafeWithRequest(int processID, const int request[], int safeSequence[]);
 bool resourceRequest(int processID, int request[]);
+bool cachedSequenceHolds(int processID, const int request[]);
+bool releaseResources(int processID, int release[]);
+void finishProcess(int processID);
+int admitProcess(int max[]);
+bool addResourceType(int total, int maxColumn[]);
+void growProcesses();
+void growResources();
 void printState();
+int replayTrace(const char *path);
+int generateTrace(int n, int m, double contention, long events, unsigned int seed);
+int runBenchmark();
+static int runKernelBenchmark();
 
 /**
  * @brief Main function to drive the Banker's Algorithm simulation.
  */
-int main() {
+int main(int argc, char *argv[]) {
+    // --- 0. Non-interactive modes ---
+    if (argc >= 3 && strcmp(argv[1], "replay") == 0) {
+        verboseLog = (argc >= 4 && strcmp(argv[3], "-v") == 0);
+        return replayTrace(argv[2]);
+    }
+    if (argc >= 6 && strcmp(argv[1], "generate") == 0) {
+        unsigned int seed = (argc >= 7) ? (unsigned int)strtoul(argv[6], NULL, 10) : 1;
+        verboseLog = false;
+        return generateTrace(atoi(argv[2]), atoi(argv[3]), atof(argv[4]), atol(argv[5]), seed);
+    }
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0) {
+        verboseLog = false;
+        perfPhase("bench");
+        return runBenchmark();
+    }
+    if (argc >= 2) {
+        printf("Usage: %s [replay <trace> [-v] | generate <n> <m> <contention> <events> [seed] | bench]\n", argv[0]);
+        return 1;
+    }
+
     // --- 1. Get Initial Sizes ---
+    perfPhase("input");
     printf("--- Banker's Algorithm (Dynamic) ---\n");
     printf("Enter total number of processes: ");
     scanf("%d", &numProcesses);
@@ -54,21 +147,27 @@ int main() {
     getUserInput();
 
     // --- 4. Calculate Need Matrix ---
+    perfPhase("compute");
     // Need = Max - Allocation
     calculateNeedMatrix();
 
     // --- 5. Print Initial State ---
+    perfPhase("output");
     printf("\n### System Initial State ###\n");
     printState();
 
     // --- 6. Check Initial Safety ---
+    perfPhase("compute");
     printf("\n### Running Safety Algorithm on Initial State ###\n");
     
     // We can use a VLA (Variable Length Array) here,
     // as numProcesses is now known.
     int safeSequence[numProcesses]; 
     
-    if (isSafe(safeSequence)) {
+    cacheValid = isSafe(safeSequence);
+    if (cacheValid) {
+        memcpy(cachedSafeSequence, safeSequence, numProcesses * sizeof(int));
+        cachedSafeLength = numProcesses;
         printf("SUCCESS: System is in a SAFE state.\n");
         printf("Safe Sequence: ");
         for (int i = 0; i < numProcesses; i++) {
@@ -80,38 +179,79 @@ int main() {
         printf("FAILURE: System is in an UNSAFE state.\n");
     }
 
-    // --- 7. Interactive Request Loop ---
+    // --- 7. Interactive Simulation Loop ---
+    perfPhase("interactive");
     printf("\n----------------------------------------------\n");
     printf("### Resource Request Simulation ###\n");
     
-    char choice = 'y';
-    while (choice == 'y' || choice == 'Y') {
+    int choice = 0;
+    while (choice != 6) {
         int pid;
-        // Use a VLA for the request vector
-        int request[numResources];
 
-        printf("\nDo you want to make a resource request? (y/n): ");
-        scanf(" %c", &choice);
-        
-        if (choice != 'y' && choice != 'Y') {
+        printf("\n1. Request resources\n");
+        printf("2. Release resources\n");
+        printf("3. Process finishes\n");
+        printf("4. Admit a new process\n");
+        printf("5. Add a resource type\n");
+        printf("6. Exit\n");
+        printf("Enter your choice (1-6): ");
+        if (scanf("%d", &choice) != 1) {
             break;
         }
 
-        printf("Enter process ID (0 to %d) making the request: ", numProcesses - 1);
-        scanf("%d", &pid);
+        if (choice == 1 || choice == 2 || choice == 3) {
+            printf("Enter process ID (0 to %d): ", numProcesses - 1);
+            scanf("%d", &pid);
 
-        if (pid < 0 || pid >= numProcesses) {
-            printf("Invalid process ID. Please try again.\n");
-            continue;
+            if (pid < 0 || pid >= numProcesses || !Active[pid]) {
+                printf("Invalid process ID. Please try again.\n");
+                continue;
+            }
         }
 
-        printf("Enter the request vector for P%d (e.g., '1 0 2'): ", pid);
-        for (int j = 0; j < numResources; j++) {
-            scanf("%d", &request[j]);
-        }
+        if (choice == 1) {
+            // Use a VLA for the request vector
+            int request[numResources];
+            printf("Enter the request vector for P%d (e.g., '1 0 2'): ", pid);
+            for (int j = 0; j < numResources; j++) {
+                scanf("%d", &request[j]);
+            }
+
+            // Call the resource-request algorithm
+            resourceRequest(pid, request);
+        } else if (choice == 2) {
+            int release[numResources];
+            printf("Enter the release vector for P%d: ", pid);
+            for (int j = 0; j < numResources; j++) {
+                scanf("%d", &release[j]);
+            }
+            releaseResources(pid, release);
+        } else if (choice == 3) {
+            finishProcess(pid);
+        } else if (choice == 4) {
+            int max[numResources];
+            printf("Enter the Max vector for the new process: ");
+            for (int j = 0; j < numResources; j++) {
+                scanf("%d", &max[j]);
+            }
+            admitProcess(max);
+        } else if (choice == 5) {
+            int total;
+            printf("Enter total instances of the new resource R%d: ", numResources);
+            scanf("%d", &total);
 
-        // Call the resource-request algorithm
-        resourceRequest(pid, request);
+            int maxColumn[numProcesses];
+            for (int i = 0; i < numProcesses; i++) {
+                maxColumn[i] = 0;
+                if (Active[i]) {
+                    printf("Max of R%d for P%d: ", numResources, i);
+                    scanf("%d", &maxColumn[i]);
+                }
+            }
+            addResourceType(total, maxColumn);
+        } else {
+            continue;
+        }
 
         // Print the state after the attempt
         printf("\nCurrent system state:\n");
@@ -126,56 +266,151 @@ int main() {
     return 0;
 }
 
+// Points every row of the three matrices into their contiguous blocks.
+static void rebuildRowPointers() {
+    for (int i = 0; i < procCapacity; i++) {
+        Max[i] = MaxData + (size_t)i * resCapacity;
+        Allocation[i] = AllocationData + (size_t)i * resCapacity;
+        Need[i] = NeedData + (size_t)i * resCapacity;
+    }
+}
+
 /**
  * @brief Allocates memory for all global data structures based on
- * numProcesses and numResources.
+ * numProcesses and numResources (plus room to grow).
  */
 void allocateMemory() {
-    // Allocate 1D array for Available
-    Available = (int *)malloc(numResources * sizeof(int));
+    procCapacity = numProcesses < 4 ? 4 : numProcesses;
+    resCapacity = numResources < 4 ? 4 : numResources;
+
+    // Allocate 1D arrays for Available and Total
+    Available = (int *)calloc(resCapacity, sizeof(int));
+    Total = (int *)calloc(resCapacity, sizeof(int));
+
+    // One contiguous block per matrix
+    MaxData = (int *)calloc((size_t)procCapacity * resCapacity, sizeof(int));
+    AllocationData = (int *)calloc((size_t)procCapacity * resCapacity, sizeof(int));
+    NeedData = (int *)calloc((size_t)procCapacity * resCapacity, sizeof(int));
+
+    // Row pointers, so Max[i][j] keeps working
+    Max = (int **)malloc(procCapacity * sizeof(int *));
+    Allocation = (int **)malloc(procCapacity * sizeof(int *));
+    Need = (int **)malloc(procCapacity * sizeof(int *));
 
-    // Allocate 2D arrays (array of pointers)
-    Max = (int **)malloc(numProcesses * sizeof(int *));
-    Allocation = (int **)malloc(numProcesses * sizeof(int *));
-    Need = (int **)malloc(numProcesses * sizeof(int *));
+    Active = (bool *)malloc(procCapacity * sizeof(bool));
+    freeSlots = (int *)malloc(procCapacity * sizeof(int));
+    cachedSafeSequence = (int *)malloc(procCapacity * sizeof(int));
 
     // Check for malloc failure (simplified check)
-    if (Available == NULL || Max == NULL || Allocation == NULL || Need == NULL) {
+    if (Available == NULL || Total == NULL || MaxData == NULL || AllocationData == NULL ||
+        NeedData == NULL || Max == NULL || Allocation == NULL || Need == NULL ||
+        Active == NULL || freeSlots == NULL || cachedSafeSequence == NULL) {
         printf("Error: Memory allocation failed!\n");
         exit(1);
     }
 
-    // Allocate memory for each row (each process's vector)
-    for (int i = 0; i < numProcesses; i++) {
-        Max[i] = (int *)malloc(numResources * sizeof(int));
-        Allocation[i] = (int *)malloc(numResources * sizeof(int));
-        Need[i] = (int *)malloc(numResources * sizeof(int));
-        
-        if (Max[i] == NULL || Allocation[i] == NULL || Need[i] == NULL) {
-            printf("Error: Row memory allocation failed!\n");
-            exit(1);
-        }
+    rebuildRowPointers();
+    for (int i = 0; i < procCapacity; i++) {
+        Active[i] = i < numProcesses;
     }
+    numFreeSlots = 0;
+    cachedSafeLength = 0;
+    cacheValid = false;
+}
+
+/**
+ * @brief Doubles the number of rows. The row stride does not change, so
+ * realloc() keeps every existing row in place.
+ */
+void growProcesses() {
+    int newCapacity = procCapacity * 2;
+    size_t cells = (size_t)newCapacity * resCapacity;
+    size_t oldCells = (size_t)procCapacity * resCapacity;
+
+    MaxData = (int *)realloc(MaxData, cells * sizeof(int));
+    AllocationData = (int *)realloc(AllocationData, cells * sizeof(int));
+    NeedData = (int *)realloc(NeedData, cells * sizeof(int));
+    Max = (int **)realloc(Max, newCapacity * sizeof(int *));
+    Allocation = (int **)realloc(Allocation, newCapacity * sizeof(int *));
+    Need = (int **)realloc(Need, newCapacity * sizeof(int *));
+    Active = (bool *)realloc(Active, newCapacity * sizeof(bool));
+    freeSlots = (int *)realloc(freeSlots, newCapacity * sizeof(int));
+    cachedSafeSequence = (int *)realloc(cachedSafeSequence, newCapacity * sizeof(int));
+
+    if (MaxData == NULL || AllocationData == NULL || NeedData == NULL || Max == NULL ||
+        Allocation == NULL || Need == NULL || Active == NULL || freeSlots == NULL ||
+        cachedSafeSequence == NULL) {
+        printf("Error: Memory allocation failed!\n");
+        exit(1);
+    }
+
+    // New rows start zeroed and inactive
+    memset(MaxData + oldCells, 0, (cells - oldCells) * sizeof(int));
+    memset(AllocationData + oldCells, 0, (cells - oldCells) * sizeof(int));
+    memset(NeedData + oldCells, 0, (cells - oldCells) * sizeof(int));
+    for (int i = procCapacity; i < newCapacity; i++) {
+        Active[i] = false;
+    }
+
+    procCapacity = newCapacity;
+    rebuildRowPointers();
+}
+
+// Copies a matrix into a block with a wider row stride.
+static int *widenMatrix(int *data, int newStride) {
+    int *wider = (int *)calloc((size_t)procCapacity * newStride, sizeof(int));
+    if (wider == NULL) {
+        printf("Error: Memory allocation failed!\n");
+        exit(1);
+    }
+    for (int i = 0; i < procCapacity; i++) {
+        memcpy(wider + (size_t)i * newStride, data + (size_t)i * resCapacity, numResources * sizeof(int));
+    }
+    free(data);
+    return wider;
+}
+
+/**
+ * @brief Doubles the number of columns (the row stride). Every row moves,
+ * but this only happens after the column count has doubled.
+ */
+void growResources() {
+    int newCapacity = resCapacity * 2;
+
+    MaxData = widenMatrix(MaxData, newCapacity);
+    AllocationData = widenMatrix(AllocationData, newCapacity);
+    NeedData = widenMatrix(NeedData, newCapacity);
+    Available = (int *)realloc(Available, newCapacity * sizeof(int));
+    Total = (int *)realloc(Total, newCapacity * sizeof(int));
+    if (Available == NULL || Total == NULL) {
+        printf("Error: Memory allocation failed!\n");
+        exit(1);
+    }
+
+    resCapacity = newCapacity;
+    rebuildRowPointers();
 }
 
 /**
  * @brief Frees all dynamically allocated memory.
  */
 void freeMemory() {
-    // Free each row in the 2D arrays
-    for (int i = 0; i < numProcesses; i++) {
-        free(Max[i]);
-        free(Allocation[i]);
-        free(Need[i]);
-    }
+    // Free the contiguous blocks behind the matrices
+    free(MaxData);
+    free(AllocationData);
+    free(NeedData);
 
-    // Free the "array of pointers"
+    // Free the row pointers
     free(Max);
     free(Allocation);
     free(Need);
 
-    // Free the 1D array
+    // Free the 1D arrays
     free(Available);
+    free(Total);
+    free(Active);
+    free(freeSlots);
+    free(cachedSafeSequence);
 }
 
 /**
@@ -244,6 +479,7 @@ void getUserInput() {
 
     // Calculate Available
     for (int j = 0; j < numResources; j++) {
+        Total[j] = totalResources[j];
         Available[j] = totalResources[j] - totalAllocated[j];
     }
     
@@ -266,36 +502,200 @@ void calculateNeedMatrix() {
 }
 
 /**
- * @brief Implements the Safety Algorithm with VERBOSE LOGGING.
- * Checks if the system is in a safe state and prints a step-by-step log.
+ * @brief Implements the Safety Algorithm with VERBOSE LOGGING on the
+ * current (live) state.
  * @param safeSequence An array to be filled with the safe sequence if one is found.
  * @return true if the system is safe, false otherwise.
  */
 bool isSafe(int safeSequence[]) {
+    return isSafeWithRequest(-1, NULL, safeSequence);
+}
+
+// --- Delta overlay accessors ---
+// A hypothetical grant only changes one row of Allocation and Need (and
+// Available). Instead of writing it into the shared matrices, the safety
+// check reads every value through these helpers, which add the one-row
+// diff on the fly when p is the requesting process.
+static inline int overlayNeed(int p, int j, int processID, const int request[]) {
+    return (p == processID) ? Need[p][j] - request[j] : Need[p][j];
+}
+
+static inline int overlayAllocation(int p, int j, int processID, const int request[]) {
+    return (p == processID) ? Allocation[p][j] + request[j] : Allocation[p][j];
+}
+
+/* ================================================================== */
+/*             Fixed-size kernels (quiet safety checks only)          */
+/* ================================================================== */
+// With numResources only known at runtime, every "for j < numResources"
+// loop has a variable trip count. The kernels below take the resource
+// count as a CONSTANT, so each copy stamped out by FIXED_KERNELS(M) gets
+// fully unrolled / vectorized loops. They compute exactly what the
+// generic code computes (same scan order, same safe sequence) but skip
+// the logging, so they are only used when verboseLog is false.
+
+#ifdef __GNUC__
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define ALWAYS_INLINE inline
+#endif
+
+// isSafeWithRequest() for exactly m resource types.
+static ALWAYS_INLINE bool safetyKernel(const int m, int processID, const int request[],
+                                       int safeSequence[]) {
+    int Work[MAX_FIXED_RESOURCES];
+    int rowNeed[MAX_FIXED_RESOURCES];  // Overlaid Need/Allocation row
+    int rowAlloc[MAX_FIXED_RESOURCES]; // of the requesting process
+    for (int j = 0; j < m; j++) {
+        Work[j] = Available[j] - (processID >= 0 ? request[j] : 0);
+    }
+    // Without a request, row 0 is filled too; p == -1 never selects it
+    int row = processID >= 0 ? processID : 0;
+    for (int j = 0; j < m; j++) {
+        int delta = processID >= 0 ? request[j] : 0;
+        rowNeed[j] = Need[row][j] - delta;
+        rowAlloc[j] = Allocation[row][j] + delta;
+    }
+
+    bool Finish[numProcesses];
+    int completedCount = 0;
+    for (int i = 0; i < numProcesses; i++) {
+        Finish[i] = !Active[i];
+        if (Finish[i]) completedCount++;
+    }
+
+    int safeSeqIndex = 0;
+    while (completedCount < numProcesses) {
+        bool foundProcess = false;
+        for (int p = 0; p < numProcesses; p++) {
+            if (Finish[p]) continue;
+            const int *need = (p == processID) ? rowNeed : NeedData + (size_t)p * resCapacity;
+
+            // No early exit: a fixed trip count the compiler can vectorize
+            bool canRun = true;
+            for (int j = 0; j < m; j++) canRun &= need[j] <= Work[j];
+            if (!canRun) continue;
+
+            const int *alloc = (p == processID) ? rowAlloc : AllocationData + (size_t)p * resCapacity;
+            for (int j = 0; j < m; j++) Work[j] += alloc[j];
+            Finish[p] = true;
+            safeSequence[safeSeqIndex++] = p;
+            foundProcess = true;
+            completedCount++;
+        }
+        if (!foundProcess) return false;
+    }
+    return true;
+}
+
+// cachedSequenceHolds() for exactly m resource types (cache known valid).
+static ALWAYS_INLINE bool holdsKernel(const int m, int processID, const int request[]) {
+    int Work[MAX_FIXED_RESOURCES];
+    for (int j = 0; j < m; j++) {
+        Work[j] = Available[j] - request[j];
+    }
+    for (int k = 0; k < cachedSafeLength; k++) {
+        int p = cachedSafeSequence[k];
+        const int *need = NeedData + (size_t)p * resCapacity;
+        const int *alloc = AllocationData + (size_t)p * resCapacity;
+        bool canRun = true;
+        if (p == processID) {
+            for (int j = 0; j < m; j++) canRun &= need[j] - request[j] <= Work[j];
+            for (int j = 0; j < m; j++) Work[j] += alloc[j] + request[j];
+        } else {
+            for (int j = 0; j < m; j++) canRun &= need[j] <= Work[j];
+            for (int j = 0; j < m; j++) Work[j] += alloc[j];
+        }
+        if (!canRun) return false;
+    }
+    return true;
+}
+
+typedef bool (*SafetyKernel)(int processID, const int request[], int safeSequence[]);
+typedef bool (*HoldsKernel)(int processID, const int request[]);
+
+// Stamps out the two kernels for one constant resource count M.
+#define FIXED_KERNELS(M)                                                          \
+    static bool isSafeFixed##M(int processID, const int request[], int safeSequence[]) { \
+        return safetyKernel(M, processID, request, safeSequence);                 \
+    }                                                                             \
+    static bool holdsFixed##M(int processID, const int request[]) {               \
+        return holdsKernel(M, processID, request);                                \
+    }
+
+FIXED_KERNELS(1)  FIXED_KERNELS(2)  FIXED_KERNELS(3)  FIXED_KERNELS(4)
+FIXED_KERNELS(5)  FIXED_KERNELS(6)  FIXED_KERNELS(7)  FIXED_KERNELS(8)
+FIXED_KERNELS(9)  FIXED_KERNELS(10) FIXED_KERNELS(11) FIXED_KERNELS(12)
+FIXED_KERNELS(13) FIXED_KERNELS(14) FIXED_KERNELS(15) FIXED_KERNELS(16)
+FIXED_KERNELS(32) FIXED_KERNELS(64)
+
+#define KERNEL_ENTRY(M) [M] = { isSafeFixed##M, holdsFixed##M }
+
+// Dispatch table indexed by numResources; empty entries use the generic code.
+static const struct {
+    SafetyKernel isSafe;
+    HoldsKernel holds;
+} fixedKernels[MAX_FIXED_RESOURCES + 1] = {
+    KERNEL_ENTRY(1),  KERNEL_ENTRY(2),  KERNEL_ENTRY(3),  KERNEL_ENTRY(4),
+    KERNEL_ENTRY(5),  KERNEL_ENTRY(6),  KERNEL_ENTRY(7),  KERNEL_ENTRY(8),
+    KERNEL_ENTRY(9),  KERNEL_ENTRY(10), KERNEL_ENTRY(11), KERNEL_ENTRY(12),
+    KERNEL_ENTRY(13), KERNEL_ENTRY(14), KERNEL_ENTRY(15), KERNEL_ENTRY(16),
+    KERNEL_ENTRY(32), KERNEL_ENTRY(64),
+};
+
+// True when a fixed-size kernel may replace the generic loops right now.
+static inline bool fixedKernelAvailable() {
+    return !verboseLog && useFixedKernels && numResources <= MAX_FIXED_RESOURCES &&
+           fixedKernels[numResources].isSafe != NULL;
+}
+
+/**
+ * @brief Implements the Safety Algorithm with VERBOSE LOGGING on the
+ * state "live state + request granted to processID", without modifying
+ * the live state. All globals are only read, so a denial needs no undo
+ * and several hypothetical requests may be evaluated concurrently.
+ * Checks if the system is in a safe state and prints a step-by-step log.
+ * @param processID The process whose request is overlaid, or -1 for none.
+ * @param request   The overlaid request vector (ignored when processID is -1).
+ * @param safeSequence An array to be filled with the safe sequence if one is found.
+ * @return true if the system is safe, false otherwise.
+ */
+bool isSafeWithRequest(int processID, const int request[], int safeSequence[]) {
+    if (fixedKernelAvailable()) {
+        return fixedKernels[numResources].isSafe(processID, request, safeSequence);
+    }
+    if (!verboseLog) {
+        // Nothing to print: the same scan, as shared with oskbench
+        return oskBankerIsSafe(numProcesses, numResources, resCapacity, Available, AllocationData,
+                               NeedData, Active, processID, request, safeSequence);
+    }
+
     // --- Step 1: Initialize ---
 
-    // 'Work' vector, a temporary copy of 'Available'.
+    // 'Work' vector, a temporary copy of 'Available' (minus the request).
     int Work[numResources];
     for (int j = 0; j < numResources; j++) {
-        Work[j] = Available[j];
+        Work[j] = Available[j] - (processID >= 0 ? request[j] : 0);
     }
 
     // 'Finish' vector, a boolean array.
+    // Slots of processes that already finished count as done.
     bool Finish[numProcesses];
+    int completedCount = 0;
     for (int i = 0; i < numProcesses; i++) {
-        Finish[i] = false; // No process has finished yet.
+        Finish[i] = !Active[i];
+        if (Finish[i]) completedCount++;
     }
 
     int safeSeqIndex = 0; // Index for building the safeSequence array.
-    int completedCount = 0;
 
     // --- NEW: Header for the log ---
-    printf("\n--- Safety Check Log ---\n");
-    printf("Initial Available (Work): [ ");
+    LOG("\n--- Safety Check Log ---\n");
+    LOG("Initial Available (Work): [ ");
     for (int j = 0; j < numResources; j++) {
-        printf("%d ", Work[j]);
+        LOG("%d ", Work[j]);
     }
-    printf("]\n");
+    LOG("]\n");
 
     // --- Step 2: Find a process that can finish ---
     while (completedCount < numProcesses) {
@@ -310,7 +710,7 @@ bool isSafe(int safeSequence[]) {
                 // Check if Need[p] <= Work
                 bool canRun = true;
                 for (int j = 0; j < numResources; j++) {
-                    if (Need[p][j] > Work[j]) {
+                    if (overlayNeed(p, j, processID, request) > Work[j]) {
                         canRun = false; // Cannot meet the need
                         break;
                     }
@@ -319,33 +719,33 @@ bool isSafe(int safeSequence[]) {
                 // --- Step 3: "Run" the process ---
                 if (canRun) {
                     // *** START OF NEW PRINTING LOGIC ***
-                    printf("\n-> Process P%d can run:\n", p);
+                    LOG("\n-> Process P%d can run:\n", p);
                     
                     // Print current Need of this process
-                    printf("   Need:      [ ");
-                    for (int j = 0; j < numResources; j++) printf("%d ", Need[p][j]);
-                    printf("]\n");
+                    LOG("   Need:      [ ");
+                    for (int j = 0; j < numResources; j++) LOG("%d ", overlayNeed(p, j, processID, request));
+                    LOG("]\n");
 
                     // Print current Available (Work)
-                    printf("   Available: [ ");
-                    for (int j = 0; j < numResources; j++) printf("%d ", Work[j]);
-                    printf("]\n   (Need <= Available is TRUE)\n");
+                    LOG("   Available: [ ");
+                    for (int j = 0; j < numResources; j++) LOG("%d ", Work[j]);
+                    LOG("]\n   (Need <= Available is TRUE)\n");
                     
                     // Print what it's "releasing"
-                    printf("   Releasing: [ ");
-                    for (int j = 0; j < numResources; j++) printf("%d ", Allocation[p][j]);
-                    printf("]\n");
+                    LOG("   Releasing: [ ");
+                    for (int j = 0; j < numResources; j++) LOG("%d ", overlayAllocation(p, j, processID, request));
+                    LOG("]\n");
 
                     // Add its resources back to the 'Work' pool
                     for (int j = 0; j < numResources; j++) {
-                        Work[j] += Allocation[p][j];
+                        Work[j] += overlayAllocation(p, j, processID, request);
                     }
 
                     // Print the NEW Available (Work)
-                    printf("   New Available (Work): [ ");
-                    for (int j = 0; j < numResources; j++) printf("%d ", Work[j]);
-                    printf("]\n");
-                    printf("   ----------------------------\n");
+                    LOG("   New Available (Work): [ ");
+                    for (int j = 0; j < numResources; j++) LOG("%d ", Work[j]);
+                    LOG("]\n");
+                    LOG("   ----------------------------\n");
                     // *** END OF NEW PRINTING LOGIC ***
 
                     // Mark as finished
@@ -365,17 +765,17 @@ bool isSafe(int safeSequence[]) {
         if (foundProcess == false) {
             
             // --- NEW: Print failure details ---
-            printf("\n--- Safety Check FAILED ---\n");
-            printf("No remaining process can be satisfied with Available (Work): [ ");
-            for(int j=0; j<numResources; j++) printf("%d ", Work[j]);
-            printf("]\n");
+            LOG("\n--- Safety Check FAILED ---\n");
+            LOG("No remaining process can be satisfied with Available (Work): [ ");
+            for(int j=0; j<numResources; j++) LOG("%d ", Work[j]);
+            LOG("]\n");
             
-            printf("Remaining processes and their needs (the 'remaining need'):\n");
+            LOG("Remaining processes and their needs (the 'remaining need'):\n");
             for(int i=0; i<numProcesses; i++){
                 if(Finish[i] == false){
-                    printf("   P%d Need: [ ", i);
-                    for(int j=0; j<numResources; j++) printf("%d ", Need[i][j]);
-                    printf("]\n");
+                    LOG("   P%d Need: [ ", i);
+                    for(int j=0; j<numResources; j++) LOG("%d ", overlayNeed(i, j, processID, request));
+                    LOG("]\n");
                 }
             }
             // --- End new print ---
@@ -385,7 +785,7 @@ bool isSafe(int safeSequence[]) {
     }
 
     // --- NEW: Print success message ---
-    printf("\n--- Safety Check SUCCESSFUL --- \n");
+    LOG("\n--- Safety Check SUCCESSFUL --- \n");
     // All processes are finished. System is SAFE.
     return true;
 }
@@ -393,6 +793,9 @@ bool isSafe(int safeSequence[]) {
 /**
  * @brief Implements the Resource-Request Algorithm.
  * Checks if a request from a process can be safely granted.
+ * The safety check runs speculatively on a delta overlay (live state plus
+ * this one request), so the shared matrices are only written on commit
+ * and a denial leaves nothing to roll back.
  * @param processID The ID of the process making the request (e.g., 0 for P0).
  * @param request   A vector (VLA) with the requested instances.
  * @return true if the request was granted, false if it was denied/made to wait.
@@ -401,7 +804,7 @@ bool resourceRequest(int processID, int request[]) {
     // --- Step 1: Check if Request <= Need ---
     for (int j = 0; j < numResources; j++) {
         if (request[j] > Need[processID][j]) {
-            printf("DENIED: Process P%d request exceeds its 'Need' matrix value.\n", processID);
+            LOG("DENIED: Process P%d request exceeds its 'Need' matrix value.\n", processID);
             return false;
         }
     }
@@ -409,52 +812,210 @@ bool resourceRequest(int processID, int request[]) {
     // --- Step 2: Check if Request <= Available ---
     for (int j = 0; j < numResources; j++) {
         if (request[j] > Available[j]) {
-            printf("DENIED: Process P%d must wait. Resources not available.\n", processID);
+            LOG("DENIED: Process P%d must wait. Resources not available.\n", processID);
             return false;
         }
     }
 
-    // --- Step 3: "Pretend" to allocate the resources ---
-    // We will modify the *actual* state, but we save the old
-    // values in VLAs so we can roll back if the state is unsafe.
-    int oldAvailable[numResources];
-    int oldAllocation[numResources];
-    int oldNeed[numResources];
+    // --- Step 3: Run the Safety Algorithm on the hypothetical state ---
+    // The request is overlaid on the live state; nothing is modified yet.
+    // If the cached safe sequence still works with the request granted,
+    // the state is safe and the O(n^2 * m) search can be skipped.
+    if (cachedSequenceHolds(processID, request)) {
+        LOG("...cached safe sequence still holds, skipping full safety check...\n");
+    } else {
+        LOG("...running safety check on this hypothetical allocation...\n");
+        
+        // VLA for the temporary sequence
+        int tempSafeSequence[numProcesses]; 
+        
+        if (!isSafeWithRequest(processID, request, tempSafeSequence)) {
+            // The new state would be UNSAFE. Nothing was touched, nothing to undo.
+            LOG("DENIED: Granting request by P%d would lead to an UNSAFE state.\n", processID);
+            return false;
+        }
 
-    for (int j = 0; j < numResources; j++) {
-        // Save current state
-        oldAvailable[j] = Available[j];
-        oldAllocation[j] = Allocation[processID][j];
-        oldNeed[j] = Need[processID][j];
+        // Remember the new sequence for the next request
+        cachedSafeLength = 0;
+        for (int i = 0; i < numProcesses; i++) {
+            if (Active[i]) cachedSafeLength++;
+        }
+        memcpy(cachedSafeSequence, tempSafeSequence, cachedSafeLength * sizeof(int));
+        cacheValid = true;
+    }
 
-        // Apply the hypothetical allocation
+    // --- Step 4: Commit ---
+    // The new state is SAFE. Only now write it into the live state.
+    for (int j = 0; j < numResources; j++) {
         Available[j] -= request[j];
         Allocation[processID][j] += request[j];
         Need[processID][j] -= request[j];
     }
+    LOG("GRANTED: Request by P%d is safe. Resources allocated.\n", processID);
+    return true;
+}
 
-    // --- Step 4: Run the Safety Algorithm on the hypothetical state ---
-    printf("...running safety check on this hypothetical allocation...\n");
-    
-    // VLA for the temporary sequence
-    int tempSafeSequence[numProcesses]; 
-    
-    if (isSafe(tempSafeSequence)) {
-        // The new state is SAFE. Keep it.
-        printf("GRANTED: Request by P%d is safe. Resources allocated.\n", processID);
-        return true;
-    } else {
-        // The new state is UNSAFE. ROLL BACK.
-        printf("DENIED: Granting request by P%d would lead to an UNSAFE state. Rolling back.\n", processID);
+/**
+ * @brief Checks, in O(n * m), whether the cached safe sequence is still a
+ * valid completion order once 'request' is granted to processID.
+ * @return true if the cache proves the hypothetical state safe.
+ */
+bool cachedSequenceHolds(int processID, const int request[]) {
+    if (!cacheValid) {
+        return false;
+    }
+    if (fixedKernelAvailable()) {
+        return fixedKernels[numResources].holds(processID, request);
+    }
+
+    int Work[numResources];
+    for (int j = 0; j < numResources; j++) {
+        Work[j] = Available[j] - request[j];
+    }
 
-        // Roll back: Restore the saved state
+    for (int k = 0; k < cachedSafeLength; k++) {
+        int p = cachedSafeSequence[k];
         for (int j = 0; j < numResources; j++) {
-            Available[j] = oldAvailable[j];
-            Allocation[processID][j] = oldAllocation[j];
-            Need[processID][j] = oldNeed[j];
+            if (overlayNeed(p, j, processID, request) > Work[j]) {
+                return false;
+            }
+        }
+        for (int j = 0; j < numResources; j++) {
+            Work[j] += overlayAllocation(p, j, processID, request);
         }
-        return false;
     }
+    return true;
+}
+
+/**
+ * @brief Process P[processID] gives back part of its allocation.
+ * Max is unchanged, so its Need grows by the same amount.
+ *
+ * The cached safe sequence stays valid: every step before P[processID]
+ * sees more Work, and at P[processID]'s own step Work and Need grew by
+ * the same vector.
+ * @return true if the release was valid.
+ */
+bool releaseResources(int processID, int release[]) {
+    for (int j = 0; j < numResources; j++) {
+        if (release[j] < 0 || release[j] > Allocation[processID][j]) {
+            LOG("DENIED: Process P%d cannot release more than it holds.\n", processID);
+            return false;
+        }
+    }
+
+    for (int j = 0; j < numResources; j++) {
+        Available[j] += release[j];
+        Allocation[processID][j] -= release[j];
+        Need[processID][j] += release[j];
+    }
+    LOG("RELEASED: Resources returned by P%d.\n", processID);
+    return true;
+}
+
+/**
+ * @brief Process P[processID] terminates: all of its allocation returns
+ * to Available and its slot is freed for reuse.
+ *
+ * Dropping a process from a safe sequence leaves it safe (everyone after
+ * it only loses a process that would have given resources back, which
+ * were just given back now), so the cache is updated in O(n).
+ */
+void finishProcess(int processID) {
+    for (int j = 0; j < numResources; j++) {
+        Available[j] += Allocation[processID][j];
+        Allocation[processID][j] = 0;
+        Max[processID][j] = 0;
+        Need[processID][j] = 0;
+    }
+    Active[processID] = false;
+    freeSlots[numFreeSlots++] = processID;
+
+    if (cacheValid) {
+        int k = 0;
+        for (int i = 0; i < cachedSafeLength; i++) {
+            if (cachedSafeSequence[i] != processID) {
+                cachedSafeSequence[k++] = cachedSafeSequence[i];
+            }
+        }
+        cachedSafeLength = k;
+    }
+    LOG("FINISHED: P%d released everything and left the system.\n", processID);
+}
+
+/**
+ * @brief Admits a new process with the given Max vector and no allocation.
+ * A finished slot is reused when available; otherwise a new row is added
+ * (doubling the storage when it is full).
+ *
+ * At the end of any safe sequence Work equals Total, so appending the new
+ * process keeps the cache valid exactly when Max <= Total, which is also
+ * the admission condition.
+ * @return The new process ID, or -1 if Max exceeds the system totals.
+ */
+int admitProcess(int max[]) {
+    for (int j = 0; j < numResources; j++) {
+        if (max[j] < 0 || max[j] > Total[j]) {
+            LOG("DENIED: Max exceeds the total instances of R%d.\n", j);
+            return -1;
+        }
+    }
+
+    int pid;
+    if (numFreeSlots > 0) {
+        pid = freeSlots[--numFreeSlots];
+    } else {
+        if (numProcesses == procCapacity) {
+            growProcesses();
+        }
+        pid = numProcesses++;
+    }
+
+    for (int j = 0; j < numResources; j++) {
+        Max[pid][j] = max[j];
+        Allocation[pid][j] = 0;
+        Need[pid][j] = max[j];
+    }
+    Active[pid] = true;
+
+    if (cacheValid) {
+        cachedSafeSequence[cachedSafeLength++] = pid;
+    }
+    LOG("ADMITTED: New process P%d.\n", pid);
+    return pid;
+}
+
+/**
+ * @brief Adds a new resource type with 'total' instances, none allocated.
+ * maxColumn[i] is the Max of the new resource for process P[i].
+ *
+ * Work for the new column is 'total' at every step of the cached safe
+ * sequence, so the cache stays valid since every Max <= total.
+ * @return true if the resource type was added.
+ */
+bool addResourceType(int total, int maxColumn[]) {
+    for (int i = 0; i < numProcesses; i++) {
+        if (Active[i] && (maxColumn[i] < 0 || maxColumn[i] > total)) {
+            LOG("DENIED: Max of P%d exceeds the total instances.\n", i);
+            return false;
+        }
+    }
+
+    if (numResources == resCapacity) {
+        growResources();
+    }
+
+    int r = numResources++;
+    Total[r] = total;
+    Available[r] = total;
+    for (int i = 0; i < numProcesses; i++) {
+        int max = Active[i] ? maxColumn[i] : 0;
+        Max[i][r] = max;
+        Allocation[i][r] = 0;
+        Need[i][r] = max;
+    }
+    LOG("ADDED: Resource type R%d with %d instances.\n", r, total);
+    return true;
 }
 
 /**
@@ -482,6 +1043,7 @@ void printState() {
 
     // Print matrix contents
     for (int i = 0; i < numProcesses; i++) {
+        if (!Active[i]) continue; // Finished, slot is free
         printf("P%-*d", 2, i); // "P0  "
         
         // Allocation
@@ -509,4 +1071,423 @@ void printState() {
         printf("%d ", Available[j]);
     }
     printf("]\n");
-}
\ No newline at end of file
+}
+
+/* ================================================================== */
+/*                 Trace replay, generation and benchmark             */
+/* ================================================================== */
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Sets up a fresh system with the given totals and Max matrix and
+ * nothing allocated yet (Available = Total, Need = Max).
+ * @param max Row-major n x m matrix.
+ */
+static void initSystem(int n, int m, const int total[], const int max[]) {
+    numProcesses = n;
+    numResources = m;
+    allocateMemory();
+
+    for (int j = 0; j < m; j++) {
+        Total[j] = total[j];
+        Available[j] = total[j];
+    }
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            Max[i][j] = max[(size_t)i * m + j];
+            Allocation[i][j] = 0;
+        }
+    }
+    calculateNeedMatrix();
+
+    // Nothing is allocated, so any order is safe when Max <= Total
+    int safeSequence[n];
+    cacheValid = isSafe(safeSequence);
+    if (cacheValid) {
+        memcpy(cachedSafeSequence, safeSequence, n * sizeof(int));
+        cachedSafeLength = n;
+    }
+}
+
+// Reads one int, skipping '#' comment lines. Returns false at EOF.
+static bool readInt(FILE *in, int *value) {
+    int c;
+    while ((c = fgetc(in)) != EOF) {
+        if (c == '#') {
+            while ((c = fgetc(in)) != EOF && c != '\n');
+        } else if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            ungetc(c, in);
+            return fscanf(in, "%d", value) == 1;
+        }
+    }
+    return false;
+}
+
+// Reads the event letter, skipping blanks and comments. Returns EOF at end.
+static int readEvent(FILE *in) {
+    int c;
+    while ((c = fgetc(in)) != EOF) {
+        if (c == '#') {
+            while ((c = fgetc(in)) != EOF && c != '\n');
+        } else if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            return c;
+        }
+    }
+    return EOF;
+}
+
+/**
+ * @brief Replays a recorded trace against the banker and reports how many
+ * requests were granted or denied and the achieved throughput.
+ * @return 0 on success, 1 on a malformed trace.
+ */
+int replayTrace(const char *path) {
+    perfPhase("input");
+    FILE *in = fopen(path, "r");
+    if (in == NULL) {
+        perror("fopen trace failed");
+        return 1;
+    }
+
+    int n, m;
+    if (!readInt(in, &n) || !readInt(in, &m) || n <= 0 || m <= 0) {
+        printf("Error: bad trace header.\n");
+        fclose(in);
+        return 1;
+    }
+
+    int *total = (int *)malloc(m * sizeof(int));
+    int *max = (int *)malloc((size_t)n * m * sizeof(int));
+    if (total == NULL || max == NULL) {
+        printf("Error: Memory allocation failed!\n");
+        exit(1);
+    }
+    bool ok = true;
+    for (int j = 0; j < m && ok; j++) ok = readInt(in, &total[j]);
+    for (int k = 0; k < n * m && ok; k++) ok = readInt(in, &max[k]);
+    if (!ok) {
+        printf("Error: truncated trace header.\n");
+        free(total);
+        free(max);
+        fclose(in);
+        return 1;
+    }
+
+    initSystem(n, m, total, max);
+    free(total);
+    free(max);
+
+    long requests = 0, granted = 0, releases = 0, finishes = 0, admits = 0;
+    int vector[numResources + 1];
+    perfPhase("replay"); // Parsing events + safety checks
+    double start = nowSeconds();
+
+    int event;
+    while ((event = readEvent(in)) != EOF) {
+        int pid = -1;
+        if (event == 'R' || event == 'L' || event == 'F') ok = readInt(in, &pid);
+        if (ok && (event == 'R' || event == 'L' || event == 'A')) {
+            for (int j = 0; j < numResources && ok; j++) ok = readInt(in, &vector[j]);
+        }
+        if (!ok) {
+            printf("Error: %s '%c' event in trace.\n", feof(in) ? "truncated" : "malformed", event);
+            break;
+        }
+
+        bool validPid = pid >= 0 && pid < numProcesses && Active[pid];
+        switch (event) {
+        case 'R':
+            requests++;
+            if (validPid && resourceRequest(pid, vector)) granted++;
+            break;
+        case 'L':
+            if (validPid && releaseResources(pid, vector)) releases++;
+            break;
+        case 'F':
+            if (validPid) {
+                finishProcess(pid);
+                finishes++;
+            }
+            break;
+        case 'A':
+            if (admitProcess(vector) >= 0) admits++;
+            break;
+        default:
+            printf("Error: unknown event '%c' in trace.\n", event);
+            ok = false;
+        }
+        if (!ok) break;
+    }
+
+    double elapsed = nowSeconds() - start;
+    fclose(in);
+
+    perfPhase("output");
+    printf("--- Replay of %s ---\n", path);
+    printf("Requests:   %ld (granted %ld, denied %ld)\n", requests, granted, requests - granted);
+    printf("Releases:   %ld\n", releases);
+    printf("Finishes:   %ld\n", finishes);
+    printf("Admissions: %ld\n", admits);
+    printf("Elapsed:    %.6f s\n", elapsed);
+    printf("Throughput: %.0f requests/s\n", requests / (elapsed > 0 ? elapsed : 1e-9));
+
+    freeMemory();
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Records a synthetic workload as a trace on stdout.
+ *
+ * The events are produced by running the banker itself, so requests and
+ * releases always refer to what a process really needs or holds.
+ * 'contention' in [0, 1] shrinks the totals from "everyone's Max at once"
+ * (0) down to "the single largest Max" (1), which makes waits and unsafe
+ * denials more frequent.
+ */
+int generateTrace(int n, int m, double contention, long events, unsigned int seed) {
+    if (n <= 0 || m <= 0 || events < 0 || contention < 0 || contention > 1) {
+        printf("Error: need n > 0, m > 0, events >= 0 and 0 <= contention <= 1.\n");
+        return 1;
+    }
+
+    int *max = (int *)malloc((size_t)n * m * sizeof(int));
+    int *total = (int *)malloc(m * sizeof(int));
+    if (max == NULL || total == NULL) {
+        printf("Error: Memory allocation failed!\n");
+        exit(1);
+    }
+
+    unsigned int initialSeed = seed;
+    for (int j = 0; j < m; j++) {
+        long sum = 0;
+        int largest = 0;
+        for (int i = 0; i < n; i++) {
+            int v = rand_r(&seed) % 10;
+            max[(size_t)i * m + j] = v;
+            sum += v;
+            if (v > largest) largest = v;
+        }
+        total[j] = largest + (int)((1.0 - contention) * (sum - largest));
+    }
+
+    printf("# Banker trace: n=%d m=%d contention=%.2f events=%ld seed=%u\n", n, m, contention, events, initialSeed);
+    printf("%d %d\n", n, m);
+    for (int j = 0; j < m; j++) printf("%d ", total[j]);
+    printf("\n");
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) printf("%d ", max[(size_t)i * m + j]);
+        printf("\n");
+    }
+
+    initSystem(n, m, total, max);
+
+    int vector[m];
+    for (long e = 0; e < events; e++) {
+        int pid = rand_r(&seed) % numProcesses;
+        if (!Active[pid]) {
+            // Slot is free: bring in a new process instead
+            for (int j = 0; j < m; j++) vector[j] = rand_r(&seed) % (Total[j] + 1 < 10 ? Total[j] + 1 : 10);
+            printf("A");
+            for (int j = 0; j < m; j++) printf(" %d", vector[j]);
+            printf("\n");
+            admitProcess(vector);
+            continue;
+        }
+
+        bool satisfied = true;
+        bool holds = false;
+        for (int j = 0; j < m; j++) {
+            if (Need[pid][j] > 0) satisfied = false;
+            if (Allocation[pid][j] > 0) holds = true;
+        }
+
+        if (satisfied) {
+            printf("F %d\n", pid);
+            finishProcess(pid);
+        } else if (holds && rand_r(&seed) % 4 == 0) {
+            for (int j = 0; j < m; j++) vector[j] = rand_r(&seed) % (Allocation[pid][j] + 1);
+            printf("L %d", pid);
+            for (int j = 0; j < m; j++) printf(" %d", vector[j]);
+            printf("\n");
+            releaseResources(pid, vector);
+        } else {
+            for (int j = 0; j < m; j++) vector[j] = rand_r(&seed) % (Need[pid][j] + 1);
+            printf("R %d", pid);
+            for (int j = 0; j < m; j++) printf(" %d", vector[j]);
+            printf("\n");
+            resourceRequest(pid, vector);
+        }
+    }
+
+    freeMemory();
+    free(max);
+    free(total);
+    return 0;
+}
+
+static int compareDouble(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Benchmarks the safety engine at several sizes:
+ *  - isSafe() latency (mean / p50 / p99) on a loaded but safe state,
+ *    which is the full O(n^2 * m) search;
+ *  - end-to-end resourceRequest() throughput on a generated workload,
+ *    which includes the cached-sequence fast path.
+ */
+int runBenchmark() {
+    int sizes[][2] = { {10, 3}, {100, 5}, {500, 8}, {1000, 10}, {2000, 16} };
+    int numSizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    printf("%-6s %-4s %12s %12s %12s %14s %10s\n",
+           "n", "m", "mean(us)", "p50(us)", "p99(us)", "requests/s", "granted%");
+
+    for (int s = 0; s < numSizes; s++) {
+        int n = sizes[s][0];
+        int m = sizes[s][1];
+        unsigned int seed = 7;
+
+        int *max = (int *)malloc((size_t)n * m * sizeof(int));
+        int *total = (int *)malloc(m * sizeof(int));
+        if (max == NULL || total == NULL) {
+            printf("Error: Memory allocation failed!\n");
+            exit(1);
+        }
+        for (int j = 0; j < m; j++) total[j] = 0;
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < m; j++) {
+                max[(size_t)i * m + j] = rand_r(&seed) % 10;
+                total[j] += max[(size_t)i * m + j];
+            }
+        }
+        for (int j = 0; j < m; j++) total[j] = total[j] / 2 + 10;
+
+        initSystem(n, m, total, max);
+
+        // --- Load the system: grant random requests until ~half is allocated ---
+        int vector[m];
+        for (int k = 0; k < 4 * n; k++) {
+            int pid = rand_r(&seed) % n;
+            for (int j = 0; j < m; j++) vector[j] = rand_r(&seed) % (Need[pid][j] / 2 + 1);
+            resourceRequest(pid, vector);
+        }
+
+        // --- isSafe() latency ---
+        int checks = n <= 100 ? 2000 : (n <= 1000 ? 100 : 20);
+        double *samples = (double *)malloc(checks * sizeof(double));
+        int safeSequence[n];
+        double sum = 0;
+        for (int k = 0; k < checks; k++) {
+            double t0 = nowSeconds();
+            isSafe(safeSequence);
+            samples[k] = (nowSeconds() - t0) * 1e6;
+            sum += samples[k];
+        }
+        qsort(samples, checks, sizeof(double), compareDouble);
+
+        // --- Request throughput ---
+        long requests = n <= 100 ? 200000 : 20000;
+        long granted = 0;
+        double t0 = nowSeconds();
+        for (long k = 0; k < requests; k++) {
+            int pid = rand_r(&seed) % n;
+            bool holds = false;
+            for (int j = 0; j < m; j++) if (Allocation[pid][j] > 0) holds = true;
+
+            if (holds && rand_r(&seed) % 2 == 0) {
+                // Keep the system from filling up
+                for (int j = 0; j < m; j++) vector[j] = rand_r(&seed) % (Allocation[pid][j] + 1);
+                releaseResources(pid, vector);
+                k--;
+                continue;
+            }
+            for (int j = 0; j < m; j++) vector[j] = rand_r(&seed) % (Need[pid][j] + 1);
+            if (resourceRequest(pid, vector)) granted++;
+        }
+        double elapsed = nowSeconds() - t0;
+
+        printf("%-6d %-4d %12.2f %12.2f %12.2f %14.0f %9.1f%%\n",
+               n, m, sum / checks, samples[checks / 2], samples[(int)(checks * 0.99)],
+               requests / (elapsed > 0 ? elapsed : 1e-9), 100.0 * granted / requests);
+
+        free(samples);
+        freeMemory();
+        free(max);
+        free(total);
+    }
+    return runKernelBenchmark();
+}
+
+/**
+ * @brief Times isSafe() with the generic loops against the fixed-size
+ * kernel for the same loaded state, and checks both find the same safe
+ * sequence. m = 20 has no kernel, so both columns use the generic code.
+ */
+static int runKernelBenchmark() {
+    int counts[] = { 1, 3, 4, 8, 16, 20, 32, 64 };
+    int numCounts = sizeof(counts) / sizeof(counts[0]);
+    int n = 500;
+
+    printf("\n--- Fixed-size kernels (n = %d, isSafe() mean) ---\n", n);
+    printf("%-4s %14s %14s %9s %8s\n", "m", "generic(us)", "fixed(us)", "speedup", "same");
+
+    for (int c = 0; c < numCounts; c++) {
+        int m = counts[c];
+        unsigned int seed = 11;
+        int *max = (int *)malloc((size_t)n * m * sizeof(int));
+        int *total = (int *)malloc(m * sizeof(int));
+        if (max == NULL || total == NULL) {
+            printf("Error: Memory allocation failed!\n");
+            exit(1);
+        }
+        for (int j = 0; j < m; j++) total[j] = 0;
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < m; j++) {
+                max[(size_t)i * m + j] = rand_r(&seed) % 10;
+                total[j] += max[(size_t)i * m + j];
+            }
+        }
+        for (int j = 0; j < m; j++) total[j] = total[j] / 2 + 10;
+        initSystem(n, m, total, max);
+
+        int vector[m];
+        for (int k = 0; k < 4 * n; k++) {
+            int pid = rand_r(&seed) % n;
+            for (int j = 0; j < m; j++) vector[j] = rand_r(&seed) % (Need[pid][j] / 2 + 1);
+            resourceRequest(pid, vector);
+        }
+
+        // Same state, both paths; alternate so neither gets a warmer cache
+        int sequence[2][n];
+        bool result[2];
+        double spent[2] = { 0, 0 };
+        int checks = 200;
+        for (int k = 0; k < checks; k++) {
+            for (int fixed = 0; fixed < 2; fixed++) {
+                useFixedKernels = fixed;
+                double t0 = nowSeconds();
+                result[fixed] = isSafe(sequence[fixed]);
+                spent[fixed] += nowSeconds() - t0;
+            }
+        }
+        useFixedKernels = true;
+        bool same = result[0] == result[1] &&
+                    (!result[0] || memcmp(sequence[0], sequence[1], n * sizeof(int)) == 0);
+
+        printf("%-4d %14.2f %14.2f %8.2fx %8s\n", m, spent[0] / checks * 1e6,
+               spent[1] / checks * 1e6, spent[0] / spent[1], same ? "yes" : "NO");
+
+        freeMemory();
+        free(max);
+        free(total);
+    }
+    return 0;
+}
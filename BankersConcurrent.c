@@ -0,0 +1,622 @@
+/**
+ * Concurrent Banker's Algorithm Service in C
+ *
+ * Bankers.c mutates its global Available / Allocation / Need in place and
+ * can only serve one caller. This program turns the same algorithm into a
+ * thread-safe resource manager that many worker threads call at once:
+ *
+ *  - The live state is published under a sequence counter (a seqlock).
+ *    A caller copies a consistent SNAPSHOT into its own buffers without
+ *    taking any lock, and runs the expensive safety check on that copy.
+ *  - COMMIT takes a short mutex and revalidates against the latest
+ *    version. If nothing changed, or only releases happened (which can
+ *    never turn a safe state unsafe), the grant is applied in O(m).
+ *    Otherwise the caller retries optimistically a few times and finally
+ *    falls back to checking under the lock so it cannot starve.
+ *  - RELEASE / RETURN give resources back with an O(m) critical section.
+ *
+ * The O(n^2 * m) safety check runs outside every lock, so admission
+ * throughput scales with the number of cores.
+ *
+ * Compile: gcc -O2 -pthread BankersConcurrent.c -o BankersConcurrent
+ */
+
+#include <stdio.h>
+#include <stdlib.h>    // For malloc, free, rand_r and exit
+#include <stdbool.h>   // For bool, true, and false
+#include <string.h>    // For memcpy
+#include <stdatomic.h> // For the sequence counter and statistics
+#include <pthread.h>   // For threads and the commit mutex
+#include <time.h>      // For clock_gettime
+
+// How many optimistic attempts before checking under the lock
+#define MAX_OPTIMISTIC_RETRIES 3
+
+// Result of a request
+enum RequestResult {
+    REQUEST_GRANTED,
+    REQUEST_EXCEEDS_NEED, // Request > Need: a programming error in the caller
+    REQUEST_MUST_WAIT,    // Request > Available
+    REQUEST_UNSAFE        // Granting would leave the system unsafe
+};
+
+/**
+ * The shared state. Matrices are stored row-major in one contiguous block
+ * so a snapshot is just three memcpy-sized loops.
+ */
+struct Banker {
+    int numProcesses;
+    int numResources;
+
+    int *Available;  // [m]
+    int *Max;        // [n * m], never changes after creation
+    int *Allocation; // [n * m]
+    int *Need;       // [n * m]
+
+    // Even = stable, odd = a commit is writing. Bumped on every change.
+    atomic_ulong seq;
+    // Bumped only by grants. Releases never make a safe state unsafe, so a
+    // check stays valid as long as this has not moved.
+    atomic_ulong grantEpoch;
+
+    pthread_mutex_t commitLock; // Serializes writers only
+
+    // Statistics
+    atomic_long granted;
+    atomic_long denied;
+    atomic_long released;
+    atomic_long retries;
+    atomic_long fallbacks;
+};
+
+/**
+ * Per-thread scratch space: the private snapshot and the safety-check
+ * work arrays, allocated once per worker.
+ */
+struct Snapshot {
+    unsigned long seq;
+    unsigned long grantEpoch;
+    int *Available;
+    int *Allocation;
+    int *Need;
+    int *Work;
+    bool *Finish;
+};
+
+// --- Function Prototypes ---
+struct Banker *bankerCreate(int n, int m, const int total[], const int max[]);
+void bankerDestroy(struct Banker *b);
+void snapshotInit(struct Snapshot *s, const struct Banker *b);
+void snapshotFree(struct Snapshot *s);
+void takeSnapshot(struct Banker *b, struct Snapshot *s);
+bool isSafeSnapshot(const struct Banker *b, struct Snapshot *s, int pid, const int request[]);
+enum RequestResult bankerRequest(struct Banker *b, struct Snapshot *s, int pid, const int request[]);
+bool bankerRelease(struct Banker *b, int pid, const int release[]);
+void bankerReturnAll(struct Banker *b, int pid);
+bool bankerCheckInvariants(struct Banker *b, const int total[]);
+
+/* ================================================================== */
+/*                      Seqlock helpers                               */
+/* ================================================================== */
+
+// Element-wise relaxed copies: readers may race with a writer, and the
+// sequence counter tells them afterwards whether the copy is usable.
+static void loadRow(int *dst, const int *src, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+    }
+}
+
+static void storeAdd(int *dst, int delta) {
+    __atomic_store_n(dst, __atomic_load_n(dst, __ATOMIC_RELAXED) + delta, __ATOMIC_RELAXED);
+}
+
+// Must be called with commitLock held
+static void beginWrite(struct Banker *b) {
+    atomic_store_explicit(&b->seq, atomic_load_explicit(&b->seq, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static void endWrite(struct Banker *b) {
+    atomic_store_explicit(&b->seq, atomic_load_explicit(&b->seq, memory_order_relaxed) + 1,
+                          memory_order_release);
+}
+
+/* ================================================================== */
+/*                      Construction                                  */
+/* ================================================================== */
+
+/**
+ * @brief Creates a banker with the given totals and Max matrix. Nothing
+ * is allocated yet, so Available = total and Need = Max.
+ */
+struct Banker *bankerCreate(int n, int m, const int total[], const int max[]) {
+    struct Banker *b = (struct Banker *)malloc(sizeof(struct Banker));
+    if (b == NULL) {
+        printf("Error: Memory allocation failed!\n");
+        exit(1);
+    }
+
+    b->numProcesses = n;
+    b->numResources = m;
+    b->Available = (int *)malloc(m * sizeof(int));
+    b->Max = (int *)malloc((size_t)n * m * sizeof(int));
+    b->Allocation = (int *)calloc((size_t)n * m, sizeof(int));
+    b->Need = (int *)malloc((size_t)n * m * sizeof(int));
+    if (b->Available == NULL || b->Max == NULL || b->Allocation == NULL || b->Need == NULL) {
+        printf("Error: Memory allocation failed!\n");
+        exit(1);
+    }
+
+    memcpy(b->Available, total, m * sizeof(int));
+    memcpy(b->Max, max, (size_t)n * m * sizeof(int));
+    memcpy(b->Need, max, (size_t)n * m * sizeof(int));
+
+    atomic_init(&b->seq, 0);
+    atomic_init(&b->grantEpoch, 0);
+    pthread_mutex_init(&b->commitLock, NULL);
+
+    atomic_init(&b->granted, 0);
+    atomic_init(&b->denied, 0);
+    atomic_init(&b->released, 0);
+    atomic_init(&b->retries, 0);
+    atomic_init(&b->fallbacks, 0);
+    return b;
+}
+
+/**
+ * @brief Frees the banker and all its matrices.
+ */
+void bankerDestroy(struct Banker *b) {
+    pthread_mutex_destroy(&b->commitLock);
+    free(b->Available);
+    free(b->Max);
+    free(b->Allocation);
+    free(b->Need);
+    free(b);
+}
+
+/**
+ * @brief Allocates one worker's private snapshot buffers.
+ */
+void snapshotInit(struct Snapshot *s, const struct Banker *b) {
+    int n = b->numProcesses;
+    int m = b->numResources;
+
+    s->Available = (int *)malloc(m * sizeof(int));
+    s->Allocation = (int *)malloc((size_t)n * m * sizeof(int));
+    s->Need = (int *)malloc((size_t)n * m * sizeof(int));
+    s->Work = (int *)malloc(m * sizeof(int));
+    s->Finish = (bool *)malloc(n * sizeof(bool));
+    if (s->Available == NULL || s->Allocation == NULL || s->Need == NULL ||
+        s->Work == NULL || s->Finish == NULL) {
+        printf("Error: Memory allocation failed!\n");
+        exit(1);
+    }
+}
+
+/**
+ * @brief Frees one worker's snapshot buffers.
+ */
+void snapshotFree(struct Snapshot *s) {
+    free(s->Available);
+    free(s->Allocation);
+    free(s->Need);
+    free(s->Work);
+    free(s->Finish);
+}
+
+/* ================================================================== */
+/*                      Snapshot + safety check                       */
+/* ================================================================== */
+
+/**
+ * @brief Copies a consistent version of the live state into 's' without
+ * taking any lock. Retries while a commit is in progress or one finished
+ * during the copy.
+ */
+void takeSnapshot(struct Banker *b, struct Snapshot *s) {
+    int n = b->numProcesses;
+    int m = b->numResources;
+
+    while (true) {
+        unsigned long before = atomic_load_explicit(&b->seq, memory_order_acquire);
+        if (before & 1) {
+            continue; // A writer is mid-commit
+        }
+        unsigned long epoch = atomic_load_explicit(&b->grantEpoch, memory_order_relaxed);
+
+        loadRow(s->Available, b->Available, m);
+        loadRow(s->Allocation, b->Allocation, n * m);
+        loadRow(s->Need, b->Need, n * m);
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&b->seq, memory_order_relaxed) == before) {
+            s->seq = before;
+            s->grantEpoch = epoch;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief The Safety Algorithm on a private snapshot, as if 'request' had
+ * already been granted to 'pid' (pass pid = -1 to check the snapshot as is).
+ * The hypothetical grant is applied to Work and to P[pid]'s row on the
+ * fly, so the snapshot itself is never modified.
+ */
+bool isSafeSnapshot(const struct Banker *b, struct Snapshot *s, int pid, const int request[]) {
+    int n = b->numProcesses;
+    int m = b->numResources;
+    int *Work = s->Work;
+    bool *Finish = s->Finish;
+
+    for (int j = 0; j < m; j++) {
+        Work[j] = s->Available[j] - (pid >= 0 ? request[j] : 0);
+    }
+    for (int i = 0; i < n; i++) {
+        Finish[i] = false;
+    }
+
+    int completedCount = 0;
+    while (completedCount < n) {
+        bool foundProcess = false;
+
+        for (int p = 0; p < n; p++) {
+            if (Finish[p]) continue;
+
+            const int *need = &s->Need[(size_t)p * m];
+            const int *alloc = &s->Allocation[(size_t)p * m];
+            const int *delta = (p == pid) ? request : NULL;
+
+            bool canRun = true;
+            for (int j = 0; j < m; j++) {
+                if (need[j] - (delta ? delta[j] : 0) > Work[j]) {
+                    canRun = false;
+                    break;
+                }
+            }
+
+            if (canRun) {
+                for (int j = 0; j < m; j++) {
+                    Work[j] += alloc[j] + (delta ? delta[j] : 0);
+                }
+                Finish[p] = true;
+                foundProcess = true;
+                completedCount++;
+            }
+        }
+
+        if (!foundProcess) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ================================================================== */
+/*                      Request / Release API                         */
+/* ================================================================== */
+
+// Apply a grant to the live state. Caller holds commitLock.
+static void applyGrant(struct Banker *b, int pid, const int request[]) {
+    int m = b->numResources;
+    int *alloc = &b->Allocation[(size_t)pid * m];
+    int *need = &b->Need[(size_t)pid * m];
+
+    beginWrite(b);
+    for (int j = 0; j < m; j++) {
+        storeAdd(&b->Available[j], -request[j]);
+        storeAdd(&alloc[j], request[j]);
+        storeAdd(&need[j], -request[j]);
+    }
+    atomic_fetch_add_explicit(&b->grantEpoch, 1, memory_order_relaxed);
+    endWrite(b);
+}
+
+// O(m) admission checks against the live state. Caller holds commitLock.
+static enum RequestResult checkBounds(struct Banker *b, int pid, const int request[]) {
+    int m = b->numResources;
+    const int *need = &b->Need[(size_t)pid * m];
+
+    for (int j = 0; j < m; j++) {
+        if (request[j] > need[j]) return REQUEST_EXCEEDS_NEED;
+    }
+    for (int j = 0; j < m; j++) {
+        if (request[j] > b->Available[j]) return REQUEST_MUST_WAIT;
+    }
+    return REQUEST_GRANTED;
+}
+
+/**
+ * @brief Thread-safe Resource-Request Algorithm.
+ *
+ * 1. Snapshot the state lock-free and run the safety check on the copy.
+ * 2. Lock, and revalidate: if no grant has been committed since the
+ *    snapshot, the check still holds (releases only help), so apply.
+ * 3. Otherwise retry; after MAX_OPTIMISTIC_RETRIES, decide under the lock.
+ *
+ * @param s The calling thread's private snapshot buffers.
+ */
+enum RequestResult bankerRequest(struct Banker *b, struct Snapshot *s, int pid, const int request[]) {
+    int m = b->numResources;
+
+    for (int attempt = 0; attempt < MAX_OPTIMISTIC_RETRIES; attempt++) {
+        // --- Step 1: Optimistic check on a private snapshot ---
+        takeSnapshot(b, s);
+
+        for (int j = 0; j < m; j++) {
+            if (request[j] > s->Need[(size_t)pid * m + j]) {
+                atomic_fetch_add(&b->denied, 1);
+                return REQUEST_EXCEEDS_NEED;
+            }
+        }
+        for (int j = 0; j < m; j++) {
+            if (request[j] > s->Available[j]) {
+                atomic_fetch_add(&b->denied, 1);
+                return REQUEST_MUST_WAIT;
+            }
+        }
+        bool safe = isSafeSnapshot(b, s, pid, request);
+
+        // --- Step 2: Commit, revalidating against the latest version ---
+        pthread_mutex_lock(&b->commitLock);
+        unsigned long epoch = atomic_load_explicit(&b->grantEpoch, memory_order_relaxed);
+        unsigned long seq = atomic_load_explicit(&b->seq, memory_order_relaxed);
+
+        if (seq == s->seq && !safe) {
+            // Nothing changed: the UNSAFE verdict is exact
+            pthread_mutex_unlock(&b->commitLock);
+            atomic_fetch_add(&b->denied, 1);
+            return REQUEST_UNSAFE;
+        }
+        if (epoch == s->grantEpoch && safe) {
+            // Only releases (or nothing) since the snapshot: still safe,
+            // but the bounds must hold against the live row.
+            enum RequestResult r = checkBounds(b, pid, request);
+            if (r == REQUEST_GRANTED) {
+                applyGrant(b, pid, request);
+                pthread_mutex_unlock(&b->commitLock);
+                atomic_fetch_add(&b->granted, 1);
+                return REQUEST_GRANTED;
+            }
+            pthread_mutex_unlock(&b->commitLock);
+            atomic_fetch_add(&b->denied, 1);
+            return r;
+        }
+        pthread_mutex_unlock(&b->commitLock);
+
+        // --- Step 3: Someone else committed a grant first. Try again. ---
+        atomic_fetch_add(&b->retries, 1);
+    }
+
+    // --- Fallback: decide under the lock so heavy contention cannot starve us ---
+    atomic_fetch_add(&b->fallbacks, 1);
+    pthread_mutex_lock(&b->commitLock);
+    enum RequestResult r = checkBounds(b, pid, request);
+    if (r == REQUEST_GRANTED) {
+        // We are the only writer, so the snapshot cannot be torn
+        takeSnapshot(b, s);
+        if (isSafeSnapshot(b, s, pid, request)) {
+            applyGrant(b, pid, request);
+        } else {
+            r = REQUEST_UNSAFE;
+        }
+    }
+    pthread_mutex_unlock(&b->commitLock);
+
+    if (r == REQUEST_GRANTED) atomic_fetch_add(&b->granted, 1);
+    else atomic_fetch_add(&b->denied, 1);
+    return r;
+}
+
+/**
+ * @brief Process 'pid' gives back part of its allocation.
+ * @return false if it tried to release more than it holds.
+ */
+bool bankerRelease(struct Banker *b, int pid, const int release[]) {
+    int m = b->numResources;
+    int *alloc = &b->Allocation[(size_t)pid * m];
+    int *need = &b->Need[(size_t)pid * m];
+
+    pthread_mutex_lock(&b->commitLock);
+    for (int j = 0; j < m; j++) {
+        if (release[j] < 0 || release[j] > alloc[j]) {
+            pthread_mutex_unlock(&b->commitLock);
+            return false;
+        }
+    }
+
+    beginWrite(b);
+    for (int j = 0; j < m; j++) {
+        storeAdd(&b->Available[j], release[j]);
+        storeAdd(&alloc[j], -release[j]);
+        storeAdd(&need[j], release[j]);
+    }
+    endWrite(b);
+    pthread_mutex_unlock(&b->commitLock);
+
+    atomic_fetch_add(&b->released, 1);
+    return true;
+}
+
+/**
+ * @brief Process 'pid' returns everything it holds (e.g. it finished).
+ */
+void bankerReturnAll(struct Banker *b, int pid) {
+    int m = b->numResources;
+    int all[m];
+
+    pthread_mutex_lock(&b->commitLock);
+    memcpy(all, &b->Allocation[(size_t)pid * m], m * sizeof(int));
+    pthread_mutex_unlock(&b->commitLock);
+
+    // Only this process's own thread releases its row, so 'all' is still
+    // accurate; bankerRelease() re-checks it anyway.
+    bankerRelease(b, pid, all);
+}
+
+/**
+ * @brief Verifies Available + sum(Allocation) == total and Need == Max - Allocation,
+ * and that the final state is safe.
+ */
+bool bankerCheckInvariants(struct Banker *b, const int total[]) {
+    int n = b->numProcesses;
+    int m = b->numResources;
+    bool ok = true;
+
+    pthread_mutex_lock(&b->commitLock);
+    for (int j = 0; j < m; j++) {
+        long sum = b->Available[j];
+        for (int i = 0; i < n; i++) {
+            sum += b->Allocation[(size_t)i * m + j];
+            if (b->Need[(size_t)i * m + j] != b->Max[(size_t)i * m + j] - b->Allocation[(size_t)i * m + j]) {
+                ok = false;
+            }
+        }
+        if (sum != total[j]) ok = false;
+    }
+
+    struct Snapshot s;
+    snapshotInit(&s, b);
+    takeSnapshot(b, &s);
+    if (!isSafeSnapshot(b, &s, -1, NULL)) ok = false;
+    snapshotFree(&s);
+    pthread_mutex_unlock(&b->commitLock);
+
+    return ok;
+}
+
+/* ================================================================== */
+/*                      Demo / stress driver                          */
+/* ================================================================== */
+
+struct WorkerArgs {
+    struct Banker *banker;
+    int id;
+    int numThreads;
+    int operations;
+};
+
+/**
+ * @brief A worker owns the processes with pid % numThreads == id. It
+ * repeatedly requests a random part of a process's remaining Need, and
+ * returns everything once the process has reached its Max (it "finished").
+ */
+void *worker(void *arg) {
+    struct WorkerArgs *w = (struct WorkerArgs *)arg;
+    struct Banker *b = w->banker;
+    int m = b->numResources;
+    unsigned int seed = 1234u + (unsigned int)w->id;
+    int request[m];
+
+    struct Snapshot s;
+    snapshotInit(&s, b);
+
+    for (int op = 0; op < w->operations; op++) {
+        int owned = (b->numProcesses - w->id + w->numThreads - 1) / w->numThreads;
+        if (owned <= 0) break;
+        int pid = w->id + (rand_r(&seed) % owned) * w->numThreads;
+
+        // Only this thread changes this row, so a relaxed read is enough
+        bool done = true;
+        for (int j = 0; j < m; j++) {
+            int need = __atomic_load_n(&b->Need[(size_t)pid * m + j], __ATOMIC_RELAXED);
+            request[j] = need > 0 ? rand_r(&seed) % (need + 1) : 0;
+            if (need > 0) done = false;
+        }
+
+        if (done) {
+            bankerReturnAll(b, pid);
+        } else {
+            bankerRequest(b, &s, pid, request);
+        }
+    }
+
+    snapshotFree(&s);
+    return NULL;
+}
+
+/**
+ * @brief Builds a random system, hammers it from several threads and
+ * reports throughput and how often optimistic commits had to retry.
+ */
+int main() {
+    int n, m, threads, operations;
+
+    printf("--- Concurrent Banker's Algorithm ---\n");
+    printf("Enter total number of processes: ");
+    scanf("%d", &n);
+    printf("Enter total number of resource types: ");
+    scanf("%d", &m);
+    printf("Enter number of worker threads: ");
+    scanf("%d", &threads);
+    printf("Enter operations per thread: ");
+    scanf("%d", &operations);
+
+    if (n <= 0 || m <= 0 || threads <= 0 || operations < 0) {
+        printf("Error: all values must be positive.\n");
+        return 1;
+    }
+
+    // Random Max matrix; totals are large enough that most requests fit
+    int *total = (int *)malloc(m * sizeof(int));
+    int *max = (int *)malloc((size_t)n * m * sizeof(int));
+    if (total == NULL || max == NULL) {
+        printf("Error: Memory allocation failed!\n");
+        return 1;
+    }
+    unsigned int seed = 42;
+    for (int j = 0; j < m; j++) total[j] = 0;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < m; j++) {
+            max[(size_t)i * m + j] = rand_r(&seed) % 10;
+            total[j] += max[(size_t)i * m + j];
+        }
+    }
+    for (int j = 0; j < m; j++) total[j] = total[j] / 3 + 10;
+
+    struct Banker *b = bankerCreate(n, m, total, max);
+
+    pthread_t tids[threads];
+    struct WorkerArgs args[threads];
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int t = 0; t < threads; t++) {
+        args[t].banker = b;
+        args[t].id = t;
+        args[t].numThreads = threads;
+        args[t].operations = operations;
+        if (pthread_create(&tids[t], NULL, worker, &args[t]) != 0) {
+            perror("pthread_create worker failed");
+            exit(1);
+        }
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(tids[t], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    long granted = atomic_load(&b->granted);
+    long denied = atomic_load(&b->denied);
+
+    printf("\n--- Results ---\n");
+    printf("Requests granted:  %ld\n", granted);
+    printf("Requests denied:   %ld\n", denied);
+    printf("Releases:          %ld\n", atomic_load(&b->released));
+    printf("Optimistic retries:%ld\n", atomic_load(&b->retries));
+    printf("Locked fallbacks:  %ld\n", atomic_load(&b->fallbacks));
+    printf("Elapsed:           %.3f s\n", seconds);
+    printf("Throughput:        %.0f requests/s\n", (granted + denied) / (seconds > 0 ? seconds : 1e-9));
+    printf("Invariants:        %s\n", bankerCheckInvariants(b, total) ? "OK" : "VIOLATED");
+
+    bankerDestroy(b);
+    free(max);
+    free(total);
+    return 0;
+}
@@ -0,0 +1,778 @@
+/**
+ * Deadlock DETECTION in C (companion to Bankers.c)
+ *
+ * Bankers.c does deadlock *avoidance*: every process must declare its Max
+ * up front, and any request that would leave the system unsafe is denied.
+ * This program does the opposite: requests are granted optimistically and
+ * deadlocks are *detected* after the fact. Two engines are provided:
+ *
+ *  1. Multi-instance detection: the classic detection algorithm over the
+ *     Available vector and the Allocation / Request matrices. Instead of
+ *     rescanning every process on every pass (O(n^2 * m)), each resource
+ *     column keeps its waiting processes sorted by requested amount, so
+ *     growing Work[j] only ever advances a pointer. Total cost is
+ *     O(n * m * log n).
+ *
+ *  2. Single-instance wait-for graph: every resource has one instance, so
+ *     a blocked process Pi waiting on a resource held by Pj is the edge
+ *     Pi -> Pj. The graph is kept in a topological order which is repaired
+ *     incrementally when an edge is added (Pearce-Kelly), so a new wait
+ *     only explores the part of the graph between the two endpoints. A
+ *     cycle is found exactly when that repair reaches the requester again.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>  // For malloc, free, qsort and exit
+#include <stdbool.h> // For bool, true, and false
+
+// --- Multi-instance state ---
+int numProcesses; // Total number of processes
+int numResources; // Total number of resource types
+
+int *Available;   // 1D Array (vector)
+int **Allocation; // 2D Array (matrix)
+int **Request;    // 2D Array (matrix): what each process is currently blocked on
+
+// --- Single-instance wait-for graph state ---
+// Every array below is indexed either by process (P) or by resource (R).
+int *owner;      // [R] process holding the resource, -1 if free
+int *waitingOn;  // [P] resource the process is blocked on, -1 if running
+int *waitHead;   // [R] first process in the FIFO of waiters
+int *waitTail;   // [R] last process in the FIFO of waiters
+int *nextWaiter; // [P] next process in the same FIFO
+int *heldHead;   // [P] first resource in the list of resources the process holds
+int *nextHeld;   // [R] next resource held by the same owner
+int *prevHeld;   // [R] previous resource held by the same owner
+int *ord;        // [P] position of the process in the topological order
+int *ordToProc;  // inverse of ord[]
+bool *visited;   // [P] scratch flags for the incremental reorder
+int *stackBuf;   // [P] scratch stack for the backward search
+int *fwdBuf;     // [P] nodes reached by the forward search
+int *bwdBuf;     // [P] nodes reached by the backward search
+int *slotBuf;    // [2P] scratch for the reordered positions
+bool wfgQuiet;   // Set by the self-test: no per-command messages
+
+#define wfgLog(...) do { if (!wfgQuiet) printf(__VA_ARGS__); } while (0)
+
+// --- Function Prototypes ---
+void runMultiInstance();
+bool detectDeadlock(bool deadlocked[]);
+void runWaitForGraph();
+void wfgAllocate(int procs, int resources);
+void wfgFree();
+bool wfgAddEdge(int from, int to);
+bool wfgRequest(int pid, int res);
+bool wfgRelease(int pid, int res);
+void wfgFinish(int pid);
+void wfgPrint();
+void runSelfTest();
+
+/**
+ * @brief Main function: choose one of the two detection engines.
+ */
+int main() {
+    int mode;
+
+    printf("--- Deadlock Detection ---\n");
+    printf("1. Multi-instance resources (Allocation / Request matrices)\n");
+    printf("2. Single-instance resources (wait-for graph)\n");
+    printf("3. Self-test of the wait-for graph\n");
+    printf("Enter your choice (1-3): ");
+    if (scanf("%d", &mode) != 1) {
+        return 1;
+    }
+
+    if (mode == 1) {
+        runMultiInstance();
+    } else if (mode == 2) {
+        runWaitForGraph();
+    } else if (mode == 3) {
+        runSelfTest();
+    } else {
+        printf("Invalid choice.\n");
+        return 1;
+    }
+
+    printf("\nExiting program.\n");
+    return 0;
+}
+
+/* ================================================================== */
+/*                  1. Multi-instance detection                       */
+/* ================================================================== */
+
+/**
+ * @brief Reads the multi-instance state, runs detection and prints the
+ * set of deadlocked processes.
+ */
+void runMultiInstance() {
+    printf("Enter total number of processes: ");
+    scanf("%d", &numProcesses);
+    printf("Enter total number of resource types: ");
+    scanf("%d", &numResources);
+
+    if (numProcesses <= 0 || numResources <= 0) {
+        printf("Error: sizes must be positive.\n");
+        exit(1);
+    }
+
+    // Allocate the vector and both matrices
+    Available = (int *)malloc(numResources * sizeof(int));
+    Allocation = (int **)malloc(numProcesses * sizeof(int *));
+    Request = (int **)malloc(numProcesses * sizeof(int *));
+    if (Available == NULL || Allocation == NULL || Request == NULL) {
+        printf("Error: Memory allocation failed!\n");
+        exit(1);
+    }
+    for (int i = 0; i < numProcesses; i++) {
+        Allocation[i] = (int *)malloc(numResources * sizeof(int));
+        Request[i] = (int *)malloc(numResources * sizeof(int));
+        if (Allocation[i] == NULL || Request[i] == NULL) {
+            printf("Error: Row memory allocation failed!\n");
+            exit(1);
+        }
+    }
+
+    printf("\nEnter the Available vector:\n");
+    for (int j = 0; j < numResources; j++) {
+        printf("R%d: ", j);
+        scanf("%d", &Available[j]);
+    }
+
+    printf("\nEnter the Allocation Matrix (%d processes x %d resources):\n", numProcesses, numResources);
+    for (int i = 0; i < numProcesses; i++) {
+        printf("P%d:  ", i);
+        for (int j = 0; j < numResources; j++) {
+            scanf("%d", &Allocation[i][j]);
+        }
+    }
+
+    printf("\nEnter the Request Matrix (%d processes x %d resources):\n", numProcesses, numResources);
+    for (int i = 0; i < numProcesses; i++) {
+        printf("P%d:  ", i);
+        for (int j = 0; j < numResources; j++) {
+            scanf("%d", &Request[i][j]);
+        }
+    }
+
+    bool *deadlocked = (bool *)malloc(numProcesses * sizeof(bool));
+    if (deadlocked == NULL) {
+        printf("Error: Memory allocation failed!\n");
+        exit(1);
+    }
+
+    printf("\n### Running Detection Algorithm ###\n");
+    if (detectDeadlock(deadlocked)) {
+        printf("DEADLOCK: the following processes are deadlocked: ");
+        for (int i = 0; i < numProcesses; i++) {
+            if (deadlocked[i]) printf("P%d ", i);
+        }
+        printf("\n");
+    } else {
+        printf("No deadlock: every process can eventually complete.\n");
+    }
+
+    free(deadlocked);
+    for (int i = 0; i < numProcesses; i++) {
+        free(Allocation[i]);
+        free(Request[i]);
+    }
+    free(Allocation);
+    free(Request);
+    free(Available);
+}
+
+// One (amount, process) pair in a per-resource column
+struct ColumnEntry {
+    int amount;
+    int pid;
+};
+
+static int compareColumnEntry(const void *a, const void *b) {
+    const struct ColumnEntry *x = a;
+    const struct ColumnEntry *y = b;
+    return (x->amount > y->amount) - (x->amount < y->amount);
+}
+
+/**
+ * @brief Multi-instance deadlock detection.
+ *
+ * Work starts as Available. A process whose whole Request row is <= Work
+ * can finish and return its Allocation to Work. Instead of repeatedly
+ * scanning all rows, every column j keeps the processes that want some of
+ * resource j sorted by amount; 'pending[i]' counts the columns where P[i]
+ * is still unsatisfied. When Work[j] grows we advance column j's pointer,
+ * and a process becomes runnable the moment its counter reaches zero.
+ *
+ * @param deadlocked Filled with true for every process that can never finish.
+ * @return true if at least one process is deadlocked.
+ */
+bool detectDeadlock(bool deadlocked[]) {
+    int n = numProcesses;
+    int m = numResources;
+
+    long long *Work = (long long *)malloc(m * sizeof(long long));
+    int *pending = (int *)calloc(n, sizeof(int));
+    int *queue = (int *)malloc(n * sizeof(int));
+    int *columnStart = (int *)malloc((m + 1) * sizeof(int));
+    int *columnPos = (int *)malloc(m * sizeof(int));
+    bool *finished = (bool *)calloc(n, sizeof(bool));
+    if (Work == NULL || pending == NULL || queue == NULL || columnStart == NULL ||
+        columnPos == NULL || finished == NULL) {
+        printf("Error: Memory allocation failed!\n");
+        exit(1);
+    }
+
+    // --- Step 1: Build the sorted columns (CSR layout, one block) ---
+    int total = 0;
+    for (int j = 0; j < m; j++) {
+        columnStart[j] = total;
+        for (int i = 0; i < n; i++) {
+            if (Request[i][j] > 0) total++;
+        }
+    }
+    columnStart[m] = total;
+
+    struct ColumnEntry *entries = (struct ColumnEntry *)malloc((total > 0 ? total : 1) * sizeof(struct ColumnEntry));
+    if (entries == NULL) {
+        printf("Error: Memory allocation failed!\n");
+        exit(1);
+    }
+    for (int j = 0; j < m; j++) {
+        int k = columnStart[j];
+        for (int i = 0; i < n; i++) {
+            if (Request[i][j] > 0) {
+                entries[k].amount = Request[i][j];
+                entries[k].pid = i;
+                pending[i]++;
+                k++;
+            }
+        }
+        qsort(entries + columnStart[j], columnStart[j + 1] - columnStart[j],
+              sizeof(struct ColumnEntry), compareColumnEntry);
+        columnPos[j] = columnStart[j];
+        Work[j] = Available[j];
+    }
+
+    // --- Step 2: Satisfy everything Available can already cover ---
+    int head = 0, tail = 0;
+    for (int i = 0; i < n; i++) {
+        if (pending[i] == 0) queue[tail++] = i; // Requests nothing
+    }
+    for (int j = 0; j < m; j++) {
+        while (columnPos[j] < columnStart[j + 1] && entries[columnPos[j]].amount <= Work[j]) {
+            int p = entries[columnPos[j]++].pid;
+            if (--pending[p] == 0) queue[tail++] = p;
+        }
+    }
+
+    // --- Step 3: Let runnable processes finish and release ---
+    while (head < tail) {
+        int p = queue[head++];
+        finished[p] = true;
+
+        for (int j = 0; j < m; j++) {
+            if (Allocation[p][j] == 0) continue;
+            Work[j] += Allocation[p][j];
+            while (columnPos[j] < columnStart[j + 1] && entries[columnPos[j]].amount <= Work[j]) {
+                int q = entries[columnPos[j]++].pid;
+                if (--pending[q] == 0) queue[tail++] = q;
+            }
+        }
+    }
+
+    // --- Step 4: Whatever never finished is deadlocked ---
+    bool any = false;
+    for (int i = 0; i < n; i++) {
+        deadlocked[i] = !finished[i];
+        if (deadlocked[i]) any = true;
+    }
+
+    free(entries);
+    free(finished);
+    free(columnPos);
+    free(columnStart);
+    free(queue);
+    free(pending);
+    free(Work);
+    return any;
+}
+
+/* ================================================================== */
+/*                 2. Single-instance wait-for graph                  */
+/* ================================================================== */
+
+/**
+ * @brief Interactive loop over the wait-for graph. Requests are granted
+ * as soon as the resource is free; otherwise the process blocks and the
+ * new edge is checked for a cycle.
+ */
+void runWaitForGraph() {
+    int procs, resources;
+
+    printf("Enter total number of processes: ");
+    scanf("%d", &procs);
+    printf("Enter total number of single-instance resources: ");
+    scanf("%d", &resources);
+
+    if (procs <= 0 || resources <= 0) {
+        printf("Error: sizes must be positive.\n");
+        exit(1);
+    }
+
+    wfgAllocate(procs, resources);
+
+    printf("\nCommands:\n");
+    printf("  r <pid> <res>   request a resource\n");
+    printf("  l <pid> <res>   release a resource\n");
+    printf("  f <pid>         process finishes (releases everything)\n");
+    printf("  s               show the current graph\n");
+    printf("  q               quit\n");
+
+    char cmd;
+    while (true) {
+        int pid, res;
+
+        printf("\n> ");
+        if (scanf(" %c", &cmd) != 1 || cmd == 'q' || cmd == 'Q') {
+            break;
+        }
+
+        switch (cmd) {
+        case 'r':
+            scanf("%d %d", &pid, &res);
+            if (pid < 0 || pid >= procs || res < 0 || res >= resources) {
+                printf("Invalid process or resource ID.\n");
+                break;
+            }
+            wfgRequest(pid, res);
+            break;
+        case 'l':
+            scanf("%d %d", &pid, &res);
+            if (pid < 0 || pid >= procs || res < 0 || res >= resources) {
+                printf("Invalid process or resource ID.\n");
+                break;
+            }
+            wfgRelease(pid, res);
+            break;
+        case 'f':
+            scanf("%d", &pid);
+            if (pid < 0 || pid >= procs) {
+                printf("Invalid process ID.\n");
+                break;
+            }
+            wfgFinish(pid);
+            break;
+        case 's':
+            wfgPrint();
+            break;
+        default:
+            printf("Unknown command '%c'.\n", cmd);
+        }
+    }
+
+    wfgFree();
+}
+
+/**
+ * @brief Allocates and initialises every array of the wait-for graph.
+ */
+void wfgAllocate(int procs, int resources) {
+    numProcesses = procs;
+    numResources = resources;
+
+    owner = (int *)malloc(resources * sizeof(int));
+    waitHead = (int *)malloc(resources * sizeof(int));
+    waitTail = (int *)malloc(resources * sizeof(int));
+    nextHeld = (int *)malloc(resources * sizeof(int));
+    prevHeld = (int *)malloc(resources * sizeof(int));
+
+    waitingOn = (int *)malloc(procs * sizeof(int));
+    nextWaiter = (int *)malloc(procs * sizeof(int));
+    heldHead = (int *)malloc(procs * sizeof(int));
+    ord = (int *)malloc(procs * sizeof(int));
+    ordToProc = (int *)malloc(procs * sizeof(int));
+    visited = (bool *)calloc(procs, sizeof(bool));
+    stackBuf = (int *)malloc(procs * sizeof(int));
+    fwdBuf = (int *)malloc(procs * sizeof(int));
+    bwdBuf = (int *)malloc(procs * sizeof(int));
+    slotBuf = (int *)malloc(2 * procs * sizeof(int));
+
+    if (owner == NULL || waitHead == NULL || waitTail == NULL || nextHeld == NULL ||
+        prevHeld == NULL || waitingOn == NULL || nextWaiter == NULL || heldHead == NULL ||
+        ord == NULL || ordToProc == NULL || visited == NULL || stackBuf == NULL ||
+        fwdBuf == NULL || bwdBuf == NULL || slotBuf == NULL) {
+        printf("Error: Memory allocation failed!\n");
+        exit(1);
+    }
+
+    for (int r = 0; r < resources; r++) {
+        owner[r] = -1;
+        waitHead[r] = waitTail[r] = -1;
+        nextHeld[r] = prevHeld[r] = -1;
+    }
+    // With no edges, the identity is a valid topological order
+    for (int p = 0; p < procs; p++) {
+        waitingOn[p] = -1;
+        nextWaiter[p] = -1;
+        heldHead[p] = -1;
+        ord[p] = p;
+        ordToProc[p] = p;
+    }
+}
+
+/**
+ * @brief Frees every array of the wait-for graph.
+ */
+void wfgFree() {
+    free(owner);
+    free(waitHead);
+    free(waitTail);
+    free(nextHeld);
+    free(prevHeld);
+    free(waitingOn);
+    free(nextWaiter);
+    free(heldHead);
+    free(ord);
+    free(ordToProc);
+    free(visited);
+    free(stackBuf);
+    free(fwdBuf);
+    free(bwdBuf);
+    free(slotBuf);
+}
+
+// The single out-edge of a process: the owner of what it waits on (or -1)
+static int successorOf(int p) {
+    return waitingOn[p] == -1 ? -1 : owner[waitingOn[p]];
+}
+
+static int compareInt(const void *a, const void *b) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// Sort processes by their current position in the order
+static int compareByOrd(const void *a, const void *b) {
+    return compareInt(&ord[*(const int *)a], &ord[*(const int *)b]);
+}
+
+/**
+ * @brief Records the edge from -> to and repairs the topological order.
+ *
+ * If ord[from] < ord[to] the order is already consistent. Otherwise only
+ * nodes with lb <= ord <= ub can be on a path to -> ... -> from:
+ *  - forward from 'to' (a blocked process has exactly one successor, so
+ *    this is a walk along the chain) while ord < ub; reaching 'from'
+ *    means the new edge closes a cycle.
+ *  - backward from 'from' (over the waiters of the resources each node
+ *    holds) while ord > lb.
+ * The backward set is then placed before the forward set, reusing the
+ * same positions.
+ *
+ * @return false if the edge closes a cycle (the order is left untouched).
+ */
+bool wfgAddEdge(int from, int to) {
+    int lb = ord[to];
+    int ub = ord[from];
+    if (lb > ub) {
+        return true;
+    }
+
+    // --- Forward search from 'to' ---
+    int fwdCount = 0;
+    for (int v = to; v != -1 && ord[v] <= ub; v = successorOf(v)) {
+        if (v == from) {
+            // to -> ... -> from already exists: cycle. Clear the flags set
+            // so far, or later backward searches would skip these nodes
+            for (int i = 0; i < fwdCount; i++) visited[fwdBuf[i]] = false;
+            return false;
+        }
+        fwdBuf[fwdCount++] = v;
+        visited[v] = true;
+    }
+
+    // --- Backward search from 'from' ---
+    int bwdCount = 0;
+    int top = 0;
+    stackBuf[top++] = from;
+    visited[from] = true;
+    while (top > 0) {
+        int v = stackBuf[--top];
+        bwdBuf[bwdCount++] = v;
+        for (int r = heldHead[v]; r != -1; r = nextHeld[r]) {
+            for (int u = waitHead[r]; u != -1; u = nextWaiter[u]) {
+                if (!visited[u] && ord[u] > lb) {
+                    visited[u] = true;
+                    stackBuf[top++] = u;
+                }
+            }
+        }
+    }
+
+    // --- Reassign positions: backward set first, then forward set ---
+    qsort(fwdBuf, fwdCount, sizeof(int), compareByOrd);
+    qsort(bwdBuf, bwdCount, sizeof(int), compareByOrd);
+
+    int slots = 0;
+    for (int i = 0; i < bwdCount; i++) slotBuf[slots++] = ord[bwdBuf[i]];
+    for (int i = 0; i < fwdCount; i++) slotBuf[slots++] = ord[fwdBuf[i]];
+    qsort(slotBuf, slots, sizeof(int), compareInt);
+
+    int k = 0;
+    for (int i = 0; i < bwdCount; i++) {
+        int v = bwdBuf[i];
+        ord[v] = slotBuf[k++];
+        ordToProc[ord[v]] = v;
+        visited[v] = false;
+    }
+    for (int i = 0; i < fwdCount; i++) {
+        int v = fwdBuf[i];
+        ord[v] = slotBuf[k++];
+        ordToProc[ord[v]] = v;
+        visited[v] = false;
+    }
+    return true;
+}
+
+// Adds resource 'res' to the front of the held list of 'pid'
+static void giveResource(int pid, int res) {
+    owner[res] = pid;
+    prevHeld[res] = -1;
+    nextHeld[res] = heldHead[pid];
+    if (heldHead[pid] != -1) prevHeld[heldHead[pid]] = res;
+    heldHead[pid] = res;
+}
+
+// Unlinks resource 'res' from its owner's held list
+static void takeResource(int res) {
+    int pid = owner[res];
+    if (prevHeld[res] != -1) nextHeld[prevHeld[res]] = nextHeld[res];
+    else heldHead[pid] = nextHeld[res];
+    if (nextHeld[res] != -1) prevHeld[nextHeld[res]] = prevHeld[res];
+    nextHeld[res] = prevHeld[res] = -1;
+    owner[res] = -1;
+}
+
+/**
+ * @brief Process 'pid' requests single-instance resource 'res'.
+ * Free resources are granted immediately. A held resource blocks the
+ * caller and adds the edge pid -> owner; if that edge closes a cycle the
+ * deadlock is reported and the request is withdrawn (the requester is
+ * chosen as the victim) so the graph stays acyclic.
+ * @return true if the process got the resource or is now waiting for it.
+ */
+bool wfgRequest(int pid, int res) {
+    if (waitingOn[pid] != -1) {
+        wfgLog("DENIED: P%d is blocked on R%d and cannot issue requests.\n", pid, waitingOn[pid]);
+        return false;
+    }
+    if (owner[res] == pid) {
+        wfgLog("P%d already holds R%d.\n", pid, res);
+        return true;
+    }
+    if (owner[res] == -1) {
+        giveResource(pid, res);
+        wfgLog("GRANTED: R%d -> P%d.\n", res, pid);
+        return true;
+    }
+
+    int holder = owner[res];
+    if (!wfgAddEdge(pid, holder)) {
+        wfgLog("DEADLOCK: P%d waiting on R%d closes the cycle: P%d", pid, res, pid);
+        for (int v = holder; v != pid; v = successorOf(v)) {
+            wfgLog(" -> P%d", v);
+        }
+        wfgLog(" -> P%d\n", pid);
+        wfgLog("Recovery: request withdrawn, P%d keeps running.\n", pid);
+        return false;
+    }
+
+    // Append to the FIFO of waiters on 'res'
+    waitingOn[pid] = res;
+    nextWaiter[pid] = -1;
+    if (waitTail[res] == -1) waitHead[res] = pid;
+    else nextWaiter[waitTail[res]] = pid;
+    waitTail[res] = pid;
+
+    wfgLog("BLOCKED: P%d waits for R%d (held by P%d).\n", pid, res, holder);
+    return true;
+}
+
+/**
+ * @brief Process 'pid' releases 'res'. The first waiter (if any) gets it,
+ * and every other waiter now waits on that new owner.
+ * @return true if the release was valid.
+ */
+bool wfgRelease(int pid, int res) {
+    if (owner[res] != pid) {
+        wfgLog("DENIED: P%d does not hold R%d.\n", pid, res);
+        return false;
+    }
+
+    takeResource(res);
+    wfgLog("RELEASED: R%d by P%d.\n", res, pid);
+
+    int next = waitHead[res];
+    if (next == -1) {
+        return true;
+    }
+
+    // Hand the resource to the first waiter
+    waitHead[res] = nextWaiter[next];
+    if (waitHead[res] == -1) waitTail[res] = -1;
+    nextWaiter[next] = -1;
+    waitingOn[next] = -1;
+    giveResource(next, res);
+    wfgLog("GRANTED: R%d -> P%d (was waiting).\n", res, next);
+
+    // The remaining waiters now point at 'next'. 'next' is running (no
+    // out-edge), so these edges can never close a cycle; they only need
+    // the order repaired.
+    for (int u = waitHead[res]; u != -1; u = nextWaiter[u]) {
+        wfgAddEdge(u, next);
+    }
+    return true;
+}
+
+/**
+ * @brief Process 'pid' terminates and releases everything it holds.
+ */
+void wfgFinish(int pid) {
+    if (waitingOn[pid] != -1) {
+        wfgLog("DENIED: P%d is blocked on R%d and cannot finish.\n", pid, waitingOn[pid]);
+        return;
+    }
+    while (heldHead[pid] != -1) {
+        wfgRelease(pid, heldHead[pid]);
+    }
+    wfgLog("P%d finished.\n", pid);
+}
+
+/**
+ * @brief Prints ownership, wait edges and the current topological order.
+ */
+void wfgPrint() {
+    printf("Resources:\n");
+    for (int r = 0; r < numResources; r++) {
+        if (owner[r] == -1) {
+            printf("   R%d: free\n", r);
+            continue;
+        }
+        printf("   R%d: held by P%d, waiters: [ ", r, owner[r]);
+        for (int u = waitHead[r]; u != -1; u = nextWaiter[u]) printf("P%d ", u);
+        printf("]\n");
+    }
+
+    printf("Wait-for edges:\n");
+    for (int p = 0; p < numProcesses; p++) {
+        int s = successorOf(p);
+        if (s != -1) printf("   P%d -> P%d (R%d)\n", p, s, waitingOn[p]);
+    }
+
+    printf("Topological order: ");
+    for (int i = 0; i < numProcesses; i++) printf("P%d ", ordToProc[i]);
+    printf("\n");
+}
+
+/* ================================================================== */
+/*                     3. Self-test (wait-for graph)                  */
+/* ================================================================== */
+
+// Brute force: does pid waiting on the holder of res close a cycle?
+static bool closesCycle(int pid, int res) {
+    int v = owner[res];
+    for (int steps = 0; v != -1 && v != pid && steps <= numProcesses; steps++) {
+        v = successorOf(v);
+    }
+    return v == pid;
+}
+
+// Every wait edge must point forward in the topological order
+static bool orderIsValid() {
+    for (int p = 0; p < numProcesses; p++) {
+        int s = successorOf(p);
+        if (s != -1 && ord[p] >= ord[s]) return false;
+        if (ordToProc[ord[p]] != p) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief One request checked against the brute-force detector.
+ * @return false (after printing why) if the two disagree.
+ */
+static bool checkedRequest(int pid, int res, const char *where) {
+    bool expectDeadlock = waitingOn[pid] == -1 && owner[res] != -1 && owner[res] != pid &&
+                          closesCycle(pid, res);
+    bool blockedBefore = waitingOn[pid] != -1;
+    bool ok = wfgRequest(pid, res);
+    if (!blockedBefore && ok == expectDeadlock) {
+        printf("FAIL (%s): P%d requesting R%d: %s, expected %s\n", where, pid, res,
+               ok ? "no deadlock" : "deadlock", expectDeadlock ? "deadlock" : "none");
+        return false;
+    }
+    if (!orderIsValid()) {
+        printf("FAIL (%s): topological order broken after P%d requested R%d\n", where, pid, res);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks the incremental detector against a brute-force walk of
+ * the wait chain: first a fixed case where an edge closing a cycle is
+ * followed by more edges (the rejected edge must leave no trace), then
+ * 3000 random request/release/finish sequences.
+ */
+void runSelfTest() {
+    wfgQuiet = true;
+    int failures = 0;
+
+    // --- Fixed case: a rejected edge, then edges that reorder through it ---
+    wfgAllocate(3, 3);
+    bool ok = checkedRequest(1, 1, "fixed") && checkedRequest(2, 2, "fixed") &&
+              checkedRequest(0, 0, "fixed") &&
+              checkedRequest(1, 2, "fixed") && // P1 -> P2
+              checkedRequest(2, 1, "fixed") && // P2 -> P1 closes a cycle: withdrawn
+              checkedRequest(2, 0, "fixed") && // P2 -> P0: P1 must move with P2
+              checkedRequest(0, 1, "fixed");   // P0 -> P1 -> P2 -> P0: cycle
+    failures += !ok;
+    wfgFree();
+
+    // --- Random sequences ---
+    const int seeds = 3000, ops = 200;
+    for (int seed = 0; seed < seeds; seed++) {
+        srand(seed);
+        int procs = 2 + rand() % 10;
+        int resources = 1 + rand() % 10;
+        wfgAllocate(procs, resources);
+        char where[32];
+        snprintf(where, sizeof where, "seed %d", seed);
+
+        ok = true;
+        for (int i = 0; i < ops && ok; i++) {
+            int pid = rand() % procs;
+            int res = rand() % resources;
+            int op = rand() % 10;
+            if (op < 7) {
+                ok = checkedRequest(pid, res, where);
+            } else if (op < 9) {
+                if (owner[res] != -1) wfgRelease(owner[res], res);
+            } else if (waitingOn[pid] == -1) {
+                wfgFinish(pid);
+            }
+            if (ok && !orderIsValid()) {
+                printf("FAIL (%s): topological order broken after a release\n", where);
+                ok = false;
+            }
+        }
+        failures += !ok;
+        wfgFree();
+    }
+
+    wfgQuiet = false;
+    printf("Self-test: %d of %d cases failed.\n", failures, seeds + 1);
+    if (failures > 0) exit(1);
+}
@@ -0,0 +1,477 @@
+/*
+ * LIVE scheduling: run an FCFS or SRTF schedule with REAL processes.
+ *
+ * FCFS.c and SRTF.c only compute numbers, and fork.c only shows how a
+ * process is created. This program connects them:
+ *
+ *  1. It SIMULATES the schedule exactly like FCFS.c / SRTF.c (event by
+ *     event), producing a timeline of slices "process P runs from s to e".
+ *  2. It forks one CPU-BOUND child per process. A child spins until it has
+ *     used exactly BT x unit of CPU time, then exits. Parent and children
+ *     are pinned to ONE core so they really compete for a single CPU.
+ *  3. It ENFORCES the schedule, in one of two ways:
+ *       signals  children start stopped; for every slice the parent
+ *                sends SIGCONT, sleeps for the slice, then SIGSTOP;
+ *       fifo     the kernel schedules: children run under SCHED_FIFO on
+ *                the pinned core. FCFS = one shared priority (the kernel's
+ *                FIFO queue IS first-come-first-served); SRTF = the parent
+ *                wakes at every arrival and re-ranks priorities by each
+ *                child's remaining CPU time (read from its CPU clock).
+ *                Needs CAP_SYS_NICE; falls back to signals otherwise.
+ *  4. It MEASURES what really happened: exit time from wait4(), CPU time
+ *     and context switches from the child's rusage, and prints simulated
+ *     vs. real WT/TAT plus the per-switch overhead.
+ *
+ * Usage: ./LiveSched [fcfs|srtf] [signals|fifo] [unit_ms]
+ *        then enter the processes like SRTF.c (count, then A.T. and B.T.)
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>       // For malloc(), exit(), atoi()
+#include <string.h>       // For strcmp()
+#include <errno.h>        // For errno
+#include <signal.h>       // For kill(), SIGSTOP, SIGCONT
+#include <sched.h>        // For sched_setaffinity(), sched_setscheduler()
+#include <time.h>         // For clock_gettime(), clock_nanosleep()
+#include <unistd.h>       // For fork(), _exit()
+#include <sys/types.h>    // For pid_t
+#include <sys/wait.h>     // For waitpid(), wait4()
+#include <sys/resource.h> // For struct rusage
+
+#define FIFO_PARENT_PRIORITY 90
+#define FIFO_CHILD_BASE 10
+
+enum Policy { FCFS, SRTF };
+enum Mode { SIGNALS, FIFO };
+
+struct Process {
+    int pid;
+    int at;  // Arrival Time
+    int bt;  // Burst Time
+    int ct, tat, wt; // Simulated
+    int rt;  // Remaining Time (simulation)
+
+    // Live run
+    pid_t child;
+    int exited;
+    double realCt, realCpu; // Seconds since the start of the run
+    long switches;          // Voluntary + involuntary context switches
+};
+
+struct Slice {
+    int proc;
+    int start, end;
+};
+
+struct Process *p;
+int n;
+struct Slice *slices;
+int numSlices;
+enum Policy policy = FCFS;
+enum Mode mode = SIGNALS;
+double unit = 0.010;  // Seconds of CPU per simulated time unit
+int core;             // The core everything is pinned to
+
+/* ================================================================== */
+/*                        1. Simulation                               */
+/* ================================================================== */
+
+static void addSlice(int proc, int start, int end) {
+    if (numSlices > 0 && slices[numSlices - 1].proc == proc && slices[numSlices - 1].end == start) {
+        slices[numSlices - 1].end = end;
+        return;
+    }
+    slices[numSlices++] = (struct Slice){ proc, start, end };
+}
+
+/**
+ * Event-driven FCFS / SRTF: the clock jumps to the next completion or
+ * (for SRTF) the next arrival that could preempt.
+ */
+void simulate() {
+    slices = malloc(2 * n * sizeof(struct Slice));
+    if (slices == NULL) {
+        perror("malloc failed");
+        exit(1);
+    }
+    for (int i = 0; i < n; i++) p[i].rt = p[i].bt;
+
+    int time = 0, completed = 0;
+    while (completed < n) {
+        // --- Pick the best arrived process ---
+        int best = -1;
+        for (int i = 0; i < n; i++) {
+            if (p[i].rt == 0 || p[i].at > time) continue;
+            if (best == -1) {
+                best = i;
+            } else if (policy == FCFS) {
+                if (p[i].at < p[best].at) best = i;
+            } else if (p[i].rt < p[best].rt) {
+                best = i;
+            }
+        }
+
+        // --- Next arrival after now ---
+        int nextArrival = -1;
+        for (int i = 0; i < n; i++) {
+            if (p[i].rt > 0 && p[i].at > time && (nextArrival == -1 || p[i].at < nextArrival)) {
+                nextArrival = p[i].at;
+            }
+        }
+
+        if (best == -1) {
+            time = nextArrival; // CPU idle until someone arrives
+            continue;
+        }
+
+        // FCFS runs to completion; SRTF only until the next arrival
+        int until = time + p[best].rt;
+        if (policy == SRTF && nextArrival != -1 && nextArrival < until) until = nextArrival;
+        addSlice(best, time, until);
+        p[best].rt -= until - time;
+        time = until;
+
+        if (p[best].rt == 0) {
+            completed++;
+            p[best].ct = time;
+            p[best].tat = p[best].ct - p[best].at;
+            p[best].wt = p[best].tat - p[best].bt;
+        }
+    }
+}
+
+/* ================================================================== */
+/*                        2. The real processes                       */
+/* ================================================================== */
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void sleepUntil(double deadline) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)deadline;
+    ts.tv_nsec = (long)((deadline - ts.tv_sec) * 1e9);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);
+}
+
+// Child body: burn exactly 'seconds' of CPU time, then exit
+static void burn(double seconds) {
+    struct timespec ts;
+    volatile unsigned long sink = 0;
+    do {
+        for (int i = 0; i < 10000; i++) sink += i;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    } while (ts.tv_sec + ts.tv_nsec / 1e9 < seconds);
+    _exit(0);
+}
+
+static void rankByRemaining(int arrived);
+
+/**
+ * Forks the child for process i. In signals mode it stops itself at once
+ * and waits for its first SIGCONT.
+ *
+ * In fifo mode the parent runs with SCHED_RESET_ON_FORK, so the child
+ * starts as an ordinary SCHED_OTHER task; the parent then RAISES it to
+ * SCHED_FIFO, and a raised thread joins the TAIL of its priority's list,
+ * which is exactly FCFS order. (Lowering a runnable thread would put it
+ * at the FRONT instead.)
+ */
+static void spawn(int i, int fifoPriority) {
+    fflush(stdout); // fork() would duplicate buffered output
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("Fork failed");
+        exit(1);
+    }
+    if (pid == 0) {
+        if (mode == SIGNALS) raise(SIGSTOP);
+        burn(p[i].bt * unit);
+    }
+    p[i].child = pid;
+
+    if (mode == SIGNALS) {
+        int status;
+        waitpid(pid, &status, WUNTRACED); // Wait until it is really stopped
+        return;
+    }
+    struct sched_param sp = { .sched_priority = fifoPriority };
+    if (sched_setscheduler(pid, SCHED_FIFO, &sp) == -1) perror("sched_setscheduler failed");
+    if (policy == SRTF) rankByRemaining(i + 1);
+}
+
+static void recordExit(int i, int status, const struct rusage *ru, double t0) {
+    (void)status;
+    p[i].exited = 1;
+    p[i].realCt = nowSeconds() - t0;
+    p[i].realCpu = ru->ru_utime.tv_sec + ru->ru_utime.tv_usec / 1e6 +
+                   ru->ru_stime.tv_sec + ru->ru_stime.tv_usec / 1e6;
+    p[i].switches = ru->ru_nvcsw + ru->ru_nivcsw;
+}
+
+/**
+ * Replays the simulated slices with SIGCONT / SIGSTOP.
+ * @return Number of enforced context switches.
+ */
+static long runWithSignals(double t0) {
+    for (int i = 0; i < n; i++) spawn(i, 0);
+    // Re-base the clock: spawning is not part of the schedule
+    t0 = nowSeconds();
+
+    long switches = 0;
+    for (int s = 0; s < numSlices; s++) {
+        struct Slice *sl = &slices[s];
+        struct Process *proc = &p[sl->proc];
+        // It ran past an earlier slice, used up its budget and exited
+        if (proc->exited) continue;
+
+        // Idle gap in the schedule: wait; if we are late, start at once
+        double plannedStart = t0 + sl->start * unit;
+        if (nowSeconds() < plannedStart) sleepUntil(plannedStart);
+
+        kill(proc->child, SIGCONT);
+        switches++;
+
+        // Last slice of this process: it exits once its CPU budget is used
+        int last = 1;
+        for (int k = s + 1; k < numSlices; k++) {
+            if (slices[k].proc == sl->proc) {
+                last = 0;
+                break;
+            }
+        }
+
+        if (last) {
+            struct rusage ru;
+            int status;
+            pid_t r;
+            while ((r = wait4(proc->child, &status, 0, &ru)) < 0 && errno == EINTR);
+            if (r == proc->child) recordExit(sl->proc, status, &ru, t0);
+        } else {
+            sleepUntil(nowSeconds() + (sl->end - sl->start) * unit);
+            kill(proc->child, SIGSTOP);
+            // If the parent woke late the child may already have finished:
+            // then this reaps it instead of seeing it stop
+            struct rusage ru;
+            int status;
+            pid_t r;
+            while ((r = wait4(proc->child, &status, WUNTRACED, &ru)) < 0 && errno == EINTR);
+            if (r == proc->child && (WIFEXITED(status) || WIFSIGNALED(status))) {
+                recordExit(sl->proc, status, &ru, t0);
+            }
+        }
+    }
+    return switches;
+}
+
+// CPU time a live child has used so far, in seconds
+static double childCpu(pid_t pid) {
+    clockid_t clock;
+    struct timespec ts;
+    if (clock_getcpuclockid(pid, &clock) != 0 || clock_gettime(clock, &ts) != 0) return 0;
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * SRTF under SCHED_FIFO: shortest remaining CPU time gets the highest
+ * priority. Called by the parent (at a higher priority) at each arrival.
+ */
+static void rankByRemaining(int arrived) {
+    int order[n];
+    double remaining[n];
+    int count = 0;
+    for (int i = 0; i < arrived; i++) {
+        if (p[i].exited) continue;
+        remaining[i] = p[i].bt * unit - childCpu(p[i].child);
+        order[count++] = i;
+    }
+    // Insertion sort: longest first, so it gets the lowest priority
+    for (int a = 1; a < count; a++) {
+        int x = order[a], b = a - 1;
+        while (b >= 0 && remaining[order[b]] < remaining[x]) {
+            order[b + 1] = order[b];
+            b--;
+        }
+        order[b + 1] = x;
+    }
+    // Ranks must stay below the parent, or it could no longer wake up at
+    // arrivals. With more children than levels, squeeze them: the
+    // shortest still gets the top level to itself (it is the one that
+    // runs), longer ones may share a level and then run in FIFO order.
+    int levels = FIFO_PARENT_PRIORITY - FIFO_CHILD_BASE;
+    for (int r = 0; r < count; r++) {
+        int level = count <= levels ? r : (int)((long)r * (levels - 1) / (count - 1));
+        struct sched_param sp = { .sched_priority = FIFO_CHILD_BASE + level };
+        if (sched_setscheduler(p[order[r]].child, SCHED_FIFO, &sp) == -1 && errno != ESRCH) {
+            perror("sched_setscheduler failed");
+        }
+    }
+}
+
+static int compareArrival(const void *a, const void *b) {
+    const struct Process *pa = a, *pb = b;
+    if (pa->at != pb->at) return pa->at - pb->at;
+    return pa->pid - pb->pid;
+}
+
+// Reaps every child that has exited, without blocking
+static void reapFinished(double t0) {
+    struct rusage ru;
+    int status;
+    pid_t done;
+    while ((done = wait4(-1, &status, WNOHANG, &ru)) > 0) {
+        for (int k = 0; k < n; k++) {
+            if (p[k].child == done) recordExit(k, status, &ru, t0);
+        }
+    }
+}
+
+/**
+ * Lets the kernel schedule: children are created at their arrival times
+ * under SCHED_FIFO. Between arrivals the parent sleeps in sigtimedwait()
+ * so it reaps (and timestamps) every exit as it happens.
+ * @return Total context switches the children reported.
+ */
+static long runWithFifo(double t0) {
+    // Arrival order (p[] is sorted; pid is kept for printing)
+    qsort(p, n, sizeof(struct Process), compareArrival);
+
+    sigset_t chld;
+    sigemptyset(&chld);
+    sigaddset(&chld, SIGCHLD);
+    sigprocmask(SIG_BLOCK, &chld, NULL);
+
+    int exited = 0;
+    for (int i = 0; i <= n; i++) {
+        // Until the next arrival (or, after the last one, until all exit)
+        double deadline = i < n ? t0 + p[i].at * unit : 0;
+        while (1) {
+            reapFinished(t0);
+            exited = 0;
+            for (int k = 0; k < i; k++) exited += p[k].exited;
+            if (i == n && exited == n) break;
+
+            double left = deadline - nowSeconds();
+            if (i < n && left <= 0) break;
+            struct timespec timeout = { (time_t)left, (long)((left - (time_t)left) * 1e9) };
+            sigtimedwait(&chld, NULL, i < n ? &timeout : NULL);
+        }
+        if (i < n) spawn(i, FIFO_CHILD_BASE);
+    }
+
+    long switches = 0;
+    for (int k = 0; k < n; k++) switches += p[k].switches;
+    return switches;
+}
+
+/* ================================================================== */
+/*                        3. Report                                   */
+/* ================================================================== */
+
+static void report(long switches) {
+    double simWt = 0, simTat = 0, realWt = 0, realTat = 0;
+    double simMakespan = 0, realMakespan = 0;
+
+    printf("\n--- %s: simulated vs. real (%s mode, 1 unit = %.1f ms, core %d) ---\n",
+           policy == SRTF ? "SRTF" : "FCFS", mode == FIFO ? "SCHED_FIFO" : "SIGSTOP/SIGCONT",
+           unit * 1e3, core);
+    printf("PID\tAT\tBT\tCT\tTAT\tWT\t| real CT\treal TAT\treal WT\tCPU\tcsw\n");
+    printf("--------------------------------------------------------------------------------------------\n");
+    for (int i = 0; i < n; i++) {
+        struct Process *q = &p[i];
+        double tat = q->realCt - q->at * unit;
+        double wt = tat - q->realCpu;
+        printf("P%d\t%d\t%d\t%d\t%d\t%d\t| %.2f\t\t%.2f\t\t%.2f\t%.2f\t%ld\n",
+               q->pid, q->at, q->bt, q->ct, q->tat, q->wt,
+               q->realCt / unit, tat / unit, wt / unit, q->realCpu / unit, q->switches);
+        simWt += q->wt;
+        simTat += q->tat;
+        realWt += wt / unit;
+        realTat += tat / unit;
+        if (q->ct > simMakespan) simMakespan = q->ct;
+        if (q->realCt / unit > realMakespan) realMakespan = q->realCt / unit;
+    }
+
+    printf("\n(real columns in units of %.1f ms; WT = TAT - CPU time actually used)\n", unit * 1e3);
+    printf("Average Waiting Time:    simulated %.2f, real %.2f (gap %+.2f)\n",
+           simWt / n, realWt / n, (realWt - simWt) / n);
+    printf("Average Turnaround Time: simulated %.2f, real %.2f (gap %+.2f)\n",
+           simTat / n, realTat / n, (realTat - simTat) / n);
+    printf("Makespan:                simulated %.2f, real %.2f (gap %+.2f)\n",
+           simMakespan, realMakespan, realMakespan - simMakespan);
+    if (switches > 0) {
+        printf("Context switches: %ld, overhead %.1f us per switch\n", switches,
+               (realMakespan - simMakespan) * unit * 1e6 / switches);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 2) policy = strcmp(argv[1], "srtf") == 0 ? SRTF : FCFS;
+    if (argc >= 3) mode = strcmp(argv[2], "fifo") == 0 ? FIFO : SIGNALS;
+    if (argc >= 4) unit = atoi(argv[3]) / 1e3;
+    if (unit <= 0) {
+        printf("Usage: %s [fcfs|srtf] [signals|fifo] [unit_ms]\n", argv[0]);
+        return 1;
+    }
+
+    printf("Enter number of Processes:\n");
+    if (scanf("%d", &n) != 1 || n < 1) return 1;
+    p = calloc(n, sizeof(struct Process));
+    if (p == NULL) {
+        perror("calloc failed");
+        return 1;
+    }
+    for (int i = 0; i < n; i++) {
+        p[i].pid = i;
+        printf("Enter A.T. for Process with pid:%d: ", i);
+        if (scanf("%d", &p[i].at) != 1) return 1;
+        printf("Enter B.T. for Process with pid:%d: ", i);
+        if (scanf("%d", &p[i].bt) != 1 || p[i].bt < 1 || p[i].at < 0) return 1;
+    }
+    printf("\n");
+
+    simulate();
+    printf("Simulated timeline:");
+    for (int s = 0; s < numSlices; s++) {
+        printf(" [%d-%d P%d]", slices[s].start, slices[s].end, p[slices[s].proc].pid);
+    }
+    printf("\n");
+
+    // Pin to the last online core; children inherit the mask
+    cpu_set_t set;
+    core = (int)sysconf(_SC_NPROCESSORS_ONLN) - 1;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) == -1) perror("sched_setaffinity failed");
+
+    if (mode == FIFO) {
+        struct sched_param sp = { .sched_priority = FIFO_PARENT_PRIORITY };
+        if (sched_setscheduler(0, SCHED_FIFO | SCHED_RESET_ON_FORK, &sp) == -1) {
+            printf("SCHED_FIFO not permitted (%s); using SIGSTOP/SIGCONT instead.\n", strerror(errno));
+            mode = SIGNALS;
+        }
+    }
+
+    double t0 = nowSeconds();
+    long switches;
+    if (mode == FIFO) {
+        switches = runWithFifo(t0);
+    } else {
+        switches = runWithSignals(t0);
+    }
+
+    // Report in pid order
+    for (int i = 0; i < n; i++) {
+        for (int k = i + 1; k < n; k++) {
+            if (p[k].pid < p[i].pid) {
+                struct Process t = p[i]; p[i] = p[k]; p[k] = t;
+            }
+        }
+    }
+    report(switches);
+    return 0;
+}
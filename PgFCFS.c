@@ -1,4 +1,6 @@
 #include <stdio.h>
+#include "perfprof.h" // For perfPhase(): PERFPROF=1 prints counters per phase
+#include "oskernels.h" // For oskFifoAccess(), the replacement logic itself
 
 // Function to print the frames
 void printFrames(int frames[], int n) {
@@ -15,6 +17,8 @@ void printFrames(int frames[], int n) {
 int main() {
     int frame_count;
     int ref_len;
+
+    perfPhase("input");
     
     printf("Enter number of page frames: ");
     scanf("%d", &frame_count);
@@ -28,48 +32,34 @@ int main() {
         scanf("%d", &ref_string[i]);
     }
 
-    int frames[frame_count];
-    // Initialize all frames to -1 (empty)
-    for (int i = 0; i < frame_count; i++) {
-        frames[i] = -1;
+    perfPhase("simulate"); // Includes the per-step printing
+    // The frames and the FIFO "pointer" live in an OskFrames;
+    // oskFifoAccess() searches them and, on a fault, replaces the frame
+    // the pointer is at and moves the pointer on (the core FIFO logic)
+    struct OskFrames f;
+    if (!oskFramesInit(&f, frame_count)) {
+        printf("Error: Memory allocation failed!\n");
+        return 1;
     }
 
     int page_faults = 0;
-    int victim_frame = 0; // This is our FIFO "pointer"
 
     printf("\n--- FIFO Page Replacement Simulation ---\n");
     // Loop through each page in the reference string
     for (int i = 0; i < ref_len; i++) {
         int current_page = ref_string[i];
-        int found = 0;
-
-        // 1. Search if page is already in a frame
-        for (int j = 0; j < frame_count; j++) {
-            if (frames[j] == current_page) {
-                found = 1;
-                break; // Hit! No fault.
-            }
-        }
 
-        // 2. If 'found' is still 0, it's a Page Fault
-        if (found == 0) {
+        if (oskFifoAccess(&f, current_page)) {
             page_faults++;
-            
-            // Place the page in the current "victim" frame
-            frames[victim_frame] = current_page;
-            
-            // Update the victim_frame pointer for the *next* fault
-            // This is the core FIFO logic
-            victim_frame = (victim_frame + 1) % frame_count;
-            
             printf("Fault (Page %d): ", current_page);
-            printFrames(frames, frame_count);
         } else {
             printf("Hit   (Page %d): ", current_page);
-            printFrames(frames, frame_count);
         }
+        printFrames(f.frames, frame_count);
     }
 
+    perfPhase("output");
     printf("\nTotal Page Faults: %d\n", page_faults);
+    oskFramesFree(&f);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,566 @@
+/*
+ * REAL-TIME scheduling: Rate-Monotonic (RM) and Earliest-Deadline-First
+ * (EDF) for periodic and sporadic tasks.
+ *
+ * FCFS.c and SRTF.c schedule one-shot jobs. Real-time systems run TASKS
+ * that release a job every period T; each job needs C units of CPU and
+ * must finish within D of its release. This program
+ *
+ *  1. ANALYSES the task set before running it:
+ *     - total utilization U = sum(C/T) and the Liu-Layland RM bound;
+ *     - exact RESPONSE-TIME ANALYSIS for RM (fixed priority by period):
+ *           R = C_i + sum over higher-priority j of ceil(R / T_j) * C_j
+ *       iterated to a fixed point; the task is safe iff R <= D_i. When
+ *       D_i > T_i every job of the level-i busy period is checked;
+ *     - EDF: U <= 1 is exact when D = T; with D < T the processor-demand
+ *       test is run with Quick convergence Processor-demand Analysis (QPA).
+ *
+ *  2. SIMULATES both policies and reports, per task, jobs, deadline
+ *     misses, worst and average response time. The simulator jumps from
+ *     one release or completion straight to the next (no tick loop), so
+ *     the cost is per JOB, not per time unit. For synchronous periodic
+ *     task sets the schedule repeats every HYPERPERIOD (lcm of the
+ *     periods), so one hyperperiod is enough; with phases, the largest
+ *     phase plus two hyperperiods. If work is still pending at the end
+ *     (D > T, or U > 1) the number of hyperperiods is doubled until the
+ *     backlog clears or the default horizon is reached.
+ *
+ * Usage:
+ *   ./RTSched                                  interactive
+ *   ./RTSched generate <tasks> <utilization> [seed] [horizon]
+ *
+ * Sporadic tasks release with a minimum inter-arrival time T plus a
+ * random extra delay of up to T/2.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>    // For malloc(), rand_r()
+#include <string.h>    // For strcmp()
+#include <math.h>      // For pow(), log(), exp()
+#include <time.h>      // For clock_gettime()
+
+#define NEVER 0x7fffffffffffffffLL
+#define DEFAULT_HORIZON 10000000LL
+
+enum Policy { RM, EDF };
+const char *policyNames[] = { "RM", "EDF" };
+
+struct Task {
+    int id;
+    long long C, T, D, O; // WCET, period, relative deadline, phase
+    int sporadic;
+    int rank;             // RM priority: 0 is highest (shortest period)
+    long long rta;        // RM worst-case response time, -1 if > D
+
+    // Simulation
+    long long nextRelease;
+    long jobs, completed, missed;
+    long long worstResponse, maxLateness;
+    double sumResponse;
+};
+
+struct Job {
+    int task;
+    long long release, deadline, remaining;
+};
+
+struct Task *tasks;
+int numTasks;
+enum Policy policy;
+unsigned sporadicSeed;
+
+// --- Ready jobs (heap) and pending releases (heap of task ids) ---
+struct Job *ready;
+int numReady, readyCapacity;
+int *releases;
+int numReleases;
+
+long preemptions, events;
+
+/* ================================================================== */
+/*                        Analysis                                    */
+/* ================================================================== */
+
+static long long ceilDiv(long long a, long long b) {
+    return (a + b - 1) / b;
+}
+
+static long long gcd(long long a, long long b) {
+    while (b) {
+        long long t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/**
+ * lcm of all periods, or -1 if it exceeds 'limit'.
+ */
+long long hyperperiod(long long limit) {
+    long long h = 1;
+    for (int i = 0; i < numTasks; i++) {
+        long long g = gcd(h, tasks[i].T);
+        if (h / g > limit / tasks[i].T) return -1;
+        h = h / g * tasks[i].T;
+    }
+    return h;
+}
+
+static int compareRank(const void *a, const void *b) {
+    const struct Task *ta = &tasks[*(const int *)a], *tb = &tasks[*(const int *)b];
+    if (ta->T != tb->T) return ta->T < tb->T ? -1 : 1;
+    if (ta->D != tb->D) return ta->D < tb->D ? -1 : 1;
+    return ta->id - tb->id;
+}
+
+// Fixed point of w = own + sum over the first 'count' tasks in priority
+// order of ceil(w / T) * C, starting from 'start' (a lower bound). Stops
+// early once w exceeds 'limit'.
+static long long levelWindow(const int order[], int count, long long own, long long start, long long limit) {
+    long long w = start, previous = -1;
+    while (w != previous && w <= limit) {
+        previous = w;
+        w = own;
+        for (int h = 0; h < count; h++) {
+            const struct Task *hp = &tasks[order[h]];
+            w += ceilDiv(previous, hp->T) * hp->C;
+        }
+    }
+    return w;
+}
+
+/**
+ * Assigns RM priorities and computes each task's exact response time.
+ * Deadlines may exceed periods: when the first job is still running at
+ * its next release, every job q of the level-i busy period is checked
+ * (R = max over q of w(q) - q*T).
+ * @return 1 if every task meets its deadline under RM.
+ */
+int responseTimeAnalysis() {
+    int order[numTasks];
+    for (int i = 0; i < numTasks; i++) order[i] = i;
+    qsort(order, numTasks, sizeof(int), compareRank);
+    for (int r = 0; r < numTasks; r++) tasks[order[r]].rank = r;
+
+    // Start each iteration from a lower bound instead of C_i: R_i is at
+    // least R_(i-1) + C_i, and at least C_i / (1 - U_hp). Large task sets
+    // then converge in a few steps instead of thousands.
+    int schedulable = 1;
+    long long lastW = 0;
+    double higherU = 0;
+    for (int r = 0; r < numTasks; r++) {
+        struct Task *t = &tasks[order[r]];
+        double levelU = higherU + (double)t->C / t->T;
+        if (higherU >= 1.0) {
+            t->rta = -1;
+            schedulable = 0;
+            higherU = levelU;
+            continue;
+        }
+        long long w = lastW + t->C;
+        long long bound = (long long)(t->C / (1.0 - higherU));
+        if (bound > w) w = bound;
+        w = levelWindow(order, r, t->C, w, t->D);
+        lastW = w;
+        long long R = w;
+
+        // The next job arrives before this one finishes: the busy period
+        // spans several jobs, and it only ends if U up to this level <= 1
+        if (R <= t->D && w > t->T) {
+            if (levelU > 1.0 + 1e-12) {
+                R = -1;
+            } else {
+                long long L = levelWindow(order, r + 1, 0, w, DEFAULT_HORIZON * 1000);
+                for (long long q = 1; R >= 0 && q < ceilDiv(L, t->T); q++) {
+                    w = levelWindow(order, r, (q + 1) * t->C, w + t->C, t->D + q * t->T);
+                    if (w - q * t->T > R) R = w - q * t->T;
+                    if (R > t->D) R = -1;
+                }
+            }
+        }
+        t->rta = R >= 0 && R <= t->D ? R : -1;
+        if (t->rta < 0) schedulable = 0;
+        higherU = levelU;
+    }
+    return schedulable;
+}
+
+// Processor demand: work with both release and deadline inside [0, t]
+static long long demand(long long t) {
+    long long h = 0;
+    for (int i = 0; i < numTasks; i++) {
+        if (t >= tasks[i].D) h += ((t - tasks[i].D) / tasks[i].T + 1) * tasks[i].C;
+    }
+    return h;
+}
+
+// Largest absolute deadline strictly before t
+static long long deadlineBefore(long long t) {
+    long long best = 0;
+    for (int i = 0; i < numTasks; i++) {
+        if (t > tasks[i].D) {
+            long long d = (t - tasks[i].D - 1) / tasks[i].T * tasks[i].T + tasks[i].D;
+            if (d > best) best = d;
+        }
+    }
+    return best;
+}
+
+/**
+ * EDF feasibility. Exact for constrained deadlines (D <= T).
+ */
+int edfSchedulable(double U) {
+    if (U > 1.0 + 1e-12) return 0;
+    int implicitDeadlines = 1;
+    long long dMin = NEVER;
+    for (int i = 0; i < numTasks; i++) {
+        if (tasks[i].D < tasks[i].T) implicitDeadlines = 0;
+        if (tasks[i].D < dMin) dMin = tasks[i].D;
+    }
+    if (implicitDeadlines) return 1;
+
+    // Check up to the synchronous busy period: w = sum ceil(w / T) * C
+    long long L = 0, w = 0;
+    for (int i = 0; i < numTasks; i++) w += tasks[i].C;
+    while (w != L) {
+        L = w;
+        w = 0;
+        for (int i = 0; i < numTasks; i++) w += ceilDiv(L, tasks[i].T) * tasks[i].C;
+        if (w > DEFAULT_HORIZON * 1000) break; // U == 1 with D < T: give up on the bound
+    }
+
+    // QPA: walk backwards from L, jumping to h(t) when h(t) < t
+    long long t = deadlineBefore(L + 1);
+    while (1) {
+        long long h = demand(t);
+        if (h > t) return 0;
+        if (h <= dMin) return 1;
+        t = h < t ? h : deadlineBefore(t);
+    }
+}
+
+/* ================================================================== */
+/*                        Simulation                                  */
+/* ================================================================== */
+
+// Does job a run before job b under the current policy?
+static int higher(const struct Job *a, const struct Job *b) {
+    if (policy == EDF) {
+        if (a->deadline != b->deadline) return a->deadline < b->deadline;
+    } else {
+        if (tasks[a->task].rank != tasks[b->task].rank) return tasks[a->task].rank < tasks[b->task].rank;
+    }
+    if (a->release != b->release) return a->release < b->release;
+    return a->task < b->task;
+}
+
+static void readyPush(struct Job job) {
+    if (numReady == readyCapacity) {
+        readyCapacity = readyCapacity ? readyCapacity * 2 : 64;
+        ready = realloc(ready, readyCapacity * sizeof(struct Job));
+        if (ready == NULL) {
+            perror("realloc failed");
+            exit(1);
+        }
+    }
+    int i = numReady++;
+    ready[i] = job;
+    while (i > 0 && higher(&ready[i], &ready[(i - 1) / 2])) {
+        struct Job t = ready[i]; ready[i] = ready[(i - 1) / 2]; ready[(i - 1) / 2] = t;
+        i = (i - 1) / 2;
+    }
+}
+
+static struct Job readyPop() {
+    struct Job top = ready[0];
+    ready[0] = ready[--numReady];
+    int i = 0;
+    while (1) {
+        int l = 2 * i + 1, r = l + 1, best = i;
+        if (l < numReady && higher(&ready[l], &ready[best])) best = l;
+        if (r < numReady && higher(&ready[r], &ready[best])) best = r;
+        if (best == i) break;
+        struct Job t = ready[i]; ready[i] = ready[best]; ready[best] = t;
+        i = best;
+    }
+    return top;
+}
+
+static void releaseSift(int i) {
+    // Sift down from i in the release heap
+    while (1) {
+        int l = 2 * i + 1, r = l + 1, best = i;
+        if (l < numReleases && tasks[releases[l]].nextRelease < tasks[releases[best]].nextRelease) best = l;
+        if (r < numReleases && tasks[releases[r]].nextRelease < tasks[releases[best]].nextRelease) best = r;
+        if (best == i) break;
+        int t = releases[i]; releases[i] = releases[best]; releases[best] = t;
+        i = best;
+    }
+}
+
+static void recordCompletion(const struct Job *job, long long now) {
+    struct Task *t = &tasks[job->task];
+    long long response = now - job->release;
+    t->completed++;
+    t->sumResponse += response;
+    if (response > t->worstResponse) t->worstResponse = response;
+    if (now > job->deadline) {
+        t->missed++;
+        if (now - job->deadline > t->maxLateness) t->maxLateness = now - job->deadline;
+    }
+}
+
+/**
+ * Simulates [0, horizon) under 'p'. A job whose deadline passes keeps
+ * running (soft real-time) and counts as a miss when it completes.
+ * @return Work still pending at the horizon (the backlog).
+ */
+long long simulate(enum Policy p, long long horizon) {
+    policy = p;
+    numReady = 0;
+    numReleases = numTasks;
+    preemptions = events = 0;
+    unsigned seed = sporadicSeed;
+
+    for (int i = 0; i < numTasks; i++) {
+        struct Task *t = &tasks[i];
+        t->nextRelease = t->O;
+        t->jobs = t->completed = t->missed = 0;
+        t->worstResponse = t->maxLateness = 0;
+        t->sumResponse = 0;
+        releases[i] = i;
+    }
+    for (int i = numTasks / 2; i >= 0; i--) releaseSift(i);
+
+    int running = 0;      // Is 'current' valid?
+    struct Job current = { 0 };
+    long long now = 0;
+
+    while (1) {
+        long long tRelease = tasks[releases[0]].nextRelease;
+        long long tDone = running ? now + current.remaining : NEVER;
+        long long next = tDone <= tRelease ? tDone : tRelease;
+        // A completion exactly at the horizon still counts; a release does not
+        if (tDone <= tRelease ? tDone > horizon : tRelease >= horizon) {
+            if (running) current.remaining -= horizon - now;
+            now = horizon;
+            break;
+        }
+        events++;
+
+        if (running) current.remaining -= next - now;
+        now = next;
+
+        if (tDone <= tRelease) {
+            recordCompletion(&current, now);
+            running = 0;
+        } else {
+            // Release every job due now
+            while (tasks[releases[0]].nextRelease == now) {
+                struct Task *t = &tasks[releases[0]];
+                readyPush((struct Job){ t->id, now, now + t->D, t->C });
+                t->jobs++;
+                long long gap = t->T;
+                if (t->sporadic) gap += rand_r(&seed) % (t->T / 2 + 1);
+                t->nextRelease = now + gap;
+                releaseSift(0);
+            }
+            // Preempt if the best released job beats the running one
+            if (running && higher(&ready[0], &current)) {
+                readyPush(current);
+                running = 0;
+                preemptions++;
+            }
+        }
+
+        if (!running && numReady > 0) {
+            current = readyPop();
+            running = 1;
+        }
+    }
+
+    // Jobs still unfinished whose deadline has already passed
+    if (running) readyPush(current);
+    long long backlog = 0;
+    for (int i = 0; i < numReady; i++) {
+        if (ready[i].deadline <= now) tasks[ready[i].task].missed++;
+        backlog += ready[i].remaining;
+    }
+    return backlog;
+}
+
+/* ================================================================== */
+/*                        Reporting                                   */
+/* ================================================================== */
+
+static void printAnalysis(double U) {
+    int rmOk = responseTimeAnalysis();
+    int edfOk = edfSchedulable(U);
+    double bound = numTasks * (pow(2.0, 1.0 / numTasks) - 1);
+
+    printf("\n--- Schedulability analysis ---\n");
+    if (numTasks <= 32) {
+        printf("Task\tC\tT\tD\tO\tU\tRM rank\tRM R\n");
+        for (int i = 0; i < numTasks; i++) {
+            struct Task *t = &tasks[i];
+            printf("T%d%s\t%lld\t%lld\t%lld\t%lld\t%.3f\t%d\t", t->id, t->sporadic ? "*" : "",
+                   t->C, t->T, t->D, t->O, (double)t->C / t->T, t->rank);
+            if (t->rta >= 0) printf("%lld\n", t->rta);
+            else printf("> D (miss)\n");
+        }
+        printf("(* = sporadic)\n");
+    }
+    printf("Utilization U = %.4f, Liu-Layland RM bound = %.4f\n", U, bound);
+    printf("RM  (exact response-time analysis): %s\n", rmOk ? "SCHEDULABLE" : "NOT schedulable");
+    printf("EDF (%s): %s\n", U > 1 ? "U > 1" : "demand test", edfOk ? "SCHEDULABLE" : "NOT schedulable");
+}
+
+static void printSimulation(long long horizon, double wallSeconds) {
+    long jobs = 0, missed = 0;
+    printf("\n--- %s simulation over [0, %lld) ---\n", policyNames[policy], horizon);
+    if (numTasks <= 32) printf("Task\tJobs\tMissed\tWorst R\tAvg R\tMax lateness\n");
+    for (int i = 0; i < numTasks; i++) {
+        struct Task *t = &tasks[i];
+        jobs += t->jobs;
+        missed += t->missed;
+        if (numTasks <= 32) {
+            printf("T%d\t%ld\t%ld\t%lld\t%.2f\t%lld\n", t->id, t->jobs, t->missed, t->worstResponse,
+                   t->completed ? t->sumResponse / t->completed : 0.0, t->maxLateness);
+        }
+    }
+    printf("Jobs: %ld, deadline misses: %ld, preemptions: %ld, events: %ld\n",
+           jobs, missed, preemptions, events);
+    if (jobs >= 100000) printf("Simulated in %.3f s (%.0f jobs/s)\n", wallSeconds, jobs / wallSeconds);
+}
+
+static long totalMisses() {
+    long missed = 0;
+    for (int i = 0; i < numTasks; i++) missed += tasks[i].missed;
+    return missed;
+}
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Random task set: utilizations by UUniFast, periods log-uniform in
+ * [1000, 1000000] rounded to multiples of 100, D = T, no phase.
+ */
+static void generate(double U, unsigned seed) {
+    double sumU = U;
+    for (int i = 0; i < numTasks; i++) {
+        double u;
+        if (i < numTasks - 1) {
+            double next = sumU * pow(rand_r(&seed) / (RAND_MAX + 1.0), 1.0 / (numTasks - 1 - i));
+            u = sumU - next;
+            sumU = next;
+        } else {
+            u = sumU;
+        }
+        struct Task *t = &tasks[i];
+        t->id = i;
+        t->T = 100 * (long long)exp(log(10.0) + (log(10000.0) - log(10.0)) * (rand_r(&seed) / (RAND_MAX + 1.0)));
+        t->C = (long long)(u * t->T + 0.5);
+        if (t->C < 1) t->C = 1;
+        t->D = t->T;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    long long horizon = 0;
+    double U = 0;
+
+    if (argc >= 4 && strcmp(argv[1], "generate") == 0) {
+        numTasks = atoi(argv[2]);
+        double target = atof(argv[3]);
+        unsigned seed = argc >= 5 ? (unsigned)atoi(argv[4]) : 1;
+        horizon = argc >= 6 ? atoll(argv[5]) : 0;
+        if (numTasks < 1 || target <= 0) {
+            printf("Usage: %s generate <tasks> <utilization> [seed] [horizon]\n", argv[0]);
+            return 1;
+        }
+        tasks = calloc(numTasks, sizeof(struct Task));
+        if (tasks == NULL) {
+            perror("calloc failed");
+            return 1;
+        }
+        generate(target, seed);
+    } else {
+        printf("Enter number of Tasks:\n");
+        if (scanf("%d", &numTasks) != 1 || numTasks < 1) return 1;
+        tasks = calloc(numTasks, sizeof(struct Task));
+        if (tasks == NULL) {
+            perror("calloc failed");
+            return 1;
+        }
+        for (int i = 0; i < numTasks; i++) {
+            struct Task *t = &tasks[i];
+            t->id = i;
+            printf("Enter C T D(0 = T) phase sporadic(0/1) for Task %d: ", i);
+            if (scanf("%lld %lld %lld %lld %d", &t->C, &t->T, &t->D, &t->O, &t->sporadic) != 5) return 1;
+            if (t->C < 1 || t->T < 1 || t->O < 0) {
+                printf("C and T must be positive, phase non-negative.\n");
+                return 1;
+            }
+            if (t->D <= 0) t->D = t->T;
+        }
+        printf("Enter simulation horizon (0 = one hyperperiod):\n");
+        if (scanf("%lld", &horizon) != 1) return 1;
+    }
+
+    int anySporadic = 0;
+    long long maxPhase = 0;
+    for (int i = 0; i < numTasks; i++) {
+        U += (double)tasks[i].C / tasks[i].T;
+        if (tasks[i].sporadic) anySporadic = 1;
+        if (tasks[i].O > maxPhase) maxPhase = tasks[i].O;
+    }
+    printAnalysis(U);
+
+    long long h = -1; // Set when the horizon is derived from the hyperperiod
+    if (horizon <= 0) {
+        h = hyperperiod(DEFAULT_HORIZON);
+        if (anySporadic || h < 0) {
+            h = -1;
+            horizon = DEFAULT_HORIZON;
+            printf("\nHyperperiod %s; simulating the default horizon of %lld.\n",
+                   anySporadic ? "undefined (sporadic tasks)" : "too large", horizon);
+        } else {
+            // With phases the pattern settles after the largest phase
+            horizon = maxPhase ? maxPhase + 2 * h : h;
+            printf("\nHyperperiod: %lld\n", h);
+        }
+    }
+
+    releases = malloc(numTasks * sizeof(int));
+    if (releases == NULL) {
+        perror("malloc failed");
+        return 1;
+    }
+    sporadicSeed = 12345;
+    for (int p = RM; p <= EDF; p++) {
+        // Work left over at the end of the hyperperiods carries into the
+        // next ones, so the schedule has not settled yet: double the
+        // number of hyperperiods until the backlog clears
+        long long periods = maxPhase ? 2 : 1, length = horizon;
+        double start = nowSeconds();
+        long long backlog = simulate((enum Policy)p, length);
+        while (backlog > 0 && h > 0 && maxPhase + 2 * periods * h <= DEFAULT_HORIZON &&
+               !(U > 1 && totalMisses() > 0)) {
+            periods *= 2;
+            length = maxPhase + periods * h;
+            start = nowSeconds();
+            backlog = simulate((enum Policy)p, length);
+        }
+        printSimulation(length, nowSeconds() - start);
+        if (backlog > 0 && h > 0) {
+            printf("Backlog of %lld units still pending at %lld: it %s.\n", backlog, length,
+                   U > 1 ? "grows every hyperperiod (U > 1)" : "has not cleared yet");
+        }
+    }
+    return 0;
+}
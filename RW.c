@@ -3,31 +3,104 @@
  * (Readers-Priority Solution)
  *
  * This program uses pthreads and POSIX semaphores.
+ *
+ * Instrumentation: every thread records, for each access, when it asked
+ * for the lock, when it got it and when it let go. Timestamps come from
+ * the CPU's time-stamp counter (rdtsc), and each thread writes only its
+ * OWN ring buffer, so recording takes no locks and barely moves the
+ * timings. At exit we print per-thread wait/hold totals and histograms,
+ * and can write a Chrome trace (open it in chrome://tracing or Perfetto)
+ * that shows convoys and starving writers on a timeline.
+ *
+ * Usage: ./RW [trace.json] [rounds]
+ *        rounds = accesses per thread (default 1)
  */
 
 // STEP 1: Include all necessary libraries
 #include <stdio.h>
 #include <pthread.h>  // For creating and managing threads
 #include <semaphore.h> // For using semaphores (the locks)
+#include "oskernels.h" // For the readers-priority lock (struct OskRwLock)
 #include <unistd.h>  // For using the sleep() function
 #include <stdlib.h>  // For exit()
+#include "perfprof.h" // For perfPhase(): PERFPROF=1 prints counters per phase
+#include <stdint.h>  // For uint64_t
+#include <time.h>    // For clock_gettime(), to calibrate the counter
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> // For __rdtsc()
+#endif
 
-// STEP 2: Define global semaphores and shared variables
-sem_t wrt;            // Semaphore for "write" access. Blocks writers AND first reader.
-sem_t mutex;          // Semaphore for "mutex" (mutual exclusion)
-                      // Its ONLY job is to protect the 'read_count' variable.
-int read_count = 0;   // Counts how many readers are currently in the critical section.
+// STEP 2: Define the lock and shared variables
+// The lock (see oskernels.c for its entry/exit sections) holds:
+//   wrt        semaphore for "write" access. Blocks writers AND first reader.
+//   mutex      its ONLY job is to protect readCount.
+//   readCount  how many readers are currently in the critical section.
+struct OskRwLock rw;
 int shared_data = 1;  // The shared resource we are reading/writing.
+int rounds = 1;       // How many times each thread reads/writes.
+
+// STEP 2b: Instrumentation data (one ThreadLog per thread, no sharing)
+#define RING_SIZE 256   // Accesses kept per thread (oldest overwritten)
+#define HIST_BUCKETS 32 // log2 buckets: <1us, 1-2us, 2-4us, ...
+
+struct LockEvent {
+    uint64_t request;  // Asked for the lock
+    uint64_t acquired; // Entered the critical section
+    uint64_t released; // Left the exit section
+};
+
+struct ThreadLog {
+    int id;                  // Simple ID (1, 2, ...)
+    int isWriter;
+    unsigned long count;     // Accesses recorded (may exceed RING_SIZE)
+    struct LockEvent ring[RING_SIZE];
+};
+
+double ticks_per_us = 1;     // Calibrated in main()
+uint64_t start_ticks;
 
 // --- Function Prototypes ---
 void *writer(void *arg);
 void *reader(void *arg);
+void report(struct ThreadLog logs[], int count);
+void writeChromeTrace(const char *path, struct ThreadLog logs[], int count);
+
+// Reads the time-stamp counter (or a nanosecond clock elsewhere)
+static inline uint64_t read_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+#endif
+}
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Measures how many counter ticks make one microsecond
+static void calibrate_ticks(void) {
+    double t0 = now_us();
+    uint64_t c0 = read_ticks();
+    while (now_us() - t0 < 20000) {
+        // Spin for 20 ms
+    }
+    ticks_per_us = (read_ticks() - c0) / (now_us() - t0);
+}
 
 // STEP 5: The main() function
-int main() {
+int main(int argc, char *argv[]) {
     int num_readers, num_writers;
+    const char *trace_path = argc >= 2 ? argv[1] : NULL;
+    if (argc >= 3) rounds = atoi(argv[2]);
+    if (rounds < 1) rounds = 1;
 
     // Get user input for the number of threads
+    perfPhase("input");
     printf("Enter number of Readers: ");
     scanf("%d", &num_readers);
     printf("Enter number of Writers: ");
@@ -37,40 +110,43 @@ int main() {
     pthread_t reader_threads[num_readers];
     pthread_t writer_threads[num_writers];
 
-    // Arrays to hold the simple IDs (1, 2, 3...) for our threads
-    int reader_ids[num_readers];
-    int writer_ids[num_writers];
-
-    // STEP 6: Initialize the semaphores
-    // sem_init(&semaphore_name, 0 (share between threads), initial_value);
-    
-    // 'wrt' starts at 1 (unlocked), allowing one Writer or the first Reader.
-    if (sem_init(&wrt, 0, 1) == -1) {
-        perror("sem_init wrt failed");
+    perfPhase("setup"); // Includes the 20 ms counter calibration
+    // One log per thread (writers first), holding its simple ID (1, 2, 3...)
+    struct ThreadLog *logs = calloc(num_writers + num_readers, sizeof(struct ThreadLog));
+    if (logs == NULL) {
+        perror("calloc logs failed");
         exit(1);
     }
-    // 'mutex' starts at 1 (unlocked), protecting 'read_count'.
-    if (sem_init(&mutex, 0, 1) == -1) {
-        perror("sem_init mutex failed");
+    struct ThreadLog *writer_logs = logs;
+    struct ThreadLog *reader_logs = logs + num_writers;
+    calibrate_ticks();
+    start_ticks = read_ticks();
+
+    // STEP 6: Initialize the semaphores
+    // Both 'wrt' and 'mutex' start at 1 (unlocked).
+    if (oskRwInit(&rw) == -1) {
+        perror("sem_init failed");
         exit(1);
     }
 
     printf("\n--- Simulation Starting ---\n");
+    perfPhase("run"); // All threads, counted as they exit
 
     // STEP 7: Create all the Writer threads
     for (int i = 0; i < num_writers; i++) {
-        writer_ids[i] = i + 1; // Give it a simple ID (1, 2, ...)
-        // Create the thread, passing it the writer() function and its ID
-        if (pthread_create(&writer_threads[i], NULL, writer, &writer_ids[i]) != 0) {
+        writer_logs[i].id = i + 1; // Give it a simple ID (1, 2, ...)
+        writer_logs[i].isWriter = 1;
+        // Create the thread, passing it the writer() function and its log
+        if (pthread_create(&writer_threads[i], NULL, writer, &writer_logs[i]) != 0) {
             perror("pthread_create writer failed");
         }
     }
 
     // STEP 8: Create all the Reader threads
     for (int i = 0; i < num_readers; i++) {
-        reader_ids[i] = i + 1; // Give it a simple ID (1, 2, ...)
-        // Create the thread, passing it the reader() function and its ID
-        if (pthread_create(&reader_threads[i], NULL, reader, &reader_ids[i]) != 0) {
+        reader_logs[i].id = i + 1; // Give it a simple ID (1, 2, ...)
+        // Create the thread, passing it the reader() function and its log
+        if (pthread_create(&reader_threads[i], NULL, reader, &reader_logs[i]) != 0) {
             perror("pthread_create reader failed");
         }
     }
@@ -86,9 +162,16 @@ int main() {
 
     printf("\n--- Simulation Finished ---\n");
 
+    // STEP 9b: Aggregate the logs (all threads are done, nothing is shared now)
+    perfPhase("report");
+    report(logs, num_writers + num_readers);
+    if (trace_path != NULL) {
+        writeChromeTrace(trace_path, logs, num_writers + num_readers);
+    }
+    free(logs);
+
     // STEP 10: Clean up and destroy the semaphores
-    sem_destroy(&wrt);
-    sem_destroy(&mutex);
+    oskRwDestroy(&rw);
 
     return 0;
 }
@@ -96,27 +179,36 @@ int main() {
 // STEP 3: The Writer Thread Function
 // This function will be executed by all writer threads.
 void *writer(void *arg) {
-    int writer_id = *(int *)arg; // Get the writer's ID
-
-    // Simulate the writer working, then trying to access the resource
-    sleep(rand() % 3); 
-    printf("[Writer %d] is trying to write.\n", writer_id);
-
-    // --- Entry Section ---
-    // A writer must wait for the 'wrt' lock.
-    // If a reader (or another writer) has it, it will wait here.
-    sem_wait(&wrt);
-
-    // --- Critical Section ---
-    // The writer has the lock, no one else can be here.
-    printf(">>> [Writer %d] is WRITING... <<<\n", writer_id);
-    shared_data++; // Modify the shared data
-    sleep(1);      // Simulate the time it takes to write
-    printf(">>> [Writer %d] finished. Shared data is now: %d <<<\n", writer_id, shared_data);
-    
-    // --- Exit Section ---
-    // Release the 'wrt' lock, allowing others to enter.
-    sem_post(&wrt);
+    struct ThreadLog *log = arg;   // This thread's own log
+    int writer_id = log->id;       // Get the writer's ID
+
+    for (int round = 0; round < rounds; round++) {
+        struct LockEvent *event = &log->ring[log->count % RING_SIZE];
+
+        // Simulate the writer working, then trying to access the resource
+        sleep(rand() % 3);
+        printf("[Writer %d] is trying to write.\n", writer_id);
+
+        // --- Entry Section ---
+        // A writer must wait for the 'wrt' lock.
+        // If a reader (or another writer) has it, it will wait here.
+        event->request = read_ticks();
+        oskWriteEnter(&rw);
+        event->acquired = read_ticks();
+
+        // --- Critical Section ---
+        // The writer has the lock, no one else can be here.
+        printf(">>> [Writer %d] is WRITING... <<<\n", writer_id);
+        shared_data++; // Modify the shared data
+        sleep(1);      // Simulate the time it takes to write
+        printf(">>> [Writer %d] finished. Shared data is now: %d <<<\n", writer_id, shared_data);
+
+        // --- Exit Section ---
+        // Release the 'wrt' lock, allowing others to enter.
+        oskWriteExit(&rw);
+        event->released = read_ticks();
+        log->count++;
+    }
 
     return NULL;
 }
@@ -124,53 +216,159 @@ void *writer(void *arg) {
 // STEP 4: The Reader Thread Function
 // This function will be executed by all reader threads.
 void *reader(void *arg) {
-    int reader_id = *(int *)arg; // Get the reader's ID
-
-    // Simulate the reader working, then trying to access the resource
-    sleep(rand() % 3);
-    printf("[Reader %d] is trying to read.\n", reader_id);
-
-    // --- Entry Section ---
-    // 1. Lock 'mutex' to protect 'read_count'
-    sem_wait(&mutex);
-    read_count++; // Increment the count of readers
-
-    // 2. Check if this is the FIRST reader
-    if (read_count == 1) {
-        // If it is, it must also grab the 'wrt' lock
-        // This blocks any waiting WRITERS from entering
-        printf("[Reader %d] is the first reader, locking 'wrt' for writers.\n", reader_id);
-        sem_wait(&wrt);
-    }
-
-    // 3. Release 'mutex'.
-    // This is vital! It allows OTHER READERS to enter
-    // while this first reader keeps 'wrt' locked.
-    sem_post(&mutex);
-
-    // --- Critical Section ---
-    // Multiple readers can be in this section at the same time.
-    printf("[Reader %d] is READING. (Total Readers: %d). Shared data is: %d\n", 
-           reader_id, read_count, shared_data);
-    sleep(1); // Simulate the time it takes to read
-    
-    // --- Exit Section ---
-    // 4. Lock 'mutex' again to protect 'read_count'
-    sem_wait(&mutex);
-    read_count--; // Decrement the count of readers
-
-    // 5. Check if this is the LAST reader
-    if (read_count == 0) {
-        // If it is, it must release the 'wrt' lock,
-        // allowing a waiting WRITER to finally enter.
-        printf("[Reader %d] is the last reader, unlocking 'wrt' for writers.\n", reader_id);
-        sem_post(&wrt);
-    }
-
-    // 6. Release 'mutex'
-    sem_post(&mutex);
-    
-    printf("[Reader %d] has finished reading.\n", reader_id);
+    struct ThreadLog *log = arg;   // This thread's own log
+    int reader_id = log->id;       // Get the reader's ID
+
+    for (int round = 0; round < rounds; round++) {
+        struct LockEvent *event = &log->ring[log->count % RING_SIZE];
+
+        // Simulate the reader working, then trying to access the resource
+        sleep(rand() % 3);
+        printf("[Reader %d] is trying to read.\n", reader_id);
+
+        // --- Entry Section ---
+        // 1. Lock 'mutex' and increment the count of readers
+        // 2. The FIRST reader also grabs the 'wrt' lock, which blocks
+        //    any waiting WRITERS from entering
+        // 3. Release 'mutex', so OTHER READERS can enter while the first
+        //    reader keeps 'wrt' locked
+        event->request = read_ticks();
+        bool first = oskReadEnter(&rw);
+        event->acquired = read_ticks();
+        if (first) {
+            printf("[Reader %d] is the first reader, locked 'wrt' for writers.\n", reader_id);
+        }
+
+        // --- Critical Section ---
+        // Multiple readers can be in this section at the same time.
+        printf("[Reader %d] is READING. (Total Readers: %d). Shared data is: %d\n",
+               reader_id, rw.readCount, shared_data);
+        sleep(1); // Simulate the time it takes to read
+
+        // --- Exit Section ---
+        // 4. Lock 'mutex' again and decrement the count of readers
+        // 5. The LAST reader releases the 'wrt' lock, allowing a
+        //    waiting WRITER to finally enter
+        // 6. Release 'mutex'
+        bool last = oskReadExit(&rw);
+        event->released = read_ticks();
+        log->count++;
+        if (last) {
+            printf("[Reader %d] was the last reader, unlocked 'wrt' for writers.\n", reader_id);
+        }
+
+        printf("[Reader %d] has finished reading.\n", reader_id);
+    }
 
     return NULL;
-}
\ No newline at end of file
+}
+
+// STEP 11: Turn the raw logs into numbers
+
+// Bucket of a duration: 0 = under 1us, k = [2^(k-1), 2^k) us
+static int bucket_of(double us) {
+    int k = 0;
+    while (us >= 1 && k < HIST_BUCKETS - 1) {
+        us /= 2;
+        k++;
+    }
+    return k;
+}
+
+static void print_histogram(const char *title, const unsigned long hist[]) {
+    unsigned long peak = 0, total = 0;
+    for (int k = 0; k < HIST_BUCKETS; k++) {
+        if (hist[k] > peak) peak = hist[k];
+        total += hist[k];
+    }
+    printf("\n%s (%lu samples)\n", title, total);
+    if (total == 0) return;
+    for (int k = 0; k < HIST_BUCKETS; k++) {
+        if (hist[k] == 0) continue;
+        double low = k == 0 ? 0 : (double)(1ul << (k - 1));
+        printf("  %10.0f us+ | %-40.*s %lu\n", low, (int)(40 * hist[k] / peak),
+               "########################################", hist[k]);
+    }
+}
+
+/**
+ * Prints one line per thread (acquisitions, total/max wait, total hold)
+ * and wait/hold histograms for readers and writers.
+ */
+void report(struct ThreadLog logs[], int count) {
+    unsigned long wait_hist[2][HIST_BUCKETS] = {{0}}, hold_hist[2][HIST_BUCKETS] = {{0}};
+    double max_wait[2] = {0, 0}, sum_wait[2] = {0, 0};
+    unsigned long samples[2] = {0, 0};
+
+    printf("\n--- Lock Instrumentation (%.0f ticks/us) ---\n", ticks_per_us);
+    printf("%-8s %4s %6s %14s %14s %14s\n", "Thread", "ID", "Count", "Wait(ms)", "MaxWait(ms)", "Hold(ms)");
+    for (int t = 0; t < count; t++) {
+        struct ThreadLog *log = &logs[t];
+        int role = log->isWriter;
+        unsigned long kept = log->count < RING_SIZE ? log->count : RING_SIZE;
+        double wait = 0, hold = 0, worst = 0;
+        for (unsigned long e = 0; e < kept; e++) {
+            struct LockEvent *event = &log->ring[e];
+            double w = (event->acquired - event->request) / ticks_per_us;
+            double h = (event->released - event->acquired) / ticks_per_us;
+            wait += w;
+            hold += h;
+            if (w > worst) worst = w;
+            wait_hist[role][bucket_of(w)]++;
+            hold_hist[role][bucket_of(h)]++;
+        }
+        if (worst > max_wait[role]) max_wait[role] = worst;
+        sum_wait[role] += wait;
+        samples[role] += kept;
+        printf("%-8s %4d %6lu %14.3f %14.3f %14.3f\n", role ? "Writer" : "Reader", log->id,
+               log->count, wait / 1e3, worst / 1e3, hold / 1e3);
+    }
+
+    print_histogram("Reader wait", wait_hist[0]);
+    print_histogram("Writer wait", wait_hist[1]);
+    print_histogram("Reader hold", hold_hist[0]);
+    print_histogram("Writer hold", hold_hist[1]);
+
+    // Readers-priority starves writers: compare how long each side waits
+    if (samples[0] && samples[1]) {
+        printf("\nMean wait: readers %.3f ms, writers %.3f ms; worst writer wait %.3f ms\n",
+               sum_wait[0] / samples[0] / 1e3, sum_wait[1] / samples[1] / 1e3, max_wait[1] / 1e3);
+    }
+}
+
+/**
+ * Writes the logs as a Chrome trace: per access, a "wait" slice followed
+ * by a "READ"/"WRITE" slice, one timeline row per thread.
+ */
+void writeChromeTrace(const char *path, struct ThreadLog logs[], int count) {
+    FILE *out = fopen(path, "w");
+    if (out == NULL) {
+        perror("fopen trace failed");
+        return;
+    }
+    fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    int first = 1;
+    for (int t = 0; t < count; t++) {
+        struct ThreadLog *log = &logs[t];
+        const char *role = log->isWriter ? "Writer" : "Reader";
+        fprintf(out, "%s{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": %d, "
+                     "\"args\": {\"name\": \"%s %d\"}}", first ? "" : ",\n", t + 1, role, log->id);
+        first = 0;
+
+        unsigned long kept = log->count < RING_SIZE ? log->count : RING_SIZE;
+        for (unsigned long e = 0; e < kept; e++) {
+            struct LockEvent *event = &log->ring[e];
+            double request = (event->request - start_ticks) / ticks_per_us;
+            double acquired = (event->acquired - start_ticks) / ticks_per_us;
+            double released = (event->released - start_ticks) / ticks_per_us;
+            fprintf(out, ",\n{\"ph\": \"X\", \"name\": \"wait\", \"cat\": \"rw\", \"pid\": 1, "
+                         "\"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}", t + 1, request, acquired - request);
+            fprintf(out, ",\n{\"ph\": \"X\", \"name\": \"%s\", \"cat\": \"rw\", \"pid\": 1, "
+                         "\"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}", log->isWriter ? "WRITE" : "READ",
+                    t + 1, acquired, released - acquired);
+        }
+    }
+    fprintf(out, "\n]}\n");
+    fclose(out);
+    printf("Chrome trace written to %s\n", path);
+}
@@ -0,0 +1,351 @@
+/*
+ * Readers-Writers with an ASYNC lock: 100k clients, a handful of threads.
+ *
+ * RW.c gives every reader and writer its own pthread, and a waiting
+ * client blocks that thread in sem_wait(). That does not scale: 100k
+ * clients would mean 100k OS threads and 100k stacks.
+ *
+ * Here a client is a TASK: a small struct with a "where was I" state,
+ * run by a pool of a few worker threads. When a task cannot get the lock
+ * it does not block the thread. It is parked on the lock's wait queue
+ * (SUSPENDED), the function returns, and the worker runs another task.
+ * On release, the lock is HANDED OVER to the next waiters and they are
+ * put back on the run queue in ONE batch: either one writer, or every
+ * reader at the head of the queue at once.
+ *
+ * The queue is FIFO, so a stream of readers cannot starve a writer (with
+ * 100k clients, RW.c's readers-priority rule would starve them forever).
+ *
+ * Every client does `rounds` iterations of: acquire, enter, YIELD while
+ * holding the lock (the async version of RW.c's sleep(1) inside the
+ * critical section), leave, release, yield. We check the rules (no
+ * writer next to anyone else) and that readers never see a half-done
+ * write (a writer updates its two halves before and after its yield).
+ *
+ * Usage: ./RWAsync                                   (prompts like RW.c)
+ *        ./RWAsync readers writers [workers] [rounds]
+ */
+
+// STEP 1: Include all necessary libraries
+#include <stdio.h>
+#include <stdlib.h>   // For malloc(), exit(), atoi()
+#include <stdbool.h>  // For bool
+#include <pthread.h>  // For the worker threads
+#include <time.h>     // For clock_gettime()
+
+#define DEFAULT_WORKERS 4
+#define DEFAULT_ROUNDS 10
+
+// STEP 2: Tasks, the async lock and the run queue
+
+enum Role { READER, WRITER };
+enum Step { ACQUIRE, HOLDING, LEAVING, DONE };
+
+struct Task {
+    int id;
+    enum Role role;
+    enum Step step;   // Where to continue when the task runs again
+    int roundsLeft;
+    double waitStart; // When it was suspended on the lock
+    struct Task *next; // Link in the run queue or the lock's wait queue
+};
+
+struct AsyncRWLock {
+    pthread_mutex_t mutex; // Protects the fields below (held only briefly)
+    int readers;           // Readers inside the critical section
+    bool writer;           // A writer is inside
+    struct Task *head, *tail; // Suspended tasks, FIFO
+};
+
+struct RunQueue {
+    pthread_mutex_t mutex;
+    pthread_cond_t nonEmpty;
+    struct Task *head, *tail;
+    bool closed;
+};
+
+static struct AsyncRWLock rw = { PTHREAD_MUTEX_INITIALIZER, 0, false, NULL, NULL };
+static struct RunQueue runQueue = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+                                    NULL, NULL, false };
+
+// The shared resource: writers keep both halves equal
+static volatile long sharedA = 0, sharedB = 0;
+
+// Statistics (atomics: several workers update them)
+static long inside = 0;          // Writers count as 1 << 20, readers as 1
+static long violations = 0, torn = 0;
+static long maxReaders = 0;
+static long suspensions = 0, batches = 0, resumed = 0;
+static double waitSeconds = 0;   // Protected by rw.mutex
+static long tasksLeft;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// --- Run queue ---
+
+// Appends a chain of tasks (first..last) with one lock operation
+static void scheduleBatch(struct Task *first, struct Task *last) {
+    pthread_mutex_lock(&runQueue.mutex);
+    last->next = NULL;
+    if (runQueue.tail) {
+        runQueue.tail->next = first;
+    } else {
+        runQueue.head = first;
+    }
+    runQueue.tail = last;
+    pthread_cond_broadcast(&runQueue.nonEmpty);
+    pthread_mutex_unlock(&runQueue.mutex);
+}
+
+// Takes the next task, or NULL once the queue is closed and empty
+static struct Task *nextTask(void) {
+    pthread_mutex_lock(&runQueue.mutex);
+    while (!runQueue.head && !runQueue.closed) {
+        pthread_cond_wait(&runQueue.nonEmpty, &runQueue.mutex);
+    }
+    struct Task *t = runQueue.head;
+    if (t) {
+        runQueue.head = t->next;
+        if (!runQueue.head) runQueue.tail = NULL;
+    }
+    pthread_mutex_unlock(&runQueue.mutex);
+    return t;
+}
+
+// --- The async lock ---
+
+/**
+ * Tries to enter. On success the task continues at once; otherwise it is
+ * parked on the wait queue and will be resumed (already holding the lock)
+ * by a later release.
+ * @return true if the lock was acquired, false if the task is suspended.
+ */
+static bool acquire(struct Task *t) {
+    pthread_mutex_lock(&rw.mutex);
+    // FIFO: nobody passes a task that is already waiting
+    bool available = t->role == READER ? !rw.writer && !rw.head
+                                  : !rw.writer && rw.readers == 0 && !rw.head;
+    if (available) {
+        if (t->role == READER) {
+            rw.readers++;
+        } else {
+            rw.writer = true;
+        }
+        pthread_mutex_unlock(&rw.mutex);
+        return true;
+    }
+    t->waitStart = nowSeconds();
+    t->next = NULL;
+    if (rw.tail) {
+        rw.tail->next = t;
+    } else {
+        rw.head = t;
+    }
+    rw.tail = t;
+    suspensions++;
+    pthread_mutex_unlock(&rw.mutex);
+    return false;
+}
+
+/**
+ * Leaves the critical section. If the lock becomes free, it is handed to
+ * the next writer, or to ALL readers at the head of the wait queue, and
+ * they are resumed as one batch.
+ */
+static void release(struct Task *t) {
+    pthread_mutex_lock(&rw.mutex);
+    if (t->role == READER) {
+        rw.readers--;
+    } else {
+        rw.writer = false;
+    }
+
+    struct Task *first = NULL, *last = NULL;
+    if (!rw.writer && rw.readers == 0 && rw.head) {
+        double now = nowSeconds();
+        first = rw.head;
+        if (first->role == WRITER) {
+            rw.writer = true;
+            last = first;
+        } else {
+            last = first;
+            rw.readers++;
+            while (last->next && last->next->role == READER) {
+                last = last->next;
+                rw.readers++;
+            }
+        }
+        rw.head = last->next;
+        if (!rw.head) rw.tail = NULL;
+        for (struct Task *w = first;; w = w->next) {
+            waitSeconds += now - w->waitStart;
+            resumed++;
+            if (w == last) break;
+        }
+        batches++;
+    }
+    pthread_mutex_unlock(&rw.mutex);
+    if (first) scheduleBatch(first, last);
+}
+
+// STEP 3: One step of a client. Runs until it suspends, yields or ends.
+
+// Entry into the critical section: check nobody breaks the rules
+static void enterCritical(struct Task *t) {
+    if (t->role == WRITER) {
+        long now = __atomic_add_fetch(&inside, 1L << 20, __ATOMIC_SEQ_CST);
+        if (now != 1L << 20) __atomic_add_fetch(&violations, 1, __ATOMIC_RELAXED);
+        sharedA++; // First half of the write...
+    } else {
+        long now = __atomic_add_fetch(&inside, 1, __ATOMIC_SEQ_CST);
+        if (now >= 1L << 20) __atomic_add_fetch(&violations, 1, __ATOMIC_RELAXED);
+        long seen = __atomic_load_n(&maxReaders, __ATOMIC_RELAXED);
+        while (now > seen && !__atomic_compare_exchange_n(&maxReaders, &seen, now, false,
+                                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        }
+    }
+}
+
+static void leaveCritical(struct Task *t) {
+    if (t->role == WRITER) {
+        sharedB++; // ...and the second half, after yielding in between
+        __atomic_sub_fetch(&inside, 1L << 20, __ATOMIC_SEQ_CST);
+    } else {
+        if (sharedA != sharedB) __atomic_add_fetch(&torn, 1, __ATOMIC_RELAXED);
+        __atomic_sub_fetch(&inside, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+static void runTask(struct Task *t) {
+    switch (t->step) {
+    case ACQUIRE:
+        t->step = HOLDING; // Where we continue, now or when resumed
+        if (!acquire(t)) return; // Suspended; release() will resume us
+        // fall through
+    case HOLDING:
+        // Like the sleep(1) in RW.c: stay inside while others run.
+        // Yielding (not blocking) keeps the worker thread free.
+        enterCritical(t);
+        t->step = LEAVING;
+        scheduleBatch(t, t);
+        return;
+    case LEAVING:
+        leaveCritical(t);
+        release(t);
+        if (--t->roundsLeft > 0) {
+            // Yield: go to the back of the run queue for the next round
+            t->step = ACQUIRE;
+            scheduleBatch(t, t);
+            return;
+        }
+        t->step = DONE;
+        if (__atomic_sub_fetch(&tasksLeft, 1, __ATOMIC_ACQ_REL) == 0) {
+            pthread_mutex_lock(&runQueue.mutex);
+            runQueue.closed = true;
+            pthread_cond_broadcast(&runQueue.nonEmpty);
+            pthread_mutex_unlock(&runQueue.mutex);
+        }
+        return;
+    case DONE:
+        return;
+    }
+}
+
+static void *worker(void *arg) {
+    long *ran = arg;
+    struct Task *t;
+    while ((t = nextTask()) != NULL) {
+        runTask(t);
+        (*ran)++;
+    }
+    return NULL;
+}
+
+// STEP 4: The main() function
+int main(int argc, char *argv[]) {
+    int numReaders, numWriters;
+    int numWorkers = DEFAULT_WORKERS, rounds = DEFAULT_ROUNDS;
+
+    if (argc >= 3) {
+        numReaders = atoi(argv[1]);
+        numWriters = atoi(argv[2]);
+        if (argc >= 4) numWorkers = atoi(argv[3]);
+        if (argc >= 5) rounds = atoi(argv[4]);
+    } else {
+        // Get user input for the number of clients, like RW.c
+        printf("Enter number of Readers: ");
+        if (scanf("%d", &numReaders) != 1) return 1;
+        printf("Enter number of Writers: ");
+        if (scanf("%d", &numWriters) != 1) return 1;
+    }
+    if (numReaders < 0 || numWriters < 0 || numReaders + numWriters == 0 ||
+        numWorkers <= 0 || rounds <= 0) {
+        fprintf(stderr, "Usage: %s readers writers [workers] [rounds]\n", argv[0]);
+        return 1;
+    }
+
+    // STEP 5: Create the tasks, interleaving writers among the readers
+    int n = numReaders + numWriters;
+    struct Task *tasks = calloc(n, sizeof(struct Task));
+    if (!tasks) {
+        perror("Allocation failed");
+        exit(1);
+    }
+    long writersPlaced = 0;
+    for (int i = 0; i < n; i++) {
+        bool isWriter = writersPlaced < (long)numWriters * (i + 1) / n;
+        if (isWriter) writersPlaced++;
+        tasks[i] = (struct Task){ .id = i + 1, .role = isWriter ? WRITER : READER,
+                                  .step = ACQUIRE, .roundsLeft = rounds };
+        tasks[i].next = i + 1 < n ? &tasks[i + 1] : NULL;
+    }
+    tasksLeft = n;
+
+    printf("\n--- Simulation Starting: %d readers, %d writers, %d rounds, %d worker threads ---\n",
+           numReaders, numWriters, rounds, numWorkers);
+
+    // STEP 6: Start the pool; every task begins on the run queue
+    double start = nowSeconds();
+    scheduleBatch(&tasks[0], &tasks[n - 1]);
+    pthread_t threads[numWorkers];
+    long ran[numWorkers];
+    for (int i = 0; i < numWorkers; i++) {
+        ran[i] = 0;
+        if (pthread_create(&threads[i], NULL, worker, &ran[i]) != 0) {
+            perror("pthread_create worker failed");
+            exit(1);
+        }
+    }
+    for (int i = 0; i < numWorkers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = nowSeconds() - start;
+
+    // STEP 7: Report
+    long operations = (long)n * rounds;
+    printf("\n--- Simulation Finished ---\n");
+    printf("Lock operations:    %ld in %.3f s (%.0f per second)\n", operations, elapsed,
+           operations / elapsed);
+    printf("Shared data:        %ld (expected %ld)\n", sharedA, (long)numWriters * rounds);
+    printf("Suspensions:        %ld (%.1f%% of acquisitions)\n", suspensions,
+           100.0 * suspensions / operations);
+    printf("Resume batches:     %ld (%.1f tasks per batch)\n", batches,
+           batches ? (double)resumed / batches : 0.0);
+    printf("Average wait:       %.2f us per suspension\n",
+           suspensions ? waitSeconds / suspensions * 1e6 : 0.0);
+    printf("Max readers inside: %ld\n", maxReaders);
+    printf("Memory per client:  %zu bytes (a pthread reserves a whole stack)\n", sizeof(struct Task));
+    for (int i = 0; i < numWorkers; i++) {
+        printf("Worker %d ran %ld task steps\n", i + 1, ran[i]);
+    }
+    if (violations || torn || sharedA != (long)numWriters * rounds) {
+        printf("ERROR: %ld exclusion violations, %ld torn reads\n", violations, torn);
+        return 1;
+    }
+    free(tasks);
+    return 0;
+}
@@ -0,0 +1,603 @@
+/*
+ * Multi-core (SMP) CPU scheduling simulation.
+ *
+ * FCFS.c and SRTF.c model ONE CPU. This program runs the same policies on
+ * K CPUs, the way an SMP kernel does:
+ *  - every CPU has its OWN run queue (a heap ordered by arrival for FCFS,
+ *    by remaining time for preemptive SRTF);
+ *  - a new process goes to an idle CPU, else the least loaded one,
+ *    among the CPUs its AFFINITY MASK allows;
+ *  - a CPU that runs dry STEALS work from the busiest queue (work
+ *    stealing), and a periodic LOAD BALANCER evens out queue lengths;
+ *  - a process that resumes on a different CPU than it last ran on pays
+ *    a MIGRATION COST (cold caches), added to its remaining time.
+ *
+ * The simulation is EVENT-DRIVEN: the clock jumps straight to the next
+ * arrival, completion or balance tick instead of advancing one unit at a
+ * time like SRTF.c, so 1,000,000 processes on 128 CPUs take seconds.
+ *
+ * Usage:
+ *   ./SMP                                   interactive, like FCFS.c
+ *   ./SMP generate <processes> <cpus> [policy] [migration_cost]
+ *                  [balance_interval] [steal] [seed]
+ *         policy: fcfs | srtf     balance_interval 0 = off     steal 0/1
+ */
+
+#include <stdio.h>
+#include <stdlib.h>    // For malloc(), qsort(), rand_r()
+#include <string.h>    // For memset(), strcmp()
+#include <stdint.h>    // For uint64_t
+#include <time.h>      // For clock_gettime()
+
+#define MAX_CPUS 1024
+#define MASK_WORDS (MAX_CPUS / 64)
+#define MAX_MASKS 256
+#define STEAL_SCAN 32     // Queue entries examined to find a movable process
+#define NEVER 0x7fffffffffffffffLL
+
+enum Policy { FCFS, SRTF };
+
+struct Process {
+    int pid;
+    long long at;        // Arrival Time
+    long long bt;        // Burst Time
+    long long remaining; // Remaining Time (grows by the migration cost)
+    long long ct;        // Completion Time
+    int mask;            // Index into masks[]
+    int lastCpu;         // CPU it last ran on, -1 if never ran
+};
+
+struct Cpu {
+    int *queue;          // Heap of pids waiting on this CPU
+    int queued, capacity;
+    int running;         // pid, or -1 when idle
+    long long startedAt; // When 'running' was dispatched
+    long long finishAt;  // When 'running' completes if not preempted
+    long long busy;      // Total time spent running processes
+    unsigned version;    // Bumped to cancel the pending completion event
+};
+
+struct Event {
+    long long time;
+    int cpu;
+    unsigned version;
+};
+
+struct Mask {
+    uint64_t bits[MASK_WORDS];
+};
+
+// --- Configuration ---
+int numCpus;
+enum Policy policy = FCFS;
+long long migrationCost = 2;
+long long balanceInterval = 50;
+int stealing = 1;
+
+// --- State ---
+struct Process *procs;
+int numProcs;
+struct Cpu *cpus;
+struct Mask masks[MAX_MASKS];
+int numMasks;
+struct Event *events; // Min-heap of completion events
+int numEvents, eventCapacity;
+long long now;
+int rotor;            // Spreads ties between equally loaded CPUs
+
+// --- Statistics ---
+long migrations, steals, balanceMoves, preemptions;
+
+/* ================================================================== */
+/*                        Affinity masks                              */
+/* ================================================================== */
+
+static int allowed(const struct Process *p, int cpu) {
+    return (masks[p->mask].bits[cpu >> 6] >> (cpu & 63)) & 1;
+}
+
+/**
+ * Returns the index of an identical mask, adding it if it is new.
+ * Processes share mask entries, so a million processes cost one int each.
+ */
+static int internMask(const struct Mask *m) {
+    for (int i = 0; i < numMasks; i++) {
+        if (memcmp(&masks[i], m, sizeof(struct Mask)) == 0) return i;
+    }
+    if (numMasks == MAX_MASKS) {
+        printf("Too many distinct affinity masks (max %d).\n", MAX_MASKS);
+        exit(1);
+    }
+    masks[numMasks] = *m;
+    return numMasks++;
+}
+
+static void maskSetRange(struct Mask *m, int lo, int hi) {
+    for (int c = lo; c <= hi && c < numCpus; c++) {
+        m->bits[c >> 6] |= 1ull << (c & 63);
+    }
+}
+
+/**
+ * Parses "all" or a CPU list such as "0-3,8,10-11".
+ * @return 1 if the mask is valid and not empty.
+ */
+static int parseMask(const char *text, struct Mask *m) {
+    memset(m, 0, sizeof(*m));
+    if (strcmp(text, "all") == 0) {
+        maskSetRange(m, 0, numCpus - 1);
+        return 1;
+    }
+    const char *s = text;
+    while (*s) {
+        char *end;
+        long lo = strtol(s, &end, 10), hi = lo;
+        if (end == s) return 0;
+        s = end;
+        if (*s == '-') {
+            hi = strtol(s + 1, &end, 10);
+            if (end == s + 1) return 0;
+            s = end;
+        }
+        if (lo < 0 || hi < lo || lo >= numCpus) return 0;
+        maskSetRange(m, (int)lo, (int)hi);
+        if (*s == ',') s++;
+        else if (*s) return 0;
+    }
+    for (int w = 0; w < MASK_WORDS; w++) {
+        if (m->bits[w]) return 1;
+    }
+    return 0;
+}
+
+/* ================================================================== */
+/*                        Per-CPU run queues                          */
+/* ================================================================== */
+
+// Queue order: FCFS by arrival, SRTF by remaining time; pid breaks ties
+static int before(int a, int b) {
+    const struct Process *pa = &procs[a], *pb = &procs[b];
+    if (policy == SRTF && pa->remaining != pb->remaining) return pa->remaining < pb->remaining;
+    if (pa->at != pb->at) return pa->at < pb->at;
+    return pa->pid < pb->pid;
+}
+
+static void siftUp(struct Cpu *c, int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!before(c->queue[i], c->queue[parent])) break;
+        int t = c->queue[i]; c->queue[i] = c->queue[parent]; c->queue[parent] = t;
+        i = parent;
+    }
+}
+
+static void siftDown(struct Cpu *c, int i) {
+    while (1) {
+        int l = 2 * i + 1, r = l + 1, best = i;
+        if (l < c->queued && before(c->queue[l], c->queue[best])) best = l;
+        if (r < c->queued && before(c->queue[r], c->queue[best])) best = r;
+        if (best == i) break;
+        int t = c->queue[i]; c->queue[i] = c->queue[best]; c->queue[best] = t;
+        i = best;
+    }
+}
+
+static void queuePush(struct Cpu *c, int pid) {
+    if (c->queued == c->capacity) {
+        c->capacity = c->capacity ? c->capacity * 2 : 16;
+        c->queue = realloc(c->queue, c->capacity * sizeof(int));
+        if (c->queue == NULL) {
+            perror("realloc failed");
+            exit(1);
+        }
+    }
+    c->queue[c->queued] = pid;
+    siftUp(c, c->queued++);
+}
+
+// Removes and returns the entry at heap index i
+static int queueRemoveAt(struct Cpu *c, int i) {
+    int pid = c->queue[i];
+    c->queue[i] = c->queue[--c->queued];
+    if (i < c->queued) {
+        siftUp(c, i);
+        siftDown(c, i);
+    }
+    return pid;
+}
+
+/**
+ * Looks at the first STEAL_SCAN entries of c's queue (the most urgent
+ * ones) for a process allowed to run on 'target'.
+ * @return Heap index, or -1.
+ */
+static int findMovable(const struct Cpu *c, int target) {
+    int limit = c->queued < STEAL_SCAN ? c->queued : STEAL_SCAN;
+    for (int i = 0; i < limit; i++) {
+        if (allowed(&procs[c->queue[i]], target)) return i;
+    }
+    return -1;
+}
+
+/* ================================================================== */
+/*                        Event queue                                 */
+/* ================================================================== */
+
+static void pushEvent(long long time, int cpu, unsigned version) {
+    if (numEvents == eventCapacity) {
+        eventCapacity = eventCapacity ? eventCapacity * 2 : 64;
+        events = realloc(events, eventCapacity * sizeof(struct Event));
+        if (events == NULL) {
+            perror("realloc failed");
+            exit(1);
+        }
+    }
+    int i = numEvents++;
+    events[i] = (struct Event){ time, cpu, version };
+    while (i > 0 && events[(i - 1) / 2].time > events[i].time) {
+        struct Event t = events[i]; events[i] = events[(i - 1) / 2]; events[(i - 1) / 2] = t;
+        i = (i - 1) / 2;
+    }
+}
+
+static struct Event popEvent() {
+    struct Event top = events[0];
+    events[0] = events[--numEvents];
+    int i = 0;
+    while (1) {
+        int l = 2 * i + 1, r = l + 1, best = i;
+        if (l < numEvents && events[l].time < events[best].time) best = l;
+        if (r < numEvents && events[r].time < events[best].time) best = r;
+        if (best == i) break;
+        struct Event t = events[i]; events[i] = events[best]; events[best] = t;
+        i = best;
+    }
+    return top;
+}
+
+// Drops completion events cancelled by a preemption
+static void discardStaleEvents() {
+    while (numEvents > 0 && events[0].version != cpus[events[0].cpu].version) popEvent();
+}
+
+/* ================================================================== */
+/*                        Scheduler                                   */
+/* ================================================================== */
+
+static int steal(int thief);
+
+/**
+ * Starts the next process of an idle CPU (stealing one if its own queue
+ * is empty).
+ */
+static void dispatch(int cpu) {
+    struct Cpu *c = &cpus[cpu];
+    if (c->queued == 0 && !(stealing && steal(cpu))) {
+        c->running = -1;
+        return;
+    }
+
+    int pid = queueRemoveAt(c, 0);
+    struct Process *p = &procs[pid];
+    if (p->lastCpu != -1 && p->lastCpu != cpu) {
+        migrations++;
+        p->remaining += migrationCost;
+    }
+    p->lastCpu = cpu;
+
+    c->running = pid;
+    c->startedAt = now;
+    c->finishAt = now + p->remaining;
+    pushEvent(c->finishAt, cpu, ++c->version);
+}
+
+/**
+ * Puts a process on a CPU's queue; starts it at once if the CPU is idle,
+ * or preempts the running process under SRTF if the new one is shorter.
+ */
+static void enqueue(int cpu, int pid) {
+    struct Cpu *c = &cpus[cpu];
+    queuePush(c, pid);
+
+    if (c->running == -1) {
+        dispatch(cpu);
+    } else if (policy == SRTF && procs[pid].remaining < c->finishAt - now) {
+        struct Process *r = &procs[c->running];
+        r->remaining = c->finishAt - now;
+        c->busy += now - c->startedAt;
+        c->version++; // Cancels the pending completion
+        queuePush(c, c->running);
+        preemptions++;
+        dispatch(cpu);
+    }
+}
+
+/**
+ * A CPU with nothing to do takes a process from the busiest CPU that has
+ * one it is allowed to run.
+ * @return 1 if something was moved onto the thief's queue.
+ */
+static int steal(int thief) {
+    int victim = -1, victimIndex = -1;
+    for (int k = 0; k < numCpus; k++) {
+        int v = (thief + 1 + k) % numCpus;
+        if (v == thief || cpus[v].queued == 0) continue;
+        if (victim != -1 && cpus[v].queued <= cpus[victim].queued) continue;
+        int index = findMovable(&cpus[v], thief);
+        if (index != -1) {
+            victim = v;
+            victimIndex = index;
+        }
+    }
+    if (victim == -1) return 0;
+
+    queuePush(&cpus[thief], queueRemoveAt(&cpus[victim], victimIndex));
+    steals++;
+    return 1;
+}
+
+/**
+ * New arrival: first idle allowed CPU, else the least loaded one.
+ */
+static void place(int pid) {
+    const struct Process *p = &procs[pid];
+    int best = -1, bestLoad = 0;
+    for (int k = 0; k < numCpus; k++) {
+        int cpu = (rotor + k) % numCpus;
+        if (!allowed(p, cpu)) continue;
+        int load = cpus[cpu].queued + (cpus[cpu].running != -1);
+        if (best == -1 || load < bestLoad) {
+            best = cpu;
+            bestLoad = load;
+            if (load == 0) break;
+        }
+    }
+    rotor = (best + 1) % numCpus;
+    enqueue(best, pid);
+}
+
+/**
+ * Periodic balancer: move work from the longest queue to the shortest
+ * until they differ by at most one (or nothing can legally move).
+ * @return Total number of queued processes.
+ */
+static long balance() {
+    long total = 0;
+    for (int c = 0; c < numCpus; c++) total += cpus[c].queued;
+    if (total == 0) return 0;
+
+    for (int moves = 0; moves < numCpus; moves++) {
+        int busiest = 0, idlest = 0;
+        for (int c = 1; c < numCpus; c++) {
+            int load = cpus[c].queued + (cpus[c].running != -1);
+            if (load > cpus[busiest].queued + (cpus[busiest].running != -1)) busiest = c;
+            if (load < cpus[idlest].queued + (cpus[idlest].running != -1)) idlest = c;
+        }
+        int high = cpus[busiest].queued + (cpus[busiest].running != -1);
+        int low = cpus[idlest].queued + (cpus[idlest].running != -1);
+        if (high - low < 2) break;
+
+        int index = findMovable(&cpus[busiest], idlest);
+        if (index == -1) break;
+        enqueue(idlest, queueRemoveAt(&cpus[busiest], index));
+        balanceMoves++;
+    }
+    return total;
+}
+
+static int compareArrival(const void *a, const void *b) {
+    const struct Process *pa = &procs[*(const int *)a], *pb = &procs[*(const int *)b];
+    if (pa->at != pb->at) return pa->at < pb->at ? -1 : 1;
+    return pa->pid - pb->pid;
+}
+
+/**
+ * Runs the whole simulation; fills in every process's ct.
+ */
+void simulate() {
+    cpus = calloc(numCpus, sizeof(struct Cpu));
+    int *order = malloc(numProcs * sizeof(int));
+    if (cpus == NULL || order == NULL) {
+        perror("malloc failed");
+        exit(1);
+    }
+    for (int c = 0; c < numCpus; c++) cpus[c].running = -1;
+    for (int i = 0; i < numProcs; i++) {
+        order[i] = i;
+        procs[i].remaining = procs[i].bt;
+        procs[i].lastCpu = -1;
+    }
+    qsort(order, numProcs, sizeof(int), compareArrival);
+
+    int nextArrival = 0, completed = 0;
+    long long nextBalance = balanceInterval > 0 ? balanceInterval : NEVER;
+
+    while (completed < numProcs) {
+        discardStaleEvents();
+        long long tComplete = numEvents ? events[0].time : NEVER;
+        long long tArrive = nextArrival < numProcs ? procs[order[nextArrival]].at : NEVER;
+
+        // Completions first so freed CPUs are visible to arrivals at the same time
+        if (tComplete <= tArrive && tComplete <= nextBalance) {
+            struct Event e = popEvent();
+            now = e.time;
+            struct Cpu *c = &cpus[e.cpu];
+            struct Process *p = &procs[c->running];
+            p->remaining = 0;
+            p->ct = now;
+            c->busy += now - c->startedAt;
+            c->running = -1;
+            completed++;
+            dispatch(e.cpu);
+        } else if (tArrive <= nextBalance) {
+            now = tArrive;
+            place(order[nextArrival++]);
+        } else {
+            now = nextBalance;
+            // Nothing queued anywhere: sleep until the next arrival
+            if (balance() == 0 && tArrive != NEVER && tArrive > now) {
+                nextBalance = tArrive + balanceInterval;
+            } else {
+                nextBalance += balanceInterval;
+            }
+        }
+    }
+    free(order);
+}
+
+/* ================================================================== */
+/*                        Reporting                                   */
+/* ================================================================== */
+
+static void printSummary(double wallSeconds) {
+    double totalWt = 0, totalTat = 0;
+    long long makespan = 0;
+    for (int i = 0; i < numProcs; i++) {
+        long long tat = procs[i].ct - procs[i].at;
+        totalTat += tat;
+        totalWt += tat - procs[i].bt;
+        if (procs[i].ct > makespan) makespan = procs[i].ct;
+    }
+
+    printf("\n--- SMP %s on %d CPUs: %d processes ---\n",
+           policy == SRTF ? "SRTF" : "FCFS", numCpus, numProcs);
+    printf("Migration cost %lld, balance interval %lld%s, stealing %s\n",
+           migrationCost, balanceInterval, balanceInterval ? "" : " (off)", stealing ? "on" : "off");
+    printf("Makespan: %lld\n", makespan);
+    printf("Average Waiting Time: %.2f\n", totalWt / numProcs);
+    printf("Average Turnaround Time: %.2f\n", totalTat / numProcs);
+    printf("Migrations: %ld (overhead %lld time units), steals: %ld, balance moves: %ld, preemptions: %ld\n",
+           migrations, migrations * migrationCost, steals, balanceMoves, preemptions);
+
+    double minU = 1, maxU = 0, sumU = 0;
+    for (int c = 0; c < numCpus; c++) {
+        double u = makespan ? (double)cpus[c].busy / makespan : 0;
+        sumU += u;
+        if (u < minU) minU = u;
+        if (u > maxU) maxU = u;
+        if (numCpus <= 16) printf("CPU %2d utilization: %6.2f%%\n", c, u * 100);
+    }
+    printf("CPU utilization: avg %.2f%%, min %.2f%%, max %.2f%%\n",
+           sumU / numCpus * 100, minU * 100, maxU * 100);
+    if (wallSeconds > 0) printf("Simulated in %.3f s\n", wallSeconds);
+}
+
+/**
+ * Random workload at about 90% load: 80% of processes may run anywhere,
+ * 15% are confined to one half of the machine (a "socket"), 5% are
+ * pinned to a single CPU.
+ */
+static void generate(unsigned seed) {
+    struct Mask all, half[2];
+    parseMask("all", &all);
+    memset(half, 0, sizeof(half));
+    maskSetRange(&half[0], 0, numCpus / 2 - 1 >= 0 ? numCpus / 2 - 1 : 0);
+    maskSetRange(&half[1], numCpus / 2, numCpus - 1);
+    int allId = internMask(&all);
+    int halfId[2] = { internMask(&half[0]), internMask(&half[1]) };
+
+    double meanBurst = 20.5, clock = 0;
+    for (int i = 0; i < numProcs; i++) {
+        struct Process *p = &procs[i];
+        p->pid = i;
+        clock += (rand_r(&seed) / (RAND_MAX + 1.0)) * 2 * meanBurst / (0.9 * numCpus);
+        p->at = (long long)clock;
+        p->bt = 1 + rand_r(&seed) % 40;
+
+        int kind = rand_r(&seed) % 100;
+        if (kind < 80) {
+            p->mask = allId;
+        } else if (kind < 95) {
+            p->mask = halfId[rand_r(&seed) % 2];
+        } else {
+            struct Mask one;
+            memset(&one, 0, sizeof(one));
+            int cpu = rand_r(&seed) % numCpus;
+            // Only a few distinct pinned CPUs, so the mask table stays small
+            cpu = cpu % (MAX_MASKS - 8);
+            maskSetRange(&one, cpu, cpu);
+            p->mask = internMask(&one);
+        }
+    }
+}
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 4 && strcmp(argv[1], "generate") == 0) {
+        numProcs = atoi(argv[2]);
+        numCpus = atoi(argv[3]);
+        if (argc >= 5) policy = strcmp(argv[4], "srtf") == 0 ? SRTF : FCFS;
+        if (argc >= 6) migrationCost = atoll(argv[5]);
+        if (argc >= 7) balanceInterval = atoll(argv[6]);
+        if (argc >= 8) stealing = atoi(argv[7]);
+        unsigned seed = argc >= 9 ? (unsigned)atoi(argv[8]) : 1;
+        if (numProcs < 1 || numCpus < 1 || numCpus > MAX_CPUS) {
+            printf("Need at least 1 process and 1..%d CPUs.\n", MAX_CPUS);
+            return 1;
+        }
+
+        procs = calloc(numProcs, sizeof(struct Process));
+        if (procs == NULL) {
+            perror("calloc failed");
+            return 1;
+        }
+        generate(seed);
+        double start = nowSeconds();
+        simulate();
+        printSummary(nowSeconds() - start);
+        return 0;
+    }
+
+    // Interactive, in the style of FCFS.c / SRTF.c
+    printf("Enter number of CPUs (1-%d):\n", MAX_CPUS);
+    if (scanf("%d", &numCpus) != 1 || numCpus < 1 || numCpus > MAX_CPUS) return 1;
+    printf("Enter policy (0 = FCFS, 1 = SRTF):\n");
+    int choice;
+    if (scanf("%d", &choice) != 1) return 1;
+    policy = choice ? SRTF : FCFS;
+    printf("Enter migration cost, balance interval (0 = off) and stealing (0/1):\n");
+    if (scanf("%lld %lld %d", &migrationCost, &balanceInterval, &stealing) != 3) return 1;
+
+    printf("Enter number of Processes:\n");
+    if (scanf("%d", &numProcs) != 1 || numProcs < 1) return 1;
+    procs = calloc(numProcs, sizeof(struct Process));
+    if (procs == NULL) {
+        perror("calloc failed");
+        return 1;
+    }
+
+    for (int i = 0; i < numProcs; i++) {
+        char text[256];
+        struct Mask m;
+        procs[i].pid = i;
+        printf("Enter A.T. for Process with pid:%d: ", i);
+        if (scanf("%lld", &procs[i].at) != 1) return 1;
+        printf("Enter B.T. for Process with pid:%d: ", i);
+        if (scanf("%lld", &procs[i].bt) != 1) return 1;
+        printf("Enter affinity for Process with pid:%d (all, or e.g. 0-3,6): ", i);
+        if (scanf("%255s", text) != 1) return 1;
+        while (!parseMask(text, &m)) {
+            printf("Invalid CPU list, try again: ");
+            if (scanf("%255s", text) != 1) return 1;
+        }
+        procs[i].mask = internMask(&m);
+    }
+
+    simulate();
+
+    printf("\n--- SMP Scheduling Results ---\n");
+    printf("PID\tAT\tBT\tCT\tTAT\tWT\tLast CPU\n");
+    printf("---------------------------------------------------------\n");
+    for (int i = 0; i < numProcs; i++) {
+        long long tat = procs[i].ct - procs[i].at;
+        printf("P%d\t%lld\t%lld\t%lld\t%lld\t%lld\t%d\n", procs[i].pid, procs[i].at, procs[i].bt,
+               procs[i].ct, tat, tat - procs[i].bt, procs[i].lastCpu);
+    }
+    printSummary(0);
+    return 0;
+}
@@ -0,0 +1,381 @@
+/*
+ * CPU scheduling with CPU and I/O BURSTS.
+ *
+ * In FCFS.c and SRTF.c every process is one pure CPU burst. Real programs
+ * alternate: compute, wait for the disk, compute again. Here each process
+ * has a burst SEQUENCE
+ *
+ *      CPU, I/O, CPU, I/O, ..., CPU        (always starts and ends on CPU)
+ *
+ * and the machine has one CPU and one I/O DEVICE:
+ *  - a process finishing a CPU burst joins the device's FCFS queue;
+ *  - when its I/O is done it returns to the CPU's ready queue;
+ *  - the ready queue is FCFS (order of becoming ready) or SRTF
+ *    (shortest remaining CPU burst first, preemptive).
+ *
+ * The simulation is EVENT-DRIVEN: the only interesting moments are
+ * arrivals, CPU-burst completions and I/O completions, so the clock jumps
+ * from one to the next (no current_time++ loop) and long bursts cost the
+ * same as short ones.
+ *
+ * Reports per-process CT, TAT, WT (time spent in the ready queue) and
+ * RT (response time: arrival to first run), plus CPU and device
+ * utilization.
+ *
+ * Usage:
+ *   ./SchedIO                                           interactive
+ *   ./SchedIO generate <processes> [fcfs|srtf] [cpu_bursts] [seed]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>    // For malloc(), qsort(), rand_r()
+#include <string.h>    // For strcmp()
+#include <time.h>      // For clock_gettime()
+
+#define NEVER 0x7fffffffffffffffLL
+
+enum Policy { FCFS, SRTF };
+
+struct Process {
+    int pid;
+    long long at;        // Arrival Time
+    int firstBurst;      // Index of its first burst in bursts[]
+    int numBursts;       // Odd: CPU, I/O, ..., CPU
+    int next;            // Burst in progress (even = CPU, odd = I/O)
+    long long remaining; // Remaining time of the current CPU burst
+    long long readySince;
+    long long readySeq;  // FCFS order in the ready queue
+    long long firstRun;  // -1 until first dispatched
+    long long wt;        // Time spent in the ready queue
+    long long ct;        // Completion Time
+    long long cpuTotal, ioTotal;
+};
+
+enum Policy policy = FCFS;
+struct Process *procs;
+int numProcs;
+long long *bursts;
+
+// --- Ready queue (heap of pids) ---
+int *ready;
+int numReady;
+long long readyCounter;
+
+// --- I/O device: FIFO ring of pids, one in service ---
+int *ioQueue;
+int ioHead, ioCount;
+int ioRunning = -1;
+long long ioFinishAt = NEVER;
+
+// --- CPU ---
+int running = -1;
+long long runStart;
+long long cpuFinishAt = NEVER;
+
+long long now;
+long long cpuBusy, ioBusy;
+long events, preemptions;
+
+/* ================================================================== */
+/*                        Ready queue                                 */
+/* ================================================================== */
+
+static int before(int a, int b) {
+    const struct Process *pa = &procs[a], *pb = &procs[b];
+    if (policy == SRTF) {
+        // Ties go to the lower pid, as in SRTF.c's lowest-index scan
+        if (pa->remaining != pb->remaining) return pa->remaining < pb->remaining;
+        return pa->pid < pb->pid;
+    }
+    return pa->readySeq < pb->readySeq;
+}
+
+static void readyPush(int pid) {
+    procs[pid].readySince = now;
+    procs[pid].readySeq = readyCounter++;
+    int i = numReady++;
+    ready[i] = pid;
+    while (i > 0 && before(ready[i], ready[(i - 1) / 2])) {
+        int t = ready[i]; ready[i] = ready[(i - 1) / 2]; ready[(i - 1) / 2] = t;
+        i = (i - 1) / 2;
+    }
+}
+
+static int readyPop() {
+    int top = ready[0];
+    ready[0] = ready[--numReady];
+    int i = 0;
+    while (1) {
+        int l = 2 * i + 1, r = l + 1, best = i;
+        if (l < numReady && before(ready[l], ready[best])) best = l;
+        if (r < numReady && before(ready[r], ready[best])) best = r;
+        if (best == i) break;
+        int t = ready[i]; ready[i] = ready[best]; ready[best] = t;
+        i = best;
+    }
+    return top;
+}
+
+/* ================================================================== */
+/*                        Scheduler                                   */
+/* ================================================================== */
+
+// Gives the CPU to the best ready process, if any
+static void dispatch() {
+    if (numReady == 0) {
+        running = -1;
+        cpuFinishAt = NEVER;
+        return;
+    }
+    int pid = readyPop();
+    struct Process *p = &procs[pid];
+    p->wt += now - p->readySince;
+    if (p->firstRun < 0) p->firstRun = now;
+
+    running = pid;
+    runStart = now;
+    cpuFinishAt = now + p->remaining;
+}
+
+/**
+ * A process becomes ready at the start of CPU burst p->next.
+ */
+static void makeReady(int pid) {
+    struct Process *p = &procs[pid];
+    p->remaining = bursts[p->firstBurst + p->next];
+    readyPush(pid);
+
+    if (running == -1) {
+        dispatch();
+    } else if (policy == SRTF && (p->remaining < cpuFinishAt - now ||
+                                  (p->remaining == cpuFinishAt - now && pid < running))) {
+        // Preempt: the running process goes back with what it has left
+        procs[running].remaining = cpuFinishAt - now;
+        cpuBusy += now - runStart;
+        readyPush(running);
+        preemptions++;
+        dispatch();
+    }
+}
+
+static void startIo() {
+    if (ioRunning != -1 || ioCount == 0) return;
+    ioRunning = ioQueue[ioHead];
+    ioHead = (ioHead + 1) % numProcs;
+    ioCount--;
+    struct Process *p = &procs[ioRunning];
+    ioFinishAt = now + bursts[p->firstBurst + p->next];
+}
+
+static void cpuBurstDone() {
+    struct Process *p = &procs[running];
+    cpuBusy += now - runStart;
+    p->next++;
+
+    if (p->next == p->numBursts) {
+        p->ct = now;
+    } else {
+        // Next burst is I/O: join the device queue
+        ioQueue[(ioHead + ioCount) % numProcs] = running;
+        ioCount++;
+        startIo();
+    }
+    dispatch();
+}
+
+static void ioBurstDone() {
+    int pid = ioRunning;
+    struct Process *p = &procs[pid];
+    ioBusy += bursts[p->firstBurst + p->next];
+    p->next++;
+
+    ioRunning = -1;
+    ioFinishAt = NEVER;
+    startIo();
+    makeReady(pid);
+}
+
+static int compareArrival(const void *a, const void *b) {
+    const struct Process *pa = &procs[*(const int *)a], *pb = &procs[*(const int *)b];
+    if (pa->at != pb->at) return pa->at < pb->at ? -1 : 1;
+    return pa->pid - pb->pid;
+}
+
+void simulate() {
+    ready = malloc(numProcs * sizeof(int));
+    ioQueue = malloc(numProcs * sizeof(int));
+    int *order = malloc(numProcs * sizeof(int));
+    if (ready == NULL || ioQueue == NULL || order == NULL) {
+        perror("malloc failed");
+        exit(1);
+    }
+    for (int i = 0; i < numProcs; i++) {
+        order[i] = i;
+        procs[i].next = 0;
+        procs[i].firstRun = -1;
+        procs[i].wt = 0;
+    }
+    qsort(order, numProcs, sizeof(int), compareArrival);
+
+    int nextArrival = 0;
+    while (1) {
+        long long tArrive = nextArrival < numProcs ? procs[order[nextArrival]].at : NEVER;
+        if (cpuFinishAt == NEVER && ioFinishAt == NEVER && tArrive == NEVER) break;
+        events++;
+
+        // CPU completion, then I/O completion, then arrival at equal times
+        if (cpuFinishAt <= ioFinishAt && cpuFinishAt <= tArrive) {
+            now = cpuFinishAt;
+            cpuBurstDone();
+        } else if (ioFinishAt <= tArrive) {
+            now = ioFinishAt;
+            ioBurstDone();
+        } else {
+            now = tArrive;
+            makeReady(order[nextArrival++]);
+        }
+    }
+    free(order);
+}
+
+/* ================================================================== */
+/*                        Reporting                                   */
+/* ================================================================== */
+
+static void printSummary(double wallSeconds) {
+    double totalWt = 0, totalTat = 0, totalRt = 0;
+    long long makespan = 0, firstArrival = NEVER;
+    for (int i = 0; i < numProcs; i++) {
+        totalWt += procs[i].wt;
+        totalTat += procs[i].ct - procs[i].at;
+        totalRt += procs[i].firstRun - procs[i].at;
+        if (procs[i].ct > makespan) makespan = procs[i].ct;
+        if (procs[i].at < firstArrival) firstArrival = procs[i].at;
+    }
+    long long span = makespan - firstArrival;
+
+    printf("\n--- %s with I/O bursts: %d processes ---\n", policy == SRTF ? "SRTF" : "FCFS", numProcs);
+    printf("Average Waiting Time: %.2f\n", totalWt / numProcs);
+    printf("Average Turnaround Time: %.2f\n", totalTat / numProcs);
+    printf("Average Response Time: %.2f\n", totalRt / numProcs);
+    printf("CPU utilization: %.2f%%   I/O device utilization: %.2f%%\n",
+           span ? 100.0 * cpuBusy / span : 0, span ? 100.0 * ioBusy / span : 0);
+    printf("Throughput: %.4f processes per time unit (makespan %lld)\n",
+           span ? (double)numProcs / span : 0, makespan);
+    printf("Events: %ld, preemptions: %ld\n", events, preemptions);
+    if (wallSeconds > 0) printf("Simulated in %.3f s\n", wallSeconds);
+}
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Random mix: CPU bursts 1..20, I/O bursts 2..20, arrivals spaced so the
+ * CPU is about 85% and the device about 70% busy.
+ */
+static void generate(int cpuBursts, unsigned seed) {
+    int perProcess = 2 * cpuBursts - 1;
+    bursts = malloc((size_t)numProcs * perProcess * sizeof(long long));
+    if (bursts == NULL) {
+        perror("malloc failed");
+        exit(1);
+    }
+    long long clock = 0;
+    for (int i = 0; i < numProcs; i++) {
+        struct Process *p = &procs[i];
+        p->pid = i;
+        clock += rand_r(&seed) % (24 * cpuBursts);
+        p->at = clock;
+        p->firstBurst = i * perProcess;
+        p->numBursts = perProcess;
+        for (int b = 0; b < perProcess; b++) {
+            long long length = (b % 2 == 0) ? 1 + rand_r(&seed) % 20 : 2 + rand_r(&seed) % 19;
+            bursts[p->firstBurst + b] = length;
+            if (b % 2 == 0) p->cpuTotal += length;
+            else p->ioTotal += length;
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 3 && strcmp(argv[1], "generate") == 0) {
+        numProcs = atoi(argv[2]);
+        if (argc >= 4) policy = strcmp(argv[3], "srtf") == 0 ? SRTF : FCFS;
+        int cpuBursts = argc >= 5 ? atoi(argv[4]) : 5;
+        unsigned seed = argc >= 6 ? (unsigned)atoi(argv[5]) : 1;
+        if (numProcs < 1 || cpuBursts < 1) {
+            printf("Usage: %s generate <processes> [fcfs|srtf] [cpu_bursts] [seed]\n", argv[0]);
+            return 1;
+        }
+        procs = calloc(numProcs, sizeof(struct Process));
+        if (procs == NULL) {
+            perror("calloc failed");
+            return 1;
+        }
+        generate(cpuBursts, seed);
+        double start = nowSeconds();
+        simulate();
+        printSummary(nowSeconds() - start);
+        return 0;
+    }
+
+    // Interactive, in the style of SRTF.c
+    int choice;
+    printf("Enter policy (0 = FCFS, 1 = SRTF):\n");
+    if (scanf("%d", &choice) != 1) return 1;
+    policy = choice ? SRTF : FCFS;
+    printf("Enter number of Processes:\n");
+    if (scanf("%d", &numProcs) != 1 || numProcs < 1) return 1;
+
+    procs = calloc(numProcs, sizeof(struct Process));
+    int capacity = 64, used = 0;
+    bursts = malloc(capacity * sizeof(long long));
+    if (procs == NULL || bursts == NULL) {
+        perror("malloc failed");
+        return 1;
+    }
+
+    for (int i = 0; i < numProcs; i++) {
+        struct Process *p = &procs[i];
+        p->pid = i;
+        printf("Enter A.T. for Process with pid:%d: ", i);
+        if (scanf("%lld", &p->at) != 1) return 1;
+        printf("Enter number of CPU bursts for Process with pid:%d: ", i);
+        int cpuBursts;
+        if (scanf("%d", &cpuBursts) != 1 || cpuBursts < 1) return 1;
+
+        p->firstBurst = used;
+        p->numBursts = 2 * cpuBursts - 1;
+        printf("Enter the bursts in order (CPU I/O CPU ... CPU), %d numbers: ", p->numBursts);
+        for (int b = 0; b < p->numBursts; b++) {
+            if (used == capacity) {
+                capacity *= 2;
+                bursts = realloc(bursts, capacity * sizeof(long long));
+                if (bursts == NULL) {
+                    perror("realloc failed");
+                    return 1;
+                }
+            }
+            if (scanf("%lld", &bursts[used]) != 1 || bursts[used] < 1) return 1;
+            if (b % 2 == 0) p->cpuTotal += bursts[used];
+            else p->ioTotal += bursts[used];
+            used++;
+        }
+    }
+
+    simulate();
+
+    printf("\n--- Scheduling Results ---\n");
+    printf("PID\tAT\tCPU\tI/O\tCT\tTAT\tWT\tRT\n");
+    printf("-------------------------------------------------------------\n");
+    for (int i = 0; i < numProcs; i++) {
+        struct Process *p = &procs[i];
+        printf("P%d\t%lld\t%lld\t%lld\t%lld\t%lld\t%lld\t%lld\n", p->pid, p->at, p->cpuTotal,
+               p->ioTotal, p->ct, p->ct - p->at, p->wt, p->firstRun - p->at);
+    }
+    printSummary(0);
+    return 0;
+}
@@ -4,6 +4,32 @@
 #./cal.sh
 
 # This script provides a menu-driven calculator.
+#
+# If the native calculator is built next to this script
+# (gcc -O2 calc.c -o calc) the menu uses it, so numbers can be any size
+# and may have decimals. It also takes whole files of expressions:
+#   ./cal.sh -b < expressions     (one expression per line)
+
+engine="$(dirname "$0")/calc"
+
+# Batch mode: hand every expression to the native calculator at once
+if [ "$1" = "-b" ]; then
+  if [ ! -x "$engine" ]; then
+    echo "Batch mode needs the native calculator: gcc -O2 calc.c -o calc"
+    exit 1
+  fi
+  shift
+  exec "$engine" "$@"
+fi
+
+# Evaluates "a op b" with the native calculator, or $((...)) without it
+calc() {
+  if [ -x "$engine" ]; then
+    echo "$1 $2 $3" | "$engine"
+  else
+    echo $(($1 $2 $3))
+  fi
+}
 
 # 1. Start an infinite 'while true' loop to keep showing the menu
 while true
@@ -27,33 +53,33 @@ do
       # Addition
       read -p "Enter first number: " num1
       read -p "Enter second number: " num2
-      result=$((num1 + num2))
+      result=$(calc "$num1" "+" "$num2")
       echo "Result: $num1 + $num2 = $result"
       ;;
     2)
       # Subtraction
       read -p "Enter first number: " num1
       read -p "Enter second number: " num2
-      result=$((num1 - num2))
+      result=$(calc "$num1" "-" "$num2")
       echo "Result: $num1 - $num2 = $result"
       ;;
     3)
       # Multiplication
       read -p "Enter first number: " num1
       read -p "Enter second number: " num2
-      result=$((num1 * num2))
+      result=$(calc "$num1" "*" "$num2")
       echo "Result: $num1 * $num2 = $result"
       ;;
-    4.
+    4)
       # Division
       read -p "Enter first number: " num1
       read -p "Enter second number: " num2
       
       # Check for division by zero
-      if [ $num2 -eq 0 ]; then
+      if [ "$(calc "$num2" "*" 1)" = "0" ]; then
         echo "Error: Cannot divide by zero."
       else
-        result=$((num1 / num2))
+        result=$(calc "$num1" "/" "$num2")
         echo "Result: $num1 / $num2 = $result"
       fi
       ;;
@@ -0,0 +1,955 @@
+/*
+ * Batch calculator behind cal.sh
+ *
+ * cal.sh computes one $((a op b)) per menu round: 64-bit integers only,
+ * integer division only. This program reads a STREAM of expressions, one
+ * per line, and prints one result per line:
+ *
+ *   ./calc < expressions        e.g.  "2^200 - 1", "(1.5 + 2) * -3", "7 / 2"
+ *   ./calc bench [count]        throughput and Karatsuba vs schoolbook
+ *
+ * Language: numbers (123, 0.25), + - * / % ^, unary minus, parentheses.
+ *  - integer / integer truncates toward zero and % follows the dividend,
+ *    exactly like $((...)) in bash;
+ *  - if either operand of / is written with a decimal point (or was
+ *    computed from one) the quotient is exact to DIV_SCALE decimal
+ *    places (truncated): 7/2 = 3 but 7.0/2 = 3.5;
+ *  - ^ takes a non-negative integer exponent and binds tighter than unary
+ *    minus, so -2^2 = -4; a power over MAX_POWER_LIMBS limbs is
+ *    refused with an error instead of being computed.
+ *
+ * How it works:
+ *  1. Each line is parsed ONCE by recursive descent into a compact
+ *     bytecode (one 32-bit word per instruction) for a stack machine,
+ *     with the literals converted to big numbers in a constant pool.
+ *  2. The bytecode runs on a value stack whose big-number buffers are
+ *     reused from line to line, so a steady stream of expressions does
+ *     almost no allocation.
+ *  3. Values are decimals: an arbitrary-precision integer mantissa
+ *     (base 10^9 limbs, so printing needs no division) and a scale.
+ *     Large products use KARATSUBA multiplication (3 half-size products
+ *     instead of 4), falling back to schoolbook below a threshold.
+ *
+ * Compile: gcc -O2 calc.c -o calc
+ */
+
+#include <stdio.h>
+#include <stdlib.h>    // For malloc(), realloc(), exit()
+#include <string.h>    // For memset(), memcpy(), strcmp()
+#include <stdint.h>    // For uint32_t, uint64_t
+#include <ctype.h>     // For isdigit(), isspace()
+#include <time.h>      // For clock_gettime()
+
+#define BASE 1000000000u    // One limb holds 9 decimal digits
+#define BASE_DIGITS 9
+#define DIV_SCALE 20        // Decimal places of a non-integer quotient
+#define MAX_EXPONENT 1000000
+#define MAX_POWER_LIMBS (1 << 21) // Size cap for a^n, about 19M digits
+#define MAX_NESTING 256
+
+int karatsubaThreshold = 32; // Limbs; below this schoolbook is faster
+
+/* ================================================================== */
+/*                        Big integers                                */
+/* ================================================================== */
+
+// Sign-magnitude, little-endian limbs; zero has len 0
+typedef struct {
+    uint32_t *d;
+    int len, cap;
+    int neg;
+} Big;
+
+// value = m / 10^scale
+typedef struct {
+    Big m;
+    int scale;
+} Num;
+
+static void bigReserve(Big *x, int n) {
+    if (n <= x->cap) return;
+    int cap = x->cap ? x->cap : 4;
+    while (cap < n) cap *= 2;
+    x->d = realloc(x->d, cap * sizeof(uint32_t));
+    if (x->d == NULL) {
+        perror("realloc failed");
+        exit(1);
+    }
+    x->cap = cap;
+}
+
+static void bigTrim(Big *x) {
+    while (x->len > 0 && x->d[x->len - 1] == 0) x->len--;
+    if (x->len == 0) x->neg = 0;
+}
+
+static void bigCopy(Big *dst, const Big *src) {
+    bigReserve(dst, src->len);
+    memcpy(dst->d, src->d, src->len * sizeof(uint32_t));
+    dst->len = src->len;
+    dst->neg = src->neg;
+}
+
+static void bigSetSmall(Big *x, uint32_t value) {
+    bigReserve(x, 1);
+    x->d[0] = value;
+    x->len = 1;
+    x->neg = 0;
+    bigTrim(x);
+}
+
+static int magCompare(const uint32_t *a, int an, const uint32_t *b, int bn) {
+    if (an != bn) return an < bn ? -1 : 1;
+    for (int i = an - 1; i >= 0; i--) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// dst[0..dn) += src[0..sn); the sum must fit in dn limbs
+static void magAddInto(uint32_t *dst, int dn, const uint32_t *src, int sn) {
+    uint32_t carry = 0;
+    int i = 0;
+    for (; i < sn; i++) {
+        uint32_t t = dst[i] + src[i] + carry;
+        carry = t >= BASE;
+        dst[i] = carry ? t - BASE : t;
+    }
+    for (; carry && i < dn; i++) {
+        uint32_t t = dst[i] + 1;
+        carry = t >= BASE;
+        dst[i] = carry ? 0 : t;
+    }
+}
+
+// dst[0..dn) -= src[0..sn); dst must be >= src
+static void magSubInto(uint32_t *dst, int dn, const uint32_t *src, int sn) {
+    uint32_t borrow = 0;
+    int i = 0;
+    for (; i < sn; i++) {
+        int64_t t = (int64_t)dst[i] - src[i] - borrow;
+        borrow = t < 0;
+        dst[i] = (uint32_t)(borrow ? t + BASE : t);
+    }
+    for (; borrow && i < dn; i++) {
+        borrow = dst[i] == 0;
+        dst[i] = borrow ? BASE - 1 : dst[i] - 1;
+    }
+}
+
+// out[0..an+bn) = a * b, schoolbook O(an * bn)
+static void mulSchool(const uint32_t *a, int an, const uint32_t *b, int bn, uint32_t *out) {
+    memset(out, 0, (an + bn) * sizeof(uint32_t));
+    for (int i = 0; i < an; i++) {
+        uint64_t carry = 0;
+        uint64_t ai = a[i];
+        for (int j = 0; j < bn; j++) {
+            uint64_t t = out[i + j] + ai * b[j] + carry;
+            carry = t / BASE;
+            out[i + j] = (uint32_t)(t % BASE);
+        }
+        out[i + bn] = (uint32_t)carry;
+    }
+}
+
+/**
+ * out[0..an+bn) = a * b. Karatsuba: with a = a1*B^m + a0 and
+ * b = b1*B^m + b0,
+ *   a*b = z2*B^2m + (z1 - z2 - z0)*B^m + z0
+ * where z0 = a0*b0, z2 = a1*b1, z1 = (a0+a1)*(b0+b1).
+ */
+static void mulMagnitude(const uint32_t *a, int an, const uint32_t *b, int bn, uint32_t *out) {
+    if (an < bn) {
+        const uint32_t *t = a; a = b; b = t;
+        int tn = an; an = bn; bn = tn;
+    }
+    if (bn < karatsubaThreshold) {
+        mulSchool(a, an, b, bn, out);
+        return;
+    }
+
+    // Very unbalanced: cut 'a' into bn-limb slices and add the products
+    if (an >= 2 * bn) {
+        memset(out, 0, (an + bn) * sizeof(uint32_t));
+        uint32_t *slice = malloc(2 * bn * sizeof(uint32_t));
+        if (slice == NULL) {
+            perror("malloc failed");
+            exit(1);
+        }
+        for (int off = 0; off < an; off += bn) {
+            int len = an - off < bn ? an - off : bn;
+            mulMagnitude(a + off, len, b, bn, slice);
+            magAddInto(out + off, an + bn - off, slice, len + bn);
+        }
+        free(slice);
+        return;
+    }
+
+    int m = an / 2; // bn > m here, so every half is non-empty
+    int a1n = an - m, b1n = bn - m;
+
+    // z0 and z2 go straight into the low and high parts of 'out'
+    mulMagnitude(a, m, b, m, out);
+    mulMagnitude(a + m, a1n, b + m, b1n, out + 2 * m);
+
+    // z1 = (a0 + a1)(b0 + b1)
+    int sn = a1n + 1; // a1n >= m and b1n <= a1n
+    uint32_t *scratch = calloc(4 * sn, sizeof(uint32_t));
+    if (scratch == NULL) {
+        perror("calloc failed");
+        exit(1);
+    }
+    uint32_t *sa = scratch, *sb = scratch + sn, *z1 = scratch + 2 * sn;
+    memcpy(sa, a + m, a1n * sizeof(uint32_t));
+    magAddInto(sa, sn, a, m);
+    memcpy(sb, b + m, b1n * sizeof(uint32_t));
+    magAddInto(sb, sn, b, m);
+    mulMagnitude(sa, sn, sb, sn, z1);
+
+    // z1 - z0 - z2, then add it in at B^m
+    magSubInto(z1, 2 * sn, out, 2 * m);
+    magSubInto(z1, 2 * sn, out + 2 * m, a1n + b1n);
+    int z1n = 2 * sn;
+    while (z1n > 0 && z1[z1n - 1] == 0) z1n--;
+    magAddInto(out + m, an + bn - m, z1, z1n);
+    free(scratch);
+}
+
+// x *= small (small < BASE)
+static void bigMulSmall(Big *x, uint32_t small) {
+    uint64_t carry = 0;
+    for (int i = 0; i < x->len; i++) {
+        uint64_t t = (uint64_t)x->d[i] * small + carry;
+        x->d[i] = (uint32_t)(t % BASE);
+        carry = t / BASE;
+    }
+    if (carry) {
+        bigReserve(x, x->len + 1);
+        x->d[x->len++] = (uint32_t)carry;
+    }
+    bigTrim(x);
+}
+
+// x *= 10^k
+static void bigMulPow10(Big *x, int k) {
+    static const uint32_t pow10[BASE_DIGITS] = { 1, 10, 100, 1000, 10000, 100000,
+                                                 1000000, 10000000, 100000000 };
+    if (x->len == 0 || k == 0) return;
+    if (k % BASE_DIGITS) bigMulSmall(x, pow10[k % BASE_DIGITS]);
+    int shift = k / BASE_DIGITS;
+    if (shift) {
+        bigReserve(x, x->len + shift);
+        memmove(x->d + shift, x->d, x->len * sizeof(uint32_t));
+        memset(x->d, 0, shift * sizeof(uint32_t));
+        x->len += shift;
+    }
+}
+
+// r = a + b (or a - b when negateB); r must not alias a or b
+static void bigAdd(Big *r, const Big *a, const Big *b, int negateB) {
+    int bneg = b->neg ^ negateB;
+    if (a->neg == bneg) {
+        int n = (a->len > b->len ? a->len : b->len) + 1;
+        bigReserve(r, n);
+        memset(r->d, 0, n * sizeof(uint32_t));
+        memcpy(r->d, a->d, a->len * sizeof(uint32_t));
+        magAddInto(r->d, n, b->d, b->len);
+        r->len = n;
+        r->neg = a->neg;
+    } else {
+        // Subtract the smaller magnitude from the larger
+        const Big *big = a, *small = b;
+        int sign = a->neg;
+        if (magCompare(a->d, a->len, b->d, b->len) < 0) {
+            big = b;
+            small = a;
+            sign = bneg;
+        }
+        bigReserve(r, big->len);
+        memcpy(r->d, big->d, big->len * sizeof(uint32_t));
+        magSubInto(r->d, big->len, small->d, small->len);
+        r->len = big->len;
+        r->neg = sign;
+    }
+    bigTrim(r);
+}
+
+// r = a * b; r must not alias a or b
+static void bigMul(Big *r, const Big *a, const Big *b) {
+    if (a->len == 0 || b->len == 0) {
+        r->len = 0;
+        r->neg = 0;
+        return;
+    }
+    bigReserve(r, a->len + b->len);
+    mulMagnitude(a->d, a->len, b->d, b->len, r->d);
+    r->len = a->len + b->len;
+    r->neg = a->neg ^ b->neg;
+    bigTrim(r);
+}
+
+/**
+ * q = a / b, rem = a % b, truncated toward zero (rem takes the sign of a).
+ * Knuth's Algorithm D on base-10^9 limbs. q and rem must not alias a or b.
+ */
+static void bigDivMod(Big *q, Big *rem, const Big *a, const Big *b) {
+    int n = b->len, m = a->len - b->len;
+    if (m < 0) {
+        q->len = 0;
+        q->neg = 0;
+        bigCopy(rem, a);
+        return;
+    }
+
+    bigReserve(q, m + 1);
+    if (n == 1) {
+        // Short division by one limb
+        uint64_t r = 0, v = b->d[0];
+        for (int i = a->len - 1; i >= 0; i--) {
+            uint64_t cur = r * BASE + a->d[i];
+            q->d[i] = (uint32_t)(cur / v);
+            r = cur % v;
+        }
+        q->len = a->len;
+        bigSetSmall(rem, (uint32_t)r);
+    } else {
+        // Normalise so the divisor's top limb is >= BASE/2
+        uint32_t f = BASE / (b->d[n - 1] + 1);
+        uint32_t *u = calloc(a->len + 1 + n, sizeof(uint32_t));
+        if (u == NULL) {
+            perror("calloc failed");
+            exit(1);
+        }
+        uint32_t *v = u + a->len + 1;
+        uint64_t carry = 0;
+        for (int i = 0; i < a->len; i++) {
+            uint64_t t = (uint64_t)a->d[i] * f + carry;
+            u[i] = (uint32_t)(t % BASE);
+            carry = t / BASE;
+        }
+        u[a->len] = (uint32_t)carry;
+        carry = 0;
+        for (int i = 0; i < n; i++) {
+            uint64_t t = (uint64_t)b->d[i] * f + carry;
+            v[i] = (uint32_t)(t % BASE);
+            carry = t / BASE;
+        }
+
+        for (int j = m; j >= 0; j--) {
+            // Estimate this quotient limb from the top two/three limbs
+            uint64_t num = (uint64_t)u[j + n] * BASE + u[j + n - 1];
+            uint64_t qhat = num / v[n - 1];
+            uint64_t rhat = num % v[n - 1];
+            while (qhat >= BASE || qhat * v[n - 2] > rhat * BASE + u[j + n - 2]) {
+                qhat--;
+                rhat += v[n - 1];
+                if (rhat >= BASE) break;
+            }
+
+            // u[j..j+n] -= qhat * v
+            int64_t borrow = 0;
+            carry = 0;
+            for (int i = 0; i < n; i++) {
+                uint64_t p = qhat * v[i] + carry;
+                carry = p / BASE;
+                int64_t t = (int64_t)u[i + j] - (int64_t)(p % BASE) - borrow;
+                borrow = t < 0;
+                u[i + j] = (uint32_t)(borrow ? t + BASE : t);
+            }
+            int64_t top = (int64_t)u[j + n] - (int64_t)carry - borrow;
+
+            if (top < 0) {
+                // qhat was one too large: add v back
+                u[j + n] = (uint32_t)(top + BASE);
+                qhat--;
+                uint32_t c = 0;
+                for (int i = 0; i < n; i++) {
+                    uint32_t t = u[i + j] + v[i] + c;
+                    c = t >= BASE;
+                    u[i + j] = c ? t - BASE : t;
+                }
+                u[j + n] = (u[j + n] + c) % BASE;
+            } else {
+                u[j + n] = (uint32_t)top;
+            }
+            q->d[j] = (uint32_t)qhat;
+        }
+        q->len = m + 1;
+
+        // Remainder = u[0..n) / f
+        bigReserve(rem, n);
+        uint64_t r = 0;
+        for (int i = n - 1; i >= 0; i--) {
+            uint64_t cur = r * BASE + u[i];
+            rem->d[i] = (uint32_t)(cur / f);
+            r = cur % f;
+        }
+        rem->len = n;
+        free(u);
+    }
+
+    q->neg = a->neg ^ b->neg;
+    rem->neg = a->neg;
+    bigTrim(q);
+    bigTrim(rem);
+}
+
+/* ================================================================== */
+/*                        Decimal values                              */
+/* ================================================================== */
+
+Big scratchA, scratchB, scratchR; // Reused by the arithmetic below
+
+static void numCopy(Num *dst, const Num *src) {
+    bigCopy(&dst->m, &src->m);
+    dst->scale = src->scale;
+}
+
+static void numSwap(Num *a, Num *b) {
+    Num t = *a;
+    *a = *b;
+    *b = t;
+}
+
+static int numIsInteger(const Num *x) {
+    return x->scale == 0;
+}
+
+/**
+ * Brings a and b to the same scale; returns pointers to mantissas that
+ * can be combined digit for digit.
+ */
+static int alignScales(const Num *a, const Num *b, const Big **am, const Big **bm) {
+    *am = &a->m;
+    *bm = &b->m;
+    if (a->scale < b->scale) {
+        bigCopy(&scratchA, &a->m);
+        bigMulPow10(&scratchA, b->scale - a->scale);
+        *am = &scratchA;
+        return b->scale;
+    }
+    if (b->scale < a->scale) {
+        bigCopy(&scratchB, &b->m);
+        bigMulPow10(&scratchB, a->scale - b->scale);
+        *bm = &scratchB;
+    }
+    return a->scale;
+}
+
+// Drops trailing zero decimals: 2.0 becomes the integer 2
+static void numNormalize(Num *x) {
+    while (x->scale > 0 && x->m.len > 0 && x->m.d[0] % 10 == 0) {
+        uint64_t r = 0;
+        for (int i = x->m.len - 1; i >= 0; i--) {
+            uint64_t cur = r * BASE + x->m.d[i];
+            x->m.d[i] = (uint32_t)(cur / 10);
+            r = cur % 10;
+        }
+        bigTrim(&x->m);
+        x->scale--;
+    }
+    if (x->m.len == 0) x->scale = 0;
+}
+
+/**
+ * r = a op b. r must not alias a or b.
+ * @return NULL on success, or an error message.
+ */
+static const char *numBinary(char op, Num *r, const Num *a, const Num *b) {
+    const Big *am, *bm;
+    switch (op) {
+    case '+':
+    case '-':
+        r->scale = alignScales(a, b, &am, &bm);
+        bigAdd(&r->m, am, bm, op == '-');
+        break;
+
+    case '*':
+        bigMul(&r->m, &a->m, &b->m);
+        r->scale = a->scale + b->scale;
+        break;
+
+    case '/':
+    case '%':
+        if (b->m.len == 0) return "Cannot divide by zero.";
+        if (numIsInteger(a) && numIsInteger(b)) {
+            // Same semantics as $((a / b)) and $((a % b))
+            if (op == '/') bigDivMod(&r->m, &scratchR, &a->m, &b->m);
+            else bigDivMod(&scratchR, &r->m, &a->m, &b->m);
+            r->scale = 0;
+        } else if (op == '%') {
+            return "% needs integer operands.";
+        } else {
+            // a/b = (a.m * 10^k) / b.m at scale a.scale + k - b.scale
+            int scale = a->scale - b->scale > DIV_SCALE ? a->scale - b->scale : DIV_SCALE;
+            bigCopy(&scratchA, &a->m);
+            bigMulPow10(&scratchA, scale + b->scale - a->scale);
+            bigDivMod(&r->m, &scratchR, &scratchA, &b->m);
+            r->scale = scale;
+        }
+        break;
+
+    case '^': {
+        // Exponent must be a small non-negative integer (2.0 is fine)
+        static Num e;
+        numCopy(&e, b);
+        numNormalize(&e);
+        if (!numIsInteger(&e) || e.m.neg) return "^ needs a non-negative integer exponent.";
+        if (e.m.len > 1 || (e.m.len == 1 && e.m.d[0] > MAX_EXPONENT)) return "Exponent too large.";
+        uint32_t n = e.m.len ? e.m.d[0] : 0;
+
+        // a^n has at most n times the limbs (and exactly n times the
+        // decimals) of a; refuse it up front rather than square until
+        // memory runs out
+        if ((uint64_t)a->m.len * n > MAX_POWER_LIMBS ||
+            (uint64_t)a->scale * n > (uint64_t)MAX_POWER_LIMBS * BASE_DIGITS) {
+            return "Result too large.";
+        }
+        int scale = a->scale * (int)n;
+
+        // Square and multiply; scratchA holds the running square
+        bigSetSmall(&r->m, 1);
+        bigCopy(&scratchA, &a->m);
+        for (; n > 0; n >>= 1) {
+            if (n & 1) {
+                bigMul(&scratchR, &r->m, &scratchA);
+                bigCopy(&r->m, &scratchR);
+            }
+            if (n > 1) {
+                bigMul(&scratchR, &scratchA, &scratchA);
+                bigCopy(&scratchA, &scratchR);
+            }
+        }
+        // Not normalized, so 2.0^1 stays a decimal (like 2.0*1); a^0 of a
+        // decimal is 1 at a's scale
+        if (e.m.len == 0 && a->scale > 0) {
+            scale = a->scale;
+            bigMulPow10(&r->m, scale);
+        }
+        r->scale = scale;
+        break;
+    }
+    default:
+        return "Unknown operator.";
+    }
+    return NULL;
+}
+
+/**
+ * Parses the literal text[0..length) (digits with at most one '.').
+ */
+static void numParse(Num *x, const char *text, int length) {
+    char digits[length + 1];
+    int count = 0;
+    x->scale = 0;
+    int afterPoint = 0;
+    for (int i = 0; i < length; i++) {
+        if (text[i] == '.') {
+            afterPoint = 1;
+            continue;
+        }
+        digits[count++] = text[i];
+        x->scale += afterPoint;
+    }
+
+    // Pack 9 digits per limb, starting from the least significant end
+    int limbs = (count + BASE_DIGITS - 1) / BASE_DIGITS;
+    bigReserve(&x->m, limbs > 0 ? limbs : 1);
+    x->m.len = limbs;
+    x->m.neg = 0;
+    for (int l = 0; l < limbs; l++) {
+        int end = count - l * BASE_DIGITS;
+        int start = end - BASE_DIGITS > 0 ? end - BASE_DIGITS : 0;
+        uint32_t value = 0;
+        for (int i = start; i < end; i++) value = value * 10 + (digits[i] - '0');
+        x->m.d[l] = value;
+    }
+    bigTrim(&x->m);
+}
+
+char *printBuffer;
+size_t printCapacity;
+
+/**
+ * Formats x as decimal text in printBuffer. Trailing zero decimals are
+ * not printed, so 1.50 * 2 shows as 3.
+ */
+static const char *numFormat(const Num *x) {
+    size_t need = (size_t)x->m.len * BASE_DIGITS + x->scale + 4;
+    if (need > printCapacity) {
+        printCapacity = need * 2;
+        printBuffer = realloc(printBuffer, printCapacity);
+        if (printBuffer == NULL) {
+            perror("realloc failed");
+            exit(1);
+        }
+    }
+
+    // Mantissa digits, most significant limb unpadded
+    char *digits = printBuffer + 2 + x->scale;
+    int n = 0;
+    if (x->m.len == 0) {
+        digits[n++] = '0';
+        digits[n] = '\0';
+    } else {
+        n = sprintf(digits, "%u", x->m.d[x->m.len - 1]);
+        for (int i = x->m.len - 2; i >= 0; i--) {
+            n += sprintf(digits + n, "%09u", x->m.d[i]);
+        }
+    }
+    if (x->scale == 0) {
+        if (x->m.neg) *--digits = '-';
+        return digits;
+    }
+
+    // Insert the decimal point, padding with zeros as in 0.005
+    char *out = printBuffer;
+    int pos = 0;
+    if (x->m.neg) out[pos++] = '-';
+    int intDigits = n - x->scale;
+    if (intDigits <= 0) {
+        out[pos++] = '0';
+        out[pos++] = '.';
+        for (int i = 0; i < -intDigits; i++) out[pos++] = '0';
+        memmove(out + pos, digits, n);
+        pos += n;
+    } else {
+        memmove(out + pos, digits, intDigits);
+        pos += intDigits;
+        out[pos++] = '.';
+        memmove(out + pos, digits + intDigits, x->scale);
+        pos += x->scale;
+    }
+    while (out[pos - 1] == '0') pos--;
+    if (out[pos - 1] == '.') pos--;
+    out[pos] = '\0';
+    return out;
+}
+
+/* ================================================================== */
+/*                        Compiler                                    */
+/* ================================================================== */
+
+// Instruction word: opcode in the low 8 bits, operand in the high 24
+enum { OP_PUSH, OP_NEG, OP_BINARY };
+#define INSTR(op, arg) ((uint32_t)(op) | ((uint32_t)(arg) << 8))
+
+typedef struct {
+    uint32_t *code;
+    int length, capacity;
+    Num *consts;
+    int numConsts, constCapacity;
+    int depth, maxDepth; // Value-stack depth while compiling
+} Program;
+
+const char *src;        // Line being compiled
+int srcPos;
+const char *parseError;
+int nesting;
+
+static void emit(Program *p, uint32_t word, int stackEffect) {
+    if (p->length == p->capacity) {
+        p->capacity = p->capacity ? p->capacity * 2 : 64;
+        p->code = realloc(p->code, p->capacity * sizeof(uint32_t));
+        if (p->code == NULL) {
+            perror("realloc failed");
+            exit(1);
+        }
+    }
+    p->code[p->length++] = word;
+    p->depth += stackEffect;
+    if (p->depth > p->maxDepth) p->maxDepth = p->depth;
+}
+
+static void skipSpaces() {
+    while (src[srcPos] == ' ' || src[srcPos] == '\t' || src[srcPos] == '\r') srcPos++;
+}
+
+static void parseExpression(Program *p);
+
+static void parsePrimary(Program *p) {
+    skipSpaces();
+    char c = src[srcPos];
+    if (c == '(') {
+        if (++nesting > MAX_NESTING) {
+            parseError = "Expression nested too deeply.";
+            return;
+        }
+        srcPos++;
+        parseExpression(p);
+        skipSpaces();
+        if (parseError) return;
+        if (src[srcPos] != ')') {
+            parseError = "Missing ')'.";
+            return;
+        }
+        srcPos++;
+        nesting--;
+        return;
+    }
+    if (isdigit((unsigned char)c) || c == '.') {
+        int start = srcPos, points = 0, digits = 0;
+        while (isdigit((unsigned char)src[srcPos]) || src[srcPos] == '.') {
+            if (src[srcPos] == '.') points++;
+            else digits++;
+            srcPos++;
+        }
+        if (points > 1 || digits == 0) {
+            parseError = "Malformed number.";
+            return;
+        }
+        if (p->numConsts == p->constCapacity) {
+            int old = p->constCapacity;
+            p->constCapacity = old ? old * 2 : 16;
+            p->consts = realloc(p->consts, p->constCapacity * sizeof(Num));
+            if (p->consts == NULL) {
+                perror("realloc failed");
+                exit(1);
+            }
+            memset(p->consts + old, 0, (p->constCapacity - old) * sizeof(Num));
+        }
+        numParse(&p->consts[p->numConsts], src + start, srcPos - start);
+        emit(p, INSTR(OP_PUSH, p->numConsts), 1);
+        p->numConsts++;
+        return;
+    }
+    parseError = (c && c != '\n') ? "Unexpected character." : "Unexpected end of expression.";
+}
+
+// unary := ('-' | '+') unary | primary ('^' unary)?
+static void parseUnary(Program *p) {
+    skipSpaces();
+    if (src[srcPos] == '-' || src[srcPos] == '+') {
+        char sign = src[srcPos++];
+        if (++nesting > MAX_NESTING) {
+            parseError = "Expression nested too deeply.";
+            return;
+        }
+        parseUnary(p);
+        nesting--;
+        if (sign == '-' && !parseError) emit(p, INSTR(OP_NEG, 0), 0);
+        return;
+    }
+    parsePrimary(p);
+    skipSpaces();
+    if (!parseError && src[srcPos] == '^') {
+        srcPos++;
+        if (++nesting > MAX_NESTING) {
+            parseError = "Expression nested too deeply.";
+            return;
+        }
+        parseUnary(p); // Right-associative: 2^3^2 = 2^9
+        nesting--;
+        if (!parseError) emit(p, INSTR(OP_BINARY, '^'), -1);
+    }
+}
+
+// term := unary (('*' | '/' | '%') unary)*
+static void parseTerm(Program *p) {
+    parseUnary(p);
+    while (!parseError) {
+        skipSpaces();
+        char op = src[srcPos];
+        if (op != '*' && op != '/' && op != '%') return;
+        srcPos++;
+        parseUnary(p);
+        if (!parseError) emit(p, INSTR(OP_BINARY, op), -1);
+    }
+}
+
+// expression := term (('+' | '-') term)*
+static void parseExpression(Program *p) {
+    parseTerm(p);
+    while (!parseError) {
+        skipSpaces();
+        char op = src[srcPos];
+        if (op != '+' && op != '-') return;
+        srcPos++;
+        parseTerm(p);
+        if (!parseError) emit(p, INSTR(OP_BINARY, op), -1);
+    }
+}
+
+/**
+ * Compiles one line into p (reusing its buffers).
+ * @return NULL on success, or an error message.
+ */
+const char *compile(Program *p, const char *line) {
+    p->length = 0;
+    p->numConsts = 0;
+    p->depth = p->maxDepth = 0;
+    src = line;
+    srcPos = 0;
+    parseError = NULL;
+    nesting = 0;
+
+    parseExpression(p);
+    skipSpaces();
+    if (!parseError && src[srcPos] != '\0' && src[srcPos] != '\n') {
+        parseError = src[srcPos] == ')' ? "Unbalanced ')'." : "Unexpected character.";
+    }
+    return parseError;
+}
+
+/* ================================================================== */
+/*                        Evaluator                                   */
+/* ================================================================== */
+
+Num *stack;
+int stackCapacity;
+Num result; // Scratch destination for binary operations
+
+/**
+ * Runs the bytecode; the answer is left in stack[0].
+ * @return NULL on success, or an error message.
+ */
+const char *evaluate(const Program *p) {
+    if (p->maxDepth > stackCapacity) {
+        stack = realloc(stack, p->maxDepth * sizeof(Num));
+        if (stack == NULL) {
+            perror("realloc failed");
+            exit(1);
+        }
+        memset(stack + stackCapacity, 0, (p->maxDepth - stackCapacity) * sizeof(Num));
+        stackCapacity = p->maxDepth;
+    }
+
+    int top = 0;
+    for (int pc = 0; pc < p->length; pc++) {
+        uint32_t word = p->code[pc];
+        switch (word & 0xff) {
+        case OP_PUSH:
+            numCopy(&stack[top++], &p->consts[word >> 8]);
+            break;
+        case OP_NEG:
+            if (stack[top - 1].m.len) stack[top - 1].m.neg ^= 1;
+            break;
+        case OP_BINARY: {
+            const char *error = numBinary((char)(word >> 8), &result, &stack[top - 2], &stack[top - 1]);
+            if (error) return error;
+            top--;
+            numSwap(&stack[top - 1], &result);
+            break;
+        }
+        }
+    }
+    return NULL;
+}
+
+/* ================================================================== */
+/*                        Driver                                      */
+/* ================================================================== */
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void fillRandom(Big *x, int limbs, unsigned *seed) {
+    bigReserve(x, limbs);
+    for (int i = 0; i < limbs; i++) x->d[i] = rand_r(seed) % BASE;
+    x->d[limbs - 1] |= 1;
+    x->len = limbs;
+    x->neg = 0;
+}
+
+/**
+ * Times compile + evaluate + format over 'count' generated expressions,
+ * then compares Karatsuba with schoolbook on large operands.
+ */
+static void runBenchmark(int count) {
+    static const char ops[] = "+-*/%";
+    unsigned seed = 42;
+    size_t size = (size_t)count * 48 + 1;
+    char *text = malloc(size);
+    if (text == NULL) {
+        perror("malloc failed");
+        exit(1);
+    }
+    size_t used = 0;
+    for (int i = 0; i < count; i++) {
+        used += sprintf(text + used, "(%d %c %d) * %d.%d - %d\n",
+                        rand_r(&seed) % 100000, ops[rand_r(&seed) % 5], rand_r(&seed) % 999 + 1,
+                        rand_r(&seed) % 1000, rand_r(&seed) % 100, rand_r(&seed));
+    }
+
+    Program program = { 0 };
+    size_t checksum = 0;
+    double start = nowSeconds();
+    char *line = text;
+    for (int i = 0; i < count; i++) {
+        char *next = strchr(line, '\n') + 1;
+        if (compile(&program, line) == NULL && evaluate(&program) == NULL) {
+            checksum += strlen(numFormat(&stack[0]));
+        }
+        line = next;
+    }
+    double elapsed = nowSeconds() - start;
+    printf("--- Batch evaluation ---\n");
+    printf("%d expressions in %.3f s: %.0f expressions/s (checksum %zu)\n",
+           count, elapsed, count / elapsed, checksum);
+    free(text);
+
+    printf("\n--- Multiplication of two N-digit numbers ---\n");
+    printf("%10s %16s %16s\n", "digits", "schoolbook (ms)", "karatsuba (ms)");
+    Big a = { 0 }, b = { 0 }, r1 = { 0 }, r2 = { 0 };
+    for (int digits = 1000; digits <= 200000; digits *= 4) {
+        int limbs = digits / BASE_DIGITS;
+        fillRandom(&a, limbs, &seed);
+        fillRandom(&b, limbs, &seed);
+
+        int saved = karatsubaThreshold;
+        karatsubaThreshold = 1 << 30;
+        double t0 = nowSeconds();
+        bigMul(&r1, &a, &b);
+        double school = nowSeconds() - t0;
+
+        karatsubaThreshold = saved;
+        t0 = nowSeconds();
+        bigMul(&r2, &a, &b);
+        double karatsuba = nowSeconds() - t0;
+
+        int same = r1.len == r2.len && memcmp(r1.d, r2.d, r1.len * sizeof(uint32_t)) == 0;
+        printf("%10d %16.2f %16.2f %s\n", digits, school * 1e3, karatsuba * 1e3,
+               same ? "" : "MISMATCH");
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0) {
+        runBenchmark(argc >= 3 ? atoi(argv[2]) : 1000000);
+        return 0;
+    }
+    if (argc >= 2) {
+        printf("Usage: %s < expressions   (one per line)\n", argv[0]);
+        printf("       %s bench [count]\n", argv[0]);
+        return 1;
+    }
+
+    static char outBuffer[1 << 16];
+    setvbuf(stdout, outBuffer, _IOFBF, sizeof(outBuffer));
+
+    Program program = { 0 };
+    char *line = NULL;
+    size_t capacity = 0;
+    while (getline(&line, &capacity, stdin) != -1) {
+        // Blank lines map to blank lines so output stays aligned with input
+        const char *s = line;
+        while (isspace((unsigned char)*s)) s++;
+        if (*s == '\0') {
+            putchar('\n');
+            continue;
+        }
+
+        const char *error = compile(&program, line);
+        if (error == NULL) error = evaluate(&program);
+        if (error) {
+            printf("Error: %s\n", error);
+        } else {
+            puts(numFormat(&stack[0]));
+        }
+    }
+    free(line);
+    return 0;
+}
@@ -0,0 +1,309 @@
+/*
+ * C Program to demonstrate FAN-IN IPC: many producers, one consumer.
+ *
+ * pipe.c forks one child and does one blocking read(). Here the parent
+ * forks N worker processes, each with its OWN pipe, and every worker
+ * streams fixed-size records to the parent. The parent watches all the
+ * read ends with ONE epoll instance:
+ *
+ *  - read ends are non-blocking and registered EDGE-TRIGGERED, so each
+ *    readiness event is reported once and the parent drains that pipe
+ *    with large reads until EAGAIN;
+ *  - partial records at the end of a read are carried over per stream,
+ *    so the merged output only ever contains whole records;
+ *  - every record carries its send timestamp and sequence number, so the
+ *    parent measures per-message latency and checks per-stream order.
+ *
+ * The run is repeated for N = 1, 10, 100, 1000 producers to show how the
+ * aggregate throughput and latency scale.
+ *
+ * Usage: ./fanin [max_producers] [records_per_run] [records_per_write]
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>       // For exit(), malloc(), atoi()
+#include <string.h>       // For memcpy()
+#include <stdint.h>       // For uint64_t
+#include <errno.h>        // For errno, EAGAIN
+#include <fcntl.h>        // For fcntl(), O_NONBLOCK
+#include <unistd.h>       // For fork(), pipe(), read(), write(), close()
+#include <sys/epoll.h>    // For epoll_create1(), epoll_ctl(), epoll_wait()
+#include <sys/wait.h>     // For waitpid()
+#include <sys/resource.h> // For setrlimit(RLIMIT_NOFILE)
+#include <time.h>         // For clock_gettime()
+
+#define RECORD_SIZE 64
+#define READ_BUFFER (256 * 1024) // One big read drains many records
+#define MAX_EVENTS 256
+#define LATENCY_BUCKETS 40       // Power-of-two nanosecond buckets
+
+// One fixed-size record, exactly RECORD_SIZE bytes
+struct Record {
+    uint32_t worker;
+    uint32_t pad;
+    uint64_t seq;
+    uint64_t sentNs;
+    char payload[RECORD_SIZE - 24];
+};
+
+// Parent-side state of one stream
+struct Stream {
+    int fd;
+    uint64_t expectedSeq;
+    int carry;                 // Bytes of a partial record kept from the last read
+    char partial[RECORD_SIZE];
+    int open;
+};
+
+static uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// --- Merged-stream statistics ---
+long totalRecords;
+long outOfOrder;
+long latencyHistogram[LATENCY_BUCKETS];
+
+static void recordLatency(uint64_t ns) {
+    int bucket = 0;
+    while (bucket < LATENCY_BUCKETS - 1 && (1ull << (bucket + 1)) <= ns) bucket++;
+    latencyHistogram[bucket]++;
+}
+
+// Upper bound (in microseconds) of the bucket holding the given percentile
+static double latencyPercentile(double percentile) {
+    long target = (long)(totalRecords * percentile);
+    long seen = 0;
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += latencyHistogram[b];
+        if (seen > target) return (1ull << (b + 1)) / 1000.0;
+    }
+    return 0;
+}
+
+/**
+ * Worker process: writes 'count' records to its pipe, 'batch' per write().
+ */
+static void producer(int fd, int startFd, int id, long count, int batch) {
+    struct Record records[batch];
+    memset(records, 0, sizeof(records));
+
+    // Wait for the start signal: the parent closes the other end once
+    // every producer exists, so spawn time is not counted as latency.
+    char go;
+    while (read(startFd, &go, 1) < 0 && errno == EINTR);
+    close(startFd);
+
+    for (long seq = 0; seq < count; ) {
+        int n = 0;
+        uint64_t stamp = nowNs();
+        while (n < batch && seq < count) {
+            records[n].worker = id;
+            records[n].seq = seq++;
+            records[n].sentNs = stamp;
+            n++;
+        }
+
+        // Blocking write: the pipe applies back-pressure if the parent lags
+        size_t length = n * sizeof(struct Record);
+        size_t done = 0;
+        while (done < length) {
+            ssize_t w = write(fd, (char *)records + done, length - done);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                perror("write failed");
+                _exit(1);
+            }
+            done += w;
+        }
+    }
+    close(fd);
+    _exit(0);
+}
+
+// Processes one whole record from the merged stream
+static void consumeRecord(struct Stream *stream, const struct Record *r, uint64_t now) {
+    if (r->seq != stream->expectedSeq) outOfOrder++;
+    stream->expectedSeq = r->seq + 1;
+    totalRecords++;
+    recordLatency(now > r->sentNs ? now - r->sentNs : 0);
+}
+
+/**
+ * Drains one edge-triggered stream until EAGAIN (or EOF).
+ * @return 1 if the stream reached EOF.
+ */
+static int drainStream(struct Stream *stream, char *buffer) {
+    while (1) {
+        // Put the carried-over partial record in front of the new data
+        memcpy(buffer, stream->partial, stream->carry);
+        ssize_t n = read(stream->fd, buffer + stream->carry, READ_BUFFER - stream->carry);
+
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN) return 0; // Drained; wait for the next edge
+            perror("read failed");
+            exit(1);
+        }
+        if (n == 0) return 1;
+
+        size_t available = stream->carry + n;
+        size_t whole = available / RECORD_SIZE * RECORD_SIZE;
+        uint64_t now = nowNs();
+
+        for (size_t off = 0; off < whole; off += RECORD_SIZE) {
+            struct Record r;
+            memcpy(&r, buffer + off, RECORD_SIZE);
+            consumeRecord(stream, &r, now);
+        }
+
+        stream->carry = available - whole;
+        memcpy(stream->partial, buffer + whole, stream->carry);
+    }
+}
+
+/**
+ * One fan-in run with 'producers' workers.
+ */
+static void runFanIn(int producers, long perProducer, int batch) {
+    struct Stream *streams = calloc(producers, sizeof(struct Stream));
+    char *buffer = malloc(READ_BUFFER);
+    pid_t *pids = malloc(producers * sizeof(pid_t));
+    if (streams == NULL || buffer == NULL || pids == NULL) {
+        perror("malloc failed");
+        exit(1);
+    }
+
+    totalRecords = 0;
+    outOfOrder = 0;
+    memset(latencyHistogram, 0, sizeof(latencyHistogram));
+
+    int epfd = epoll_create1(0);
+    if (epfd == -1) {
+        perror("epoll_create1 failed");
+        exit(1);
+    }
+
+    // Every producer blocks on this pipe until the parent closes it
+    int startPipe[2];
+    if (pipe(startPipe) == -1) {
+        perror("Pipe failed");
+        exit(1);
+    }
+    fflush(stdout);
+
+    // STEP 1: One pipe + one child per producer
+    for (int i = 0; i < producers; i++) {
+        int fd[2];
+        if (pipe(fd) == -1) {
+            perror("Pipe failed");
+            exit(1);
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("Fork failed");
+            exit(1);
+        }
+        if (pid == 0) {
+            close(fd[0]);
+            close(startPipe[1]);
+            producer(fd[1], startPipe[0], i, perProducer, batch);
+        }
+
+        // Parent keeps only the read end, non-blocking, edge-triggered
+        pids[i] = pid;
+        close(fd[1]);
+        fcntl(fd[0], F_SETFL, fcntl(fd[0], F_GETFL) | O_NONBLOCK);
+
+        streams[i].fd = fd[0];
+        streams[i].open = 1;
+        struct epoll_event ev = { .events = EPOLLIN | EPOLLET | EPOLLRDHUP, .data.u32 = (uint32_t)i };
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd[0], &ev) == -1) {
+            perror("epoll_ctl failed");
+            exit(1);
+        }
+    }
+
+    // Everyone is ready: release the producers and start the clock
+    close(startPipe[0]);
+    uint64_t start = nowNs();
+    close(startPipe[1]);
+
+    // STEP 2: Merge every stream until they have all hit EOF
+    int openStreams = producers;
+    struct epoll_event events[MAX_EVENTS];
+    while (openStreams > 0) {
+        int ready = epoll_wait(epfd, events, MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait failed");
+            exit(1);
+        }
+
+        for (int e = 0; e < ready; e++) {
+            struct Stream *stream = &streams[events[e].data.u32];
+            if (!stream->open) continue;
+
+            if (drainStream(stream, buffer)) {
+                // EOF: closing the fd also removes it from the epoll set
+                close(stream->fd);
+                stream->open = 0;
+                openStreams--;
+            }
+        }
+    }
+
+    double seconds = (nowNs() - start) / 1e9;
+
+    // STEP 3: Reap every worker
+    for (int i = 0; i < producers; i++) {
+        waitpid(pids[i], NULL, 0);
+    }
+    close(epfd);
+
+    long expected = producers * perProducer;
+    printf("%-10d %12ld %14.0f %10.1f %10.1f %10.1f %s\n",
+           producers, totalRecords, totalRecords / seconds,
+           totalRecords * (double)RECORD_SIZE / seconds / 1e6,
+           latencyPercentile(0.50), latencyPercentile(0.99),
+           (totalRecords == expected && outOfOrder == 0) ? "ok" : "MISMATCH");
+
+    free(pids);
+    free(buffer);
+    free(streams);
+}
+
+int main(int argc, char *argv[]) {
+    int maxProducers = (argc >= 2) ? atoi(argv[1]) : 1000;
+    long perRun = (argc >= 3) ? atol(argv[2]) : 2000000;
+    int batch = (argc >= 4) ? atoi(argv[3]) : 16;
+
+    if (maxProducers <= 0 || perRun <= 0 || batch <= 0) {
+        printf("Usage: %s [max_producers] [records_per_run] [records_per_write]\n", argv[0]);
+        return 1;
+    }
+
+    // 1000 producers need 1000+ descriptors in the parent
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    printf("--- Fan-in over epoll: %ld records of %d bytes per run, %d per write ---\n",
+           perRun, RECORD_SIZE, batch);
+    printf("%-10s %12s %14s %10s %10s %10s %s\n",
+           "producers", "records", "records/s", "MB/s", "p50(us)", "p99(us)", "check");
+
+    for (int producers = 1; producers <= maxProducers; producers *= 10) {
+        // The same total volume is split across the producers
+        long each = perRun / producers;
+        if (each < 1) each = 1;
+        runFanIn(producers, each, batch);
+    }
+    return 0;
+}
@@ -0,0 +1,438 @@
+/*
+ * oskbench - microbenchmarks for every kernel in oskernels.h
+ *
+ * Each benchmark runs its kernel at several sizes. For every size it does
+ * one warm-up run and then REPS timed runs, and reports the minimum,
+ * median, mean and standard deviation, plus the median time per item
+ * (per process, per page reference, per lock operation, per byte...).
+ *
+ * With --json the results are also written as JSON, ONE RESULT PER LINE
+ * so files from different commits diff cleanly. --baseline compares this
+ * run against such a file and flags medians that got slower than the
+ * threshold, so a regression on any hot path is visible at a glance.
+ *
+ * Usage: ./oskbench [-r reps] [-f filter] [-s bench=n1,n2,...]
+ *                   [--json file] [--baseline file] [--threshold pct]
+ *
+ * Example: ./oskbench --json new.json --baseline old.json
+ *          ./oskbench -f lru -s lru=4,256 -r 30
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>    // For malloc(), qsort(), atoi()
+#include <string.h>    // For strcmp(), strstr(), memcpy()
+#include <math.h>      // For sqrt()
+#include <time.h>      // For clock_gettime(), time()
+#include <pthread.h>   // For the contended lock benchmark
+#include "oskernels.h"
+
+#define MAX_SIZES 8
+#define MAX_RESULTS 128
+#define DEFAULT_REPS 15
+
+static double nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// A deterministic generator, so every run benchmarks the same inputs
+static unsigned long long rngState = 88172645463325252ull;
+static unsigned nextRandom(void) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return (unsigned)(rngState >> 11);
+}
+
+/* ================================================================== */
+/*                 1. The benchmarks (prepare / run / release)        */
+/* ================================================================== */
+
+// One benchmark at one size. prepare() builds the input once; run() is
+// timed and must leave the input reusable; the result is "items" units.
+struct Case {
+    long size;
+    long items;
+    void *data;
+    long sink; // Results go here so nothing is optimized away
+};
+
+// --- Scheduling: FCFS and SRTF on `size` random processes ---
+
+struct SchedData {
+    struct OskProcess *input, *work;
+};
+
+static void prepareSched(struct Case *c, int maxBurst) {
+    struct SchedData *d = malloc(sizeof *d);
+    d->input = malloc(c->size * sizeof(struct OskProcess));
+    d->work = malloc(c->size * sizeof(struct OskProcess));
+    for (long i = 0; i < c->size; i++) {
+        d->input[i] = (struct OskProcess){ .pid = (int)i, .at = (int)(nextRandom() % (c->size * 4)),
+                                           .bt = 1 + (int)(nextRandom() % maxBurst) };
+    }
+    c->data = d;
+    c->items = c->size;
+}
+
+static void prepareFcfs(struct Case *c) { prepareSched(c, 20); }
+static void prepareSrtf(struct Case *c) { prepareSched(c, 10); }
+
+static void runFcfs(struct Case *c) {
+    struct SchedData *d = c->data;
+    memcpy(d->work, d->input, c->size * sizeof(struct OskProcess));
+    oskFcfs(d->work, (int)c->size);
+    c->sink += d->work[c->size - 1].ct;
+}
+
+static void runSrtf(struct Case *c) {
+    struct SchedData *d = c->data;
+    memcpy(d->work, d->input, c->size * sizeof(struct OskProcess));
+    oskSrtf(d->work, (int)c->size);
+    c->sink += d->work[0].ct;
+}
+
+static void releaseSched(struct Case *c) {
+    struct SchedData *d = c->data;
+    free(d->input);
+    free(d->work);
+    free(d);
+}
+
+// --- Paging: `size` frames, 100k references over 2 x size pages ---
+
+#define PAGE_REFS 100000
+
+static void preparePaging(struct Case *c) {
+    int *refs = malloc(PAGE_REFS * sizeof(int));
+    // Mostly a working set that fits, sometimes a page outside it
+    for (long i = 0; i < PAGE_REFS; i++) {
+        refs[i] = (int)(nextRandom() % 8 == 0 ? nextRandom() % (2 * c->size)
+                                               : nextRandom() % (c->size + c->size / 4 + 1));
+    }
+    c->data = refs;
+    c->items = PAGE_REFS;
+}
+
+static void runPaging(struct Case *c, bool (*access)(struct OskFrames *, int)) {
+    const int *refs = c->data;
+    struct OskFrames f;
+    if (!oskFramesInit(&f, (int)c->size)) return;
+    long faults = 0;
+    for (long i = 0; i < PAGE_REFS; i++) faults += access(&f, refs[i]);
+    oskFramesFree(&f);
+    c->sink += faults;
+}
+
+static void runFifo(struct Case *c) { runPaging(c, oskFifoAccess); }
+static void runLru(struct Case *c) { runPaging(c, oskLruAccess); }
+static void releaseFree(struct Case *c) { free(c->data); }
+
+// --- Banker: `size` processes, 8 resource types, a loaded safe state ---
+
+#define BANKER_M 8
+
+struct BankerData {
+    int available[BANKER_M];
+    int *allocation, *need, *sequence;
+};
+
+static void prepareBanker(struct Case *c) {
+    long n = c->size;
+    struct BankerData *d = malloc(sizeof *d);
+    d->allocation = malloc(n * BANKER_M * sizeof(int));
+    d->need = malloc(n * BANKER_M * sizeof(int));
+    d->sequence = malloc(n * sizeof(int));
+    for (int j = 0; j < BANKER_M; j++) d->available[j] = 10;
+    // Each process holds a little and needs a little more: safe, but the
+    // scan has to go round several times
+    for (long i = 0; i < n * BANKER_M; i++) {
+        d->allocation[i] = (int)(nextRandom() % 3);
+        d->need[i] = (int)(nextRandom() % 12);
+    }
+    c->data = d;
+    c->items = n;
+}
+
+static void runBanker(struct Case *c) {
+    struct BankerData *d = c->data;
+    c->sink += oskBankerIsSafe((int)c->size, BANKER_M, BANKER_M, d->available, d->allocation,
+                               d->need, NULL, -1, NULL, d->sequence);
+}
+
+static void releaseBanker(struct Case *c) {
+    struct BankerData *d = c->data;
+    free(d->allocation);
+    free(d->need);
+    free(d->sequence);
+    free(d);
+}
+
+// --- RW lock: `size` enter/exit pairs, alone and with 4 threads ---
+
+static struct OskRwLock benchLock;
+
+static void prepareRw(struct Case *c) {
+    oskRwInit(&benchLock);
+    c->items = c->size;
+}
+
+static void runRwRead(struct Case *c) {
+    for (long i = 0; i < c->size; i++) {
+        oskReadEnter(&benchLock);
+        oskReadExit(&benchLock);
+    }
+}
+
+static void runRwWrite(struct Case *c) {
+    for (long i = 0; i < c->size; i++) {
+        oskWriteEnter(&benchLock);
+        oskWriteExit(&benchLock);
+    }
+}
+
+#define RW_THREADS 4
+
+static void *rwMixedThread(void *arg) {
+    long pairs = *(long *)arg;
+    for (long i = 0; i < pairs; i++) {
+        if (i % 8 == 0) {
+            oskWriteEnter(&benchLock);
+            oskWriteExit(&benchLock);
+        } else {
+            oskReadEnter(&benchLock);
+            oskReadExit(&benchLock);
+        }
+    }
+    return NULL;
+}
+
+// 4 threads, 1 write in 8; items = all pairs of all threads
+static void runRwMixed(struct Case *c) {
+    pthread_t threads[RW_THREADS];
+    long pairs = c->size / RW_THREADS;
+    for (int t = 0; t < RW_THREADS; t++) pthread_create(&threads[t], NULL, rwMixedThread, &pairs);
+    for (int t = 0; t < RW_THREADS; t++) pthread_join(threads[t], NULL);
+}
+
+static void releaseRw(struct Case *c) {
+    (void)c;
+    oskRwDestroy(&benchLock);
+}
+
+// --- Pipe: `size` KiB chunks, 32 MiB per transfer ---
+
+#define PIPE_BYTES (32ll << 20)
+
+static void preparePipe(struct Case *c) { c->items = PIPE_BYTES; }
+
+static void runPipeVariant(struct Case *c, bool zeroCopy) {
+    if (oskPipeTransfer(PIPE_BYTES, c->size << 10, 1 << 20, zeroCopy, zeroCopy, NULL) < 0) {
+        perror("Pipe transfer failed");
+        exit(1);
+    }
+}
+
+// write -> read, and vmsplice -> splice (the two ends of ./pipe bulk)
+static void runPipe(struct Case *c) { runPipeVariant(c, false); }
+static void runPipeSplice(struct Case *c) { runPipeVariant(c, true); }
+
+static void releaseNothing(struct Case *c) { (void)c; }
+
+struct Benchmark {
+    const char *name;
+    const char *item;       // What one "item" is
+    long sizes[MAX_SIZES];  // 0-terminated
+    void (*prepare)(struct Case *);
+    void (*run)(struct Case *);
+    void (*release)(struct Case *);
+};
+
+static struct Benchmark benchmarks[] = {
+    { "fcfs", "process", { 100, 1000, 10000 }, prepareFcfs, runFcfs, releaseSched },
+    { "srtf", "process", { 10, 100, 1000 }, prepareSrtf, runSrtf, releaseSched },
+    { "fifo", "reference", { 4, 16, 64, 256 }, preparePaging, runFifo, releaseFree },
+    { "lru", "reference", { 4, 16, 64, 256 }, preparePaging, runLru, releaseFree },
+    { "banker", "process", { 100, 500, 2000 }, prepareBanker, runBanker, releaseBanker },
+    { "rw_read", "pair", { 100000 }, prepareRw, runRwRead, releaseRw },
+    { "rw_write", "pair", { 100000 }, prepareRw, runRwWrite, releaseRw },
+    { "rw_mixed4", "pair", { 100000 }, prepareRw, runRwMixed, releaseRw },
+    { "pipe", "byte", { 4, 64, 256 }, preparePipe, runPipe, releaseNothing },
+    { "pipe_splice", "byte", { 64, 256 }, preparePipe, runPipeSplice, releaseNothing },
+};
+#define NUM_BENCHMARKS (int)(sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+/* ================================================================== */
+/*                     2. Timing and statistics                       */
+/* ================================================================== */
+
+struct Result {
+    const char *name;
+    const char *item;
+    long size, items;
+    int reps;
+    double min, median, mean, stddev; // Nanoseconds per run
+};
+
+static int compareDouble(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static struct Result measure(struct Benchmark *b, long size, int reps) {
+    struct Case c = { .size = size };
+    b->prepare(&c);
+    b->run(&c); // Warm-up: caches, page faults, lazy allocation
+
+    double samples[reps];
+    for (int r = 0; r < reps; r++) {
+        double t0 = nowNs();
+        b->run(&c);
+        samples[r] = nowNs() - t0;
+    }
+    b->release(&c);
+
+    qsort(samples, reps, sizeof(double), compareDouble);
+    double sum = 0, squares = 0;
+    for (int r = 0; r < reps; r++) sum += samples[r];
+    double mean = sum / reps;
+    for (int r = 0; r < reps; r++) squares += (samples[r] - mean) * (samples[r] - mean);
+
+    struct Result res = { b->name, b->item, size, c.items, reps, samples[0],
+                          reps % 2 ? samples[reps / 2] : (samples[reps / 2 - 1] + samples[reps / 2]) / 2,
+                          mean, reps > 1 ? sqrt(squares / (reps - 1)) : 0 };
+    if (c.sink == 42424242) printf(" "); // Keep the results "used"
+    return res;
+}
+
+/* ================================================================== */
+/*                      3. JSON output and baselines                  */
+/* ================================================================== */
+
+static void writeJson(const char *path, struct Result results[], int count) {
+    FILE *out = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!out) {
+        perror("Opening JSON output failed");
+        exit(1);
+    }
+    fprintf(out, "{\"timestamp\": %ld, \"compiler\": \"%s\", \"results\": [\n", (long)time(NULL),
+            __VERSION__);
+    for (int i = 0; i < count; i++) {
+        struct Result *r = &results[i];
+        fprintf(out,
+                "{\"bench\": \"%s\", \"size\": %ld, \"items\": %ld, \"item\": \"%s\", \"reps\": %d, "
+                "\"min_ns\": %.0f, \"median_ns\": %.0f, \"mean_ns\": %.0f, \"stddev_ns\": %.0f, "
+                "\"ns_per_item\": %.4f}%s\n",
+                r->name, r->size, r->items, r->item, r->reps, r->min, r->median, r->mean, r->stddev,
+                r->median / r->items, i + 1 < count ? "," : "");
+    }
+    fprintf(out, "]}\n");
+    if (out != stdout) fclose(out);
+}
+
+/**
+ * Reads the medians of a file written by writeJson() and prints the
+ * change for every benchmark/size that appears in both.
+ * @return Number of regressions beyond `threshold` percent.
+ */
+static int compareBaseline(const char *path, struct Result results[], int count, double threshold) {
+    FILE *in = fopen(path, "r");
+    if (!in) {
+        perror("Opening baseline failed");
+        exit(1);
+    }
+    printf("\n--- Against %s (threshold %.0f%%) ---\n", path, threshold);
+    int regressions = 0, matched = 0;
+    char line[1024], name[64];
+    long size;
+    double median;
+    while (fgets(line, sizeof line, in)) {
+        const char *p = strstr(line, "{\"bench\": \"");
+        if (!p || sscanf(p, "{\"bench\": \"%63[^\"]\", \"size\": %ld", name, &size) != 2) continue;
+        const char *m = strstr(line, "\"median_ns\": ");
+        if (!m || sscanf(m, "\"median_ns\": %lf", &median) != 1 || median <= 0) continue;
+        for (int i = 0; i < count; i++) {
+            if (strcmp(results[i].name, name) != 0 || results[i].size != size) continue;
+            double change = 100.0 * (results[i].median - median) / median;
+            bool slower = change > threshold;
+            printf("%-12s %8ld %+8.1f%%%s\n", name, size, change, slower ? "  REGRESSION" : "");
+            regressions += slower;
+            matched++;
+        }
+    }
+    fclose(in);
+    printf("%d compared, %d regression%s\n", matched, regressions, regressions == 1 ? "" : "s");
+    return regressions;
+}
+
+/* ================================================================== */
+/*                              4. main                               */
+/* ================================================================== */
+
+// -s bench=n1,n2,...: replaces the sizes of one benchmark
+static void overrideSizes(const char *spec) {
+    const char *eq = strchr(spec, '=');
+    for (int b = 0; eq && b < NUM_BENCHMARKS; b++) {
+        if (strncmp(benchmarks[b].name, spec, eq - spec) != 0 || benchmarks[b].name[eq - spec] != '\0') {
+            continue;
+        }
+        int k = 0;
+        for (const char *p = eq + 1; *p && k < MAX_SIZES - 1;) {
+            char *end;
+            long v = strtol(p, &end, 10);
+            if (end == p) break;
+            if (v > 0) benchmarks[b].sizes[k++] = v;
+            p = *end == ',' ? end + 1 : end;
+        }
+        benchmarks[b].sizes[k] = 0;
+        return;
+    }
+    fprintf(stderr, "Unknown benchmark in -s %s\n", spec);
+    exit(1);
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "Usage: %s [-r reps] [-f filter] [-s bench=n1,n2,...] [--json file] "
+                    "[--baseline file] [--threshold pct]\n", name);
+    exit(1);
+}
+
+int main(int argc, char *argv[]) {
+    int reps = DEFAULT_REPS;
+    const char *filter = NULL, *jsonPath = NULL, *baseline = NULL;
+    double threshold = 10;
+
+    for (int a = 1; a < argc; a++) {
+        if (a + 1 >= argc) usage(argv[0]);
+        if (strcmp(argv[a], "-r") == 0) reps = atoi(argv[++a]);
+        else if (strcmp(argv[a], "-f") == 0) filter = argv[++a];
+        else if (strcmp(argv[a], "-s") == 0) overrideSizes(argv[++a]);
+        else if (strcmp(argv[a], "--json") == 0) jsonPath = argv[++a];
+        else if (strcmp(argv[a], "--baseline") == 0) baseline = argv[++a];
+        else if (strcmp(argv[a], "--threshold") == 0) threshold = atof(argv[++a]);
+        else usage(argv[0]);
+    }
+    if (reps < 1) usage(argv[0]);
+
+    struct Result results[MAX_RESULTS];
+    int count = 0;
+    printf("%-12s %8s %6s %12s %12s %12s %10s %14s\n", "bench", "size", "reps", "min(us)",
+           "median(us)", "mean(us)", "stddev%", "ns/item");
+    for (int b = 0; b < NUM_BENCHMARKS; b++) {
+        if (filter && !strstr(benchmarks[b].name, filter)) continue;
+        for (int k = 0; k < MAX_SIZES && benchmarks[b].sizes[k] > 0 && count < MAX_RESULTS; k++) {
+            struct Result r = measure(&benchmarks[b], benchmarks[b].sizes[k], reps);
+            results[count++] = r;
+            printf("%-12s %8ld %6d %12.2f %12.2f %12.2f %9.1f%% %10.3f/%s\n", r.name, r.size, r.reps,
+                   r.min / 1e3, r.median / 1e3, r.mean / 1e3, 100 * r.stddev / r.mean,
+                   r.median / r.items, r.item);
+            fflush(stdout);
+        }
+    }
+
+    if (jsonPath) writeJson(jsonPath, results, count);
+    int regressions = baseline ? compareBaseline(baseline, results, count, threshold) : 0;
+    return regressions ? 2 : 0;
+}
@@ -0,0 +1,348 @@
+/*
+ * oskernels.c - implementations of the kernels declared in oskernels.h
+ *
+ * Each function is the loop from the program named in its comment, with
+ * the scanf()/printf() calls removed. Keep them in step: the CLIs print
+ * from what these functions compute.
+ */
+
+#define _GNU_SOURCE   // For F_SETPIPE_SZ, vmsplice() and splice()
+#include "oskernels.h"
+
+#include <stdio.h>
+#include <stdlib.h>   // For malloc(), free()
+#include <string.h>   // For memset()
+#include <errno.h>    // For errno, EPIPE
+#include <limits.h>   // For INT_MAX
+#include <fcntl.h>    // For fcntl(), F_SETPIPE_SZ, splice()
+#include <sys/uio.h>  // For struct iovec, vmsplice()
+#include <time.h>     // For clock_gettime()
+#include <unistd.h>   // For pipe(), fork(), read(), write()
+#include <sys/wait.h> // For waitpid()
+
+/* ------------------------------------------------------------------ */
+/*                     CPU scheduling (FCFS.c, SRTF.c)                */
+/* ------------------------------------------------------------------ */
+
+void oskFcfs(struct OskProcess p[], int n) {
+    // Sort by arrival time with FCFS.c's exchange sort. It is not stable:
+    // processes arriving together can change places, and the results
+    // depend on it, so keep this exact order of comparisons and swaps
+    for (int j = 0; j < n; j++) {
+        for (int k = j + 1; k < n; k++) {
+            if (p[j].at > p[k].at) {
+                struct OskProcess temp = p[j];
+                p[j] = p[k];
+                p[k] = temp;
+            }
+        }
+    }
+
+    // Each process starts when it arrives or when the previous one ends
+    for (int i = 0; i < n; i++) {
+        if (i == 0 || p[i].at > p[i - 1].ct) {
+            p[i].st = p[i].at;
+        } else {
+            p[i].st = p[i - 1].ct;
+        }
+        p[i].ct = p[i].st + p[i].bt;
+        p[i].wt = p[i].st - p[i].at;
+        p[i].tat = p[i].wt + p[i].bt;
+    }
+}
+
+void oskSrtf(struct OskProcess p[], int n) {
+    for (int i = 0; i < n; i++) p[i].rt = p[i].bt;
+
+    int current_time = 0;
+    int completed = 0;
+    while (completed < n) {
+        // --- 1. Find the arrived process with the least remaining time ---
+        int shortest_index = -1;
+        int shortest_rt = INT_MAX;
+        for (int i = 0; i < n; i++) {
+            if (p[i].at <= current_time && p[i].rt > 0 && p[i].rt < shortest_rt) {
+                shortest_rt = p[i].rt;
+                shortest_index = i;
+            }
+        }
+
+        // --- 2. Run it for one time unit (or idle) ---
+        current_time++;
+        if (shortest_index == -1) continue;
+        struct OskProcess *q = &p[shortest_index];
+        if (--q->rt == 0) {
+            // --- 3. It finished ---
+            completed++;
+            q->ct = current_time;
+            q->tat = q->ct - q->at;
+            q->wt = q->tat - q->bt;
+        }
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/*                  Page replacement (PgFCFS.c, pgLRU.c)              */
+/* ------------------------------------------------------------------ */
+
+bool oskFramesInit(struct OskFrames *f, int count) {
+    f->count = count;
+    f->frames = malloc(count * sizeof(int));
+    f->lastUsed = calloc(count, sizeof(long));
+    f->victim = 0;
+    f->clock = 0;
+    if (f->frames == NULL || f->lastUsed == NULL) {
+        oskFramesFree(f);
+        return false;
+    }
+    for (int i = 0; i < count; i++) f->frames[i] = -1;
+    return true;
+}
+
+void oskFramesFree(struct OskFrames *f) {
+    free(f->frames);
+    free(f->lastUsed);
+    f->frames = NULL;
+    f->lastUsed = NULL;
+}
+
+bool oskFifoAccess(struct OskFrames *f, int page) {
+    // 1. Search if page is already in a frame
+    for (int j = 0; j < f->count; j++) {
+        if (f->frames[j] == page) return false; // Hit! No fault.
+    }
+
+    // 2. Page fault: replace the frame the FIFO pointer is at
+    f->frames[f->victim] = page;
+    f->victim = (f->victim + 1) % f->count;
+    return true;
+}
+
+bool oskLruAccess(struct OskFrames *f, int page) {
+    f->clock++; // Our global "clock", one tick per reference
+
+    // 1. Search if page is already in a frame; a hit refreshes its time
+    for (int j = 0; j < f->count; j++) {
+        if (f->frames[j] == page) {
+            f->lastUsed[j] = f->clock;
+            return false;
+        }
+    }
+
+    // 2. Page fault: first empty frame, else the least recently used one
+    int target = -1;
+    for (int j = 0; j < f->count; j++) {
+        if (f->frames[j] == -1) {
+            target = j;
+            break;
+        }
+    }
+    if (target == -1) {
+        target = 0;
+        for (int j = 1; j < f->count; j++) {
+            if (f->lastUsed[j] < f->lastUsed[target]) target = j;
+        }
+    }
+    f->frames[target] = page;
+    f->lastUsed[target] = f->clock;
+    return true;
+}
+
+/* ------------------------------------------------------------------ */
+/*                      Banker's algorithm (Bankers.c)                */
+/* ------------------------------------------------------------------ */
+
+bool oskBankerIsSafe(int n, int m, int stride, const int available[], const int allocation[],
+                     const int need[], const bool active[], int processID, const int request[],
+                     int safeSequence[]) {
+    // On the stack, like the verbose path in Bankers.c: this runs once per
+    // request, and there is no allocation to fail and be mistaken for
+    // "unsafe"
+    int work[m];
+    int rowNeed[m];  // Overlaid Need/Allocation row
+    int rowAlloc[m]; // of the requesting process
+    bool finish[n ? n : 1];
+    for (int j = 0; j < m; j++) {
+        int delta = processID >= 0 ? request[j] : 0;
+        work[j] = available[j] - delta;
+        if (processID >= 0) {
+            rowNeed[j] = need[(size_t)processID * stride + j] - delta;
+            rowAlloc[j] = allocation[(size_t)processID * stride + j] + delta;
+        }
+    }
+
+    int completed = 0;
+    for (int p = 0; p < n; p++) {
+        finish[p] = active != NULL && !active[p];
+        if (finish[p]) completed++;
+    }
+
+    int found = 0;
+    bool safe = true;
+    while (completed < n) {
+        bool foundProcess = false;
+        for (int p = 0; p < n; p++) {
+            if (finish[p]) continue;
+
+            // Need[p] <= Work ?
+            const int *row = p == processID ? rowNeed : need + (size_t)p * stride;
+            int j = 0;
+            while (j < m && row[j] <= work[j]) j++;
+            if (j < m) continue;
+
+            // "Run" it: it gives back its allocation
+            const int *held = p == processID ? rowAlloc : allocation + (size_t)p * stride;
+            for (j = 0; j < m; j++) work[j] += held[j];
+            finish[p] = true;
+            safeSequence[found++] = p;
+            completed++;
+            foundProcess = true;
+        }
+        if (!foundProcess) {
+            safe = false;
+            break;
+        }
+    }
+    return safe;
+}
+
+/* ------------------------------------------------------------------ */
+/*                     Readers-writers lock (RW.c)                    */
+/* ------------------------------------------------------------------ */
+
+int oskRwInit(struct OskRwLock *l) {
+    l->readCount = 0;
+    // 'wrt' starts at 1 (unlocked), allowing one Writer or the first Reader.
+    if (sem_init(&l->wrt, 0, 1) == -1) return -1;
+    // 'mutex' starts at 1 (unlocked), protecting 'readCount'.
+    if (sem_init(&l->mutex, 0, 1) == -1) {
+        sem_destroy(&l->wrt);
+        return -1;
+    }
+    return 0;
+}
+
+void oskRwDestroy(struct OskRwLock *l) {
+    sem_destroy(&l->wrt);
+    sem_destroy(&l->mutex);
+}
+
+bool oskReadEnter(struct OskRwLock *l) {
+    sem_wait(&l->mutex);
+    bool first = ++l->readCount == 1;
+    if (first) {
+        sem_wait(&l->wrt); // The first reader locks out writers
+    }
+    sem_post(&l->mutex);
+    return first;
+}
+
+bool oskReadExit(struct OskRwLock *l) {
+    sem_wait(&l->mutex);
+    bool last = --l->readCount == 0;
+    if (last) {
+        sem_post(&l->wrt); // The last reader lets writers in
+    }
+    sem_post(&l->mutex);
+    return last;
+}
+
+void oskWriteEnter(struct OskRwLock *l) {
+    sem_wait(&l->wrt);
+}
+
+void oskWriteExit(struct OskRwLock *l) {
+    sem_post(&l->wrt);
+}
+
+/* ------------------------------------------------------------------ */
+/*                          Pipe transfer (pipe.c)                    */
+/* ------------------------------------------------------------------ */
+
+// Child side: push `total` bytes from `buffer` into the pipe
+static bool pipeProduce(int fd, char *buffer, long long chunk, long long total, bool useVmsplice) {
+    for (long long sent = 0; sent < total;) {
+        long long want = total - sent < chunk ? total - sent : chunk;
+        ssize_t n;
+        if (useVmsplice) {
+            // The buffer is never modified, so its pages can be handed to
+            // the pipe by reference instead of being copied
+            struct iovec iov = { buffer, (size_t)want };
+            n = vmsplice(fd, &iov, 1, 0);
+        } else {
+            n = write(fd, buffer, (size_t)want);
+        }
+        if (n < 0) return false;
+        sent += n;
+    }
+    return true;
+}
+
+// Parent side: drain the pipe until EOF. @return Bytes seen, or -1
+static long long pipeConsume(int fd, char *buffer, long long chunk, bool useSplice, int devNull) {
+    long long received = 0;
+    while (1) {
+        ssize_t n;
+        if (useSplice) {
+            n = splice(fd, NULL, devNull, NULL, (size_t)chunk, SPLICE_F_MOVE | SPLICE_F_MORE);
+        } else {
+            n = read(fd, buffer, (size_t)chunk);
+        }
+        if (n < 0) return -1;
+        if (n == 0) return received; // Child closed its end: EOF
+        received += n;
+    }
+}
+
+double oskPipeTransfer(long long total, long long chunk, int pipeSize, bool useVmsplice,
+                       bool useSplice, int *actualPipeSize) {
+    int fd[2];
+    if (pipe(fd) == -1) return -1;
+    // Bigger pipes mean fewer wakeups between writer and reader
+    if (pipeSize > 0) fcntl(fd[1], F_SETPIPE_SZ, pipeSize); // Best effort
+    if (actualPipeSize != NULL) *actualPipeSize = fcntl(fd[1], F_GETPIPE_SZ);
+
+    char *buffer = malloc((size_t)chunk);
+    int devNull = useSplice ? open("/dev/null", O_WRONLY) : -1;
+    if (buffer == NULL || (useSplice && devNull == -1)) {
+        free(buffer);
+        close(fd[0]);
+        close(fd[1]);
+        return -1;
+    }
+    memset(buffer, 'x', (size_t)chunk);
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    fflush(stdout); // Do not let the child inherit buffered output
+    pid_t pid = fork();
+    if (pid < 0) {
+        free(buffer);
+        close(fd[0]);
+        close(fd[1]);
+        if (devNull != -1) close(devNull);
+        return -1;
+    }
+    if (pid == 0) {
+        // CHILD: write end only
+        close(fd[0]);
+        _exit(pipeProduce(fd[1], buffer, chunk, total, useVmsplice) ? 0 : 1);
+    }
+
+    // PARENT: drain while the child writes, wait only after EOF
+    close(fd[1]);
+    long long received = pipeConsume(fd[0], buffer, chunk, useSplice, devNull);
+    int error = errno;
+    close(fd[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (devNull != -1) close(devNull);
+    free(buffer);
+
+    if (received != total) {
+        errno = received < 0 ? error : EPIPE;
+        return -1;
+    }
+    return (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+}
@@ -0,0 +1,127 @@
+/*
+ * oskernels.h - the hot loops of the simulators, as a library
+ *
+ * Each program here used to keep its algorithm inside main(), between
+ * the scanf()s and the printf()s, so nothing could be timed or reused on
+ * its own. The kernels below are those loops with the I/O taken out.
+ * The CLIs (FCFS, SRTF, PgFCFS, pgLRU, RW, Bankers, pipe) call them, and
+ * oskbench times them at several sizes.
+ *
+ * Build: make            (libosk.a, every CLI, and oskbench)
+ *        make bench      (runs oskbench and writes bench.json)
+ */
+
+#ifndef OSKERNELS_H
+#define OSKERNELS_H
+
+#include <stdbool.h>
+#include <semaphore.h>
+
+/* ------------------------------------------------------------------ */
+/*                          CPU scheduling                            */
+/* ------------------------------------------------------------------ */
+
+struct OskProcess {
+    int pid;
+    int at;  // Arrival Time
+    int bt;  // Burst Time
+    int st;  // Start Time (FCFS)
+    int ct;  // Completion Time
+    int tat; // Turnaround Time
+    int wt;  // Waiting Time
+    int rt;  // Remaining Time (SRTF)
+};
+
+/**
+ * FCFS: sorts p[] by arrival time and fills in st, ct, tat and wt,
+ * exactly like FCFS.c. Same unstable exchange sort, so processes that
+ * arrive together end up in the same order too.
+ */
+void oskFcfs(struct OskProcess p[], int n);
+
+/**
+ * SRTF (preemptive SJF): the unit-time clock loop of SRTF.c. Every tick
+ * the arrived process with the least remaining time runs (lowest index
+ * on ties). Fills in ct, tat and wt; p[] keeps its order.
+ */
+void oskSrtf(struct OskProcess p[], int n);
+
+/* ------------------------------------------------------------------ */
+/*                         Page replacement                           */
+/* ------------------------------------------------------------------ */
+
+struct OskFrames {
+    int count;       // Number of page frames
+    int *frames;     // Page held by each frame, -1 = empty
+    long *lastUsed;  // LRU: "time" of the last access per frame
+    int victim;      // FIFO: the next frame to replace
+    long clock;      // LRU: advanced on every access
+};
+
+// Allocates `count` empty frames. @return false if out of memory.
+bool oskFramesInit(struct OskFrames *f, int count);
+void oskFramesFree(struct OskFrames *f);
+
+// One reference under FIFO (PgFCFS.c). @return true on a page fault.
+bool oskFifoAccess(struct OskFrames *f, int page);
+
+// One reference under LRU (pgLRU.c). @return true on a page fault.
+bool oskLruAccess(struct OskFrames *f, int page);
+
+/* ------------------------------------------------------------------ */
+/*                        Banker's algorithm                          */
+/* ------------------------------------------------------------------ */
+
+/**
+ * The quiet safety check of Bankers.c (its generic path calls this):
+ * n process slots, m resource types, allocation and need stored row by
+ * row with `stride` ints per row. Same scan order, so the same safe
+ * sequence.
+ * @param active    active[p] false = slot already finished; NULL = all active.
+ * @param processID Process whose `request` is granted hypothetically
+ *                  (Available - request, Need - request, Allocation +
+ *                  request on its row), or -1 to check the state as is.
+ * @return true if safe (safeSequence then holds every active process).
+ */
+bool oskBankerIsSafe(int n, int m, int stride, const int available[], const int allocation[],
+                     const int need[], const bool active[], int processID, const int request[],
+                     int safeSequence[]);
+
+/* ------------------------------------------------------------------ */
+/*                Readers-writers lock (readers priority)             */
+/* ------------------------------------------------------------------ */
+
+struct OskRwLock {
+    sem_t wrt;       // Held by a writer, or by the readers as a group
+    sem_t mutex;     // Protects readCount
+    int readCount;   // Readers inside the critical section
+};
+
+// @return 0, or -1 with errno set.
+int oskRwInit(struct OskRwLock *l);
+void oskRwDestroy(struct OskRwLock *l);
+
+// Entry/exit sections of RW.c. @return true for the first/last reader.
+bool oskReadEnter(struct OskRwLock *l);
+bool oskReadExit(struct OskRwLock *l);
+void oskWriteEnter(struct OskRwLock *l);
+void oskWriteExit(struct OskRwLock *l);
+
+/* ------------------------------------------------------------------ */
+/*                           Pipe transfer                            */
+/* ------------------------------------------------------------------ */
+
+/**
+ * Streams `total` bytes from a forked child to this process through a
+ * pipe, `chunk` bytes per call, reading while the child writes. This is
+ * what `./pipe bulk` times.
+ * @param pipeSize    F_SETPIPE_SZ value, or 0 to keep the default.
+ * @param useVmsplice Child hands its pages to the pipe instead of write().
+ * @param useSplice   Parent moves pipe pages to /dev/null instead of read().
+ * @param actualPipeSize If not NULL, receives the pipe size really used.
+ * @return Seconds taken, or -1 (errno set) on failure.
+ */
+double oskPipeTransfer(long long total, long long chunk, int pipeSize, bool useVmsplice,
+                       bool useSplice, int *actualPipeSize);
+
+#endif
@@ -0,0 +1,536 @@
+/*
+ * Capture PAGE REFERENCE TRACES from running code and feed them to the
+ * page replacement simulators (PgFCFS.c, pgLRU.c, uffdPager.c).
+ *
+ * Two ways to see which pages a program touches:
+ *
+ *  self   EXACT, via mprotect + SIGSEGV. A built-in workload runs on an
+ *         arena whose pages are all PROT_NONE. Every touch of a protected
+ *         page traps; the handler records the page, opens it, and closes
+ *         the page that was opened W faults ago. Only the W most recently
+ *         opened pages are accessible, so W (the "window", >= 2) trades
+ *         accuracy for speed: re-touching one of them is not recorded.
+ *  exec   SAMPLED, for any program, via soft-dirty bits. Every interval we
+ *         clear the bits (/proc/PID/clear_refs) and then read which pages
+ *         of its writable mappings were written (/proc/PID/pagemap, bit
+ *         55). Writes only, and the order inside an interval is unknown
+ *         (pages come out in address order), but the target runs at full
+ *         speed. Needs a kernel with CONFIG_MEM_SOFT_DIRTY.
+ *
+ * The trace file is compact: a small header, then one varint per
+ * reference holding the zig-zag encoded DIFFERENCE from the previous
+ * page, so sequential scans cost one byte per reference.
+ *
+ * Usage: ./pageTrace self [-w window] [-o file] scan|matmul|sort|random N
+ *        ./pageTrace exec [-i interval_ms] [-o file] program [args...]
+ *        ./pageTrace dump file frames [max]   print simulator input
+ *        ./pageTrace stats file
+ *
+ * Example: ./pageTrace self -o mm.trc matmul 64
+ *          ./pageTrace dump mm.trc 8 | ./uffdPager lru
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>       // For malloc(), exit(), atoi()
+#include <string.h>       // For strcmp(), memset()
+#include <stdint.h>       // For uint64_t
+#include <errno.h>        // For errno
+#include <fcntl.h>        // For open()
+#include <signal.h>       // For sigaction()
+#include <time.h>         // For clock_gettime(), nanosleep()
+#include <unistd.h>       // For fork(), execvp(), pread()
+#include <sys/mman.h>     // For mmap(), mprotect()
+#include <sys/ptrace.h>   // For PTRACE_TRACEME: stop the target right after exec
+#include <sys/types.h>    // For pid_t
+#include <sys/wait.h>     // For waitpid()
+
+#define TRACE_MAGIC "PGTR"
+#define TRACE_VERSION 1
+#define DEFAULT_CAPACITY (1L << 24) // References kept by `self` mode
+#define MAX_WINDOW 64
+
+// File header; the varint stream follows it
+struct TraceHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t pageSize;
+    uint32_t flags;       // TRACE_SAMPLED: order inside an interval is lost
+    uint64_t count;       // Number of references
+};
+#define TRACE_SAMPLED 1
+
+static long pageSize;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* ================================================================== */
+/*                        1. Writing and reading traces               */
+/* ================================================================== */
+
+/**
+ * Writes the references to `path` as zig-zag varint deltas.
+ * @return Bytes written.
+ */
+static long writeTrace(const char *path, const uint64_t *pages, uint64_t count, uint32_t flags) {
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror("Opening trace file failed");
+        exit(1);
+    }
+    struct TraceHeader h = { .version = TRACE_VERSION, .pageSize = (uint32_t)pageSize,
+                             .flags = flags, .count = count };
+    memcpy(h.magic, TRACE_MAGIC, 4);
+    fwrite(&h, sizeof h, 1, f);
+
+    long bytes = sizeof h;
+    uint64_t previous = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        int64_t delta = (int64_t)(pages[i] - previous);
+        uint64_t z = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63); // Zig-zag
+        previous = pages[i];
+        do {
+            unsigned char byte = z & 0x7f;
+            z >>= 7;
+            if (z) byte |= 0x80;
+            putc(byte, f);
+            bytes++;
+        } while (z);
+    }
+    if (fclose(f) != 0) {
+        perror("Writing trace file failed");
+        exit(1);
+    }
+    return bytes;
+}
+
+/**
+ * Reads a whole trace back into memory.
+ * @return The page numbers (caller frees); header in *h.
+ */
+static uint64_t *readTrace(const char *path, struct TraceHeader *h) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror("Opening trace file failed");
+        exit(1);
+    }
+    if (fread(h, sizeof *h, 1, f) != 1 || memcmp(h->magic, TRACE_MAGIC, 4) != 0 ||
+        h->version != TRACE_VERSION) {
+        fprintf(stderr, "%s is not a page trace\n", path);
+        exit(1);
+    }
+    uint64_t *pages = malloc((h->count ? h->count : 1) * sizeof(uint64_t));
+    if (!pages) {
+        perror("Allocation failed");
+        exit(1);
+    }
+    uint64_t previous = 0;
+    for (uint64_t i = 0; i < h->count; i++) {
+        uint64_t z = 0;
+        int shift = 0, c;
+        do {
+            c = getc(f);
+            if (c == EOF) {
+                fprintf(stderr, "%s is truncated\n", path);
+                exit(1);
+            }
+            z |= (uint64_t)(c & 0x7f) << shift;
+            shift += 7;
+        } while (c & 0x80);
+        int64_t delta = (int64_t)(z >> 1) ^ -(int64_t)(z & 1);
+        previous += (uint64_t)delta;
+        pages[i] = previous;
+    }
+    fclose(f);
+    return pages;
+}
+
+/* ================================================================== */
+/*                   2. `self`: exact tracing with mprotect           */
+/* ================================================================== */
+
+static char *arena;
+static size_t arenaPages;
+static uint64_t *trace;
+static volatile uint64_t traceCount;
+static uint64_t traceCapacity = DEFAULT_CAPACITY;
+static volatile int tracing = 0;
+
+static size_t openPages[MAX_WINDOW]; // Ring of accessible pages
+static int window = 2, openCount = 0, openHead = 0;
+
+// SIGSEGV handler: record the page, open it, close the oldest open one
+static void onFault(int sig, siginfo_t *info, void *context) {
+    (void)context;
+    char *address = info->si_addr;
+    if (!tracing || address < arena || address >= arena + arenaPages * pageSize) {
+        signal(sig, SIG_DFL); // A real crash: let it happen
+        return;
+    }
+    size_t page = (size_t)(address - arena) / pageSize;
+    if (traceCount < traceCapacity) {
+        trace[traceCount++] = page;
+    } else {
+        // Buffer full: stop tracing and open everything
+        tracing = 0;
+        mprotect(arena, arenaPages * pageSize, PROT_READ | PROT_WRITE);
+        return;
+    }
+
+    mprotect(arena + page * pageSize, pageSize, PROT_READ | PROT_WRITE);
+    if (openCount == window) {
+        mprotect(arena + openPages[openHead] * pageSize, pageSize, PROT_NONE);
+    } else {
+        openCount++;
+    }
+    openPages[openHead] = page;
+    openHead = (openHead + 1) % window;
+}
+
+// --- The workloads: each runs on the arena (bytes = arenaBytes(N)) ---
+
+static size_t arenaBytes(const char *name, long n) {
+    if (strcmp(name, "matmul") == 0) return 3 * (size_t)n * n * sizeof(double);
+    if (strcmp(name, "sort") == 0) return (size_t)n * sizeof(int);
+    return (size_t)n * pageSize; // scan, random: N pages
+}
+
+// Heapsort in place, so nothing is copied off the arena
+static void siftDown(int *a, long start, long end) {
+    long root = start;
+    while (2 * root + 1 <= end) {
+        long child = 2 * root + 1;
+        if (child + 1 <= end && a[child] < a[child + 1]) child++;
+        if (a[root] >= a[child]) return;
+        int t = a[root];
+        a[root] = a[child];
+        a[child] = t;
+        root = child;
+    }
+}
+
+static void runWorkload(const char *name, long n) {
+    if (strcmp(name, "scan") == 0) {
+        // Two sequential passes: the classic case that defeats small LRU caches
+        for (int pass = 0; pass < 2; pass++) {
+            for (long i = 0; i < n; i++) arena[i * pageSize] += 1;
+        }
+    } else if (strcmp(name, "random") == 0) {
+        unsigned x = 12345;
+        for (long i = 0; i < 4 * n; i++) {
+            x = x * 1103515245 + 12345;
+            arena[((x >> 8) % n) * pageSize] += 1;
+        }
+    } else if (strcmp(name, "matmul") == 0) {
+        double *a = (double *)arena, *b = a + n * n, *c = b + n * n;
+        for (long i = 0; i < n * n; i++) a[i] = 1, b[i] = 2;
+        for (long i = 0; i < n; i++) {
+            for (long j = 0; j < n; j++) {
+                double sum = 0;
+                for (long k = 0; k < n; k++) sum += a[i * n + k] * b[k * n + j];
+                c[i * n + j] = sum;
+            }
+        }
+    } else if (strcmp(name, "sort") == 0) {
+        int *a = (int *)arena;
+        unsigned x = 1;
+        for (long i = 0; i < n; i++) a[i] = (int)((x = x * 1103515245 + 12345) >> 1);
+        for (long start = n / 2 - 1; start >= 0; start--) siftDown(a, start, n - 1);
+        for (long end = n - 1; end > 0; end--) {
+            int t = a[0];
+            a[0] = a[end];
+            a[end] = t;
+            siftDown(a, 0, end - 1);
+        }
+    } else {
+        fprintf(stderr, "Unknown workload %s (scan, matmul, sort, random)\n", name);
+        exit(1);
+    }
+}
+
+static void traceSelf(const char *name, long n, const char *path) {
+    size_t bytes = arenaBytes(name, n);
+    arenaPages = (bytes + pageSize - 1) / pageSize;
+    arena = mmap(NULL, arenaPages * pageSize, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    trace = malloc(traceCapacity * sizeof(uint64_t));
+    if (arena == MAP_FAILED || !trace) {
+        perror("Allocation failed");
+        exit(1);
+    }
+
+    // 1. Untraced run, for the overhead figure
+    double start = nowSeconds();
+    runWorkload(name, n);
+    double plain = nowSeconds() - start;
+
+    // 2. Traced run on a fresh, fully protected arena
+    struct sigaction sa;
+    memset(&sa, 0, sizeof sa);
+    sa.sa_sigaction = onFault;
+    sa.sa_flags = SA_SIGINFO;
+    sigaction(SIGSEGV, &sa, NULL);
+
+    memset(arena, 0, arenaPages * pageSize);
+    mprotect(arena, arenaPages * pageSize, PROT_NONE);
+    tracing = 1;
+    start = nowSeconds();
+    runWorkload(name, n);
+    double traced = nowSeconds() - start;
+    int truncated = !tracing;
+    tracing = 0;
+    mprotect(arena, arenaPages * pageSize, PROT_READ | PROT_WRITE);
+
+    long fileBytes = writeTrace(path, trace, traceCount, 0);
+    printf("Workload %s %ld: %zu pages, %lu references (window %d)%s\n", name, n,
+           arenaPages, (unsigned long)traceCount, window, truncated ? ", TRUNCATED" : "");
+    printf("Run time: %.3f ms untraced, %.3f ms traced (%.1f us per recorded fault)\n",
+           plain * 1e3, traced * 1e3, traceCount ? (traced - plain) * 1e6 / traceCount : 0.0);
+    printf("Trace: %s, %ld bytes (%.2f bytes per reference)\n", path, fileBytes,
+           traceCount ? (double)(fileBytes - sizeof(struct TraceHeader)) / traceCount : 0.0);
+}
+
+/* ================================================================== */
+/*                 3. `exec`: sampling with soft-dirty bits           */
+/* ================================================================== */
+
+/**
+ * Checks that soft-dirty bits work here by writing to one of our own
+ * pages after clearing them.
+ */
+static int softDirtyWorks(void) {
+    volatile char *probe = mmap(NULL, pageSize, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (probe == MAP_FAILED) return 0;
+    probe[0] = 1;
+    int clear = open("/proc/self/clear_refs", O_WRONLY);
+    int map = open("/proc/self/pagemap", O_RDONLY);
+    uint64_t entry = 0;
+    if (clear != -1 && map != -1 && write(clear, "4", 1) == 1) {
+        probe[0] = 2;
+        if (pread(map, &entry, sizeof entry, (off_t)((uintptr_t)probe / pageSize) * 8) != 8) entry = 0;
+    }
+    if (clear != -1) close(clear);
+    if (map != -1) close(map);
+    munmap((void *)probe, pageSize);
+    return (entry >> 55) & 1;
+}
+
+// Appends every soft-dirty page of the target's writable mappings
+static void sampleDirty(pid_t pid, int pagemap, uint64_t **pages, uint64_t *count,
+                        uint64_t *capacity) {
+    char path[64], line[512];
+    snprintf(path, sizeof path, "/proc/%d/maps", (int)pid);
+    FILE *maps = fopen(path, "r");
+    if (!maps) return; // The target exited
+    uint64_t entries[512];
+    while (fgets(line, sizeof line, maps)) {
+        unsigned long from, to;
+        char perms[8];
+        if (sscanf(line, "%lx-%lx %7s", &from, &to, perms) != 3 || perms[1] != 'w') continue;
+        for (uint64_t page = from / pageSize; page < to / pageSize;) {
+            uint64_t chunk = to / pageSize - page;
+            if (chunk > 512) chunk = 512;
+            ssize_t got = pread(pagemap, entries, chunk * 8, (off_t)page * 8);
+            if (got <= 0) break;
+            for (ssize_t k = 0; k < got / 8; k++) {
+                if (!((entries[k] >> 55) & 1)) continue;
+                if (*count == *capacity) {
+                    *capacity = *capacity ? *capacity * 2 : 4096;
+                    *pages = realloc(*pages, *capacity * sizeof(uint64_t));
+                    if (!*pages) {
+                        perror("Allocation failed");
+                        exit(1);
+                    }
+                }
+                (*pages)[(*count)++] = page + k;
+            }
+            page += got / 8;
+        }
+    }
+    fclose(maps);
+}
+
+static void traceExec(char **argv, int intervalMs, const char *path) {
+    if (!softDirtyWorks()) {
+        fprintf(stderr, "Soft-dirty bits are not available in this kernel "
+                        "(CONFIG_MEM_SOFT_DIRTY); use `self` mode instead\n");
+        exit(1);
+    }
+    fflush(stdout); // fork() would duplicate buffered output
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("Fork failed");
+        exit(1);
+    }
+    if (pid == 0) {
+        // Being traced makes a successful exec stop us with SIGTRAP before
+        // the new program runs a single instruction
+        if (ptrace(PTRACE_TRACEME, 0, NULL, NULL) == -1) {
+            perror("PTRACE_TRACEME failed");
+            _exit(127);
+        }
+        execvp(argv[0], argv);
+        perror("exec failed");
+        _exit(127);
+    }
+
+    // /proc/PID/pagemap is bound to the address space it was opened on,
+    // so it must be opened after the exec replaced the child's one
+    int status;
+    if (waitpid(pid, &status, 0) == -1 || !WIFSTOPPED(status)) {
+        fprintf(stderr, "Target %s did not start\n", argv[0]);
+        exit(1);
+    }
+    char file[64];
+    snprintf(file, sizeof file, "/proc/%d/pagemap", (int)pid);
+    int pagemap = open(file, O_RDONLY);
+    snprintf(file, sizeof file, "/proc/%d/clear_refs", (int)pid);
+    int clear = open(file, O_WRONLY);
+    if (pagemap == -1 || clear == -1) {
+        perror("Opening /proc files of the target failed");
+        kill(pid, SIGKILL);
+        exit(1);
+    }
+    if (ptrace(PTRACE_DETACH, pid, NULL, NULL) == -1) {
+        perror("PTRACE_DETACH failed");
+        kill(pid, SIGKILL);
+        exit(1);
+    }
+
+    uint64_t *pages = NULL, count = 0, capacity = 0;
+    long samples = 0;
+    struct timespec interval = { intervalMs / 1000, (intervalMs % 1000) * 1000000L };
+    while (waitpid(pid, &status, WNOHANG) == 0) {
+        if (write(clear, "4", 1) != 1) break; // Clear soft-dirty bits
+        nanosleep(&interval, NULL);
+        sampleDirty(pid, pagemap, &pages, &count, &capacity);
+        samples++;
+    }
+    close(pagemap);
+    close(clear);
+
+    long fileBytes = writeTrace(path, pages, count, TRACE_SAMPLED);
+    printf("Target %s: %ld samples of %d ms, %lu written-page references\n", argv[0],
+           samples, intervalMs, (unsigned long)count);
+    printf("Trace: %s, %ld bytes\n", path, fileBytes);
+    free(pages);
+}
+
+/* ================================================================== */
+/*                   4. Feeding the simulators, statistics            */
+/* ================================================================== */
+
+static int compareU64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Renumbers pages densely (0, 1, 2, ... in order of first use) so they
+ * fit the simulators' int page numbers.
+ * @return Number of distinct pages.
+ */
+static uint64_t densify(uint64_t *pages, uint64_t count) {
+    uint64_t *sorted = malloc((count ? count : 1) * sizeof(uint64_t));
+    uint64_t *ids = malloc((count ? count : 1) * sizeof(uint64_t));
+    if (!sorted || !ids) {
+        perror("Allocation failed");
+        exit(1);
+    }
+    memcpy(sorted, pages, count * sizeof(uint64_t));
+    qsort(sorted, count, sizeof(uint64_t), compareU64);
+    uint64_t distinct = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        if (distinct == 0 || sorted[distinct - 1] != sorted[i]) sorted[distinct++] = sorted[i];
+    }
+    for (uint64_t i = 0; i < distinct; i++) ids[i] = UINT64_MAX;
+
+    uint64_t next = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t *slot = bsearch(&pages[i], sorted, distinct, sizeof(uint64_t), compareU64);
+        uint64_t k = (uint64_t)(slot - sorted);
+        if (ids[k] == UINT64_MAX) ids[k] = next++;
+        pages[i] = ids[k];
+    }
+    free(sorted);
+    free(ids);
+    return distinct;
+}
+
+// Prints the trace in the input format of PgFCFS.c / pgLRU.c / uffdPager.c
+static void dumpTrace(const char *path, int frames, uint64_t max) {
+    struct TraceHeader h;
+    uint64_t *pages = readTrace(path, &h);
+    uint64_t count = h.count < max ? h.count : max;
+    densify(pages, count);
+
+    printf("%d\n%lu\n", frames, (unsigned long)count);
+    for (uint64_t i = 0; i < count; i++) printf("%lu%c", (unsigned long)pages[i], i + 1 < count ? ' ' : '\n');
+    free(pages);
+}
+
+static void traceStats(const char *path) {
+    struct TraceHeader h;
+    uint64_t *pages = readTrace(path, &h);
+    uint64_t sequential = 0;
+    for (uint64_t i = 1; i < h.count; i++) sequential += pages[i] == pages[i - 1] + 1;
+    uint64_t distinct = densify(pages, h.count);
+
+    printf("%s: %lu references, %lu distinct pages of %u bytes (%s)\n", path,
+           (unsigned long)h.count, (unsigned long)distinct, h.pageSize,
+           h.flags & TRACE_SAMPLED ? "sampled, writes only" : "exact");
+    printf("Sequential steps: %.1f%%\n", h.count > 1 ? 100.0 * sequential / (h.count - 1) : 0.0);
+    free(pages);
+}
+
+static void usage(const char *name) {
+    fprintf(stderr,
+            "Usage: %s self [-w window] [-o file] scan|matmul|sort|random N\n"
+            "       %s exec [-i interval_ms] [-o file] program [args...]\n"
+            "       %s dump file frames [max]\n"
+            "       %s stats file\n", name, name, name, name);
+    exit(1);
+}
+
+int main(int argc, char *argv[]) {
+    pageSize = sysconf(_SC_PAGESIZE);
+    if (argc < 2) usage(argv[0]);
+
+    const char *mode = argv[1], *path = "page.trc";
+    int intervalMs = 10, a = 2;
+    // Options shared by `self` and `exec`
+    while (a + 1 < argc && argv[a][0] == '-') {
+        if (strcmp(argv[a], "-o") == 0) path = argv[a + 1];
+        else if (strcmp(argv[a], "-w") == 0) window = atoi(argv[a + 1]);
+        else if (strcmp(argv[a], "-i") == 0) intervalMs = atoi(argv[a + 1]);
+        else if (strcmp(argv[a], "-n") == 0) traceCapacity = strtoull(argv[a + 1], NULL, 10);
+        else usage(argv[0]);
+        a += 2;
+    }
+
+    if (strcmp(mode, "self") == 0 && argc - a == 2) {
+        // One page open at a time would livelock an instruction touching two
+        if (window < 2 || window > MAX_WINDOW) {
+            fprintf(stderr, "window must be 2..%d\n", MAX_WINDOW);
+            return 1;
+        }
+        long n = atol(argv[a + 1]);
+        if (n <= 0) usage(argv[0]);
+        traceSelf(argv[a], n, path);
+    } else if (strcmp(mode, "exec") == 0 && a < argc) {
+        if (intervalMs <= 0) usage(argv[0]);
+        traceExec(argv + a, intervalMs, path);
+    } else if (strcmp(mode, "dump") == 0 && argc >= 4) {
+        dumpTrace(argv[2], atoi(argv[3]), argc > 4 ? strtoull(argv[4], NULL, 10) : UINT64_MAX);
+    } else if (strcmp(mode, "stats") == 0 && argc == 3) {
+        traceStats(argv[2]);
+    } else {
+        usage(argv[0]);
+    }
+    return 0;
+}
@@ -0,0 +1,194 @@
+/*
+ * perfprof.h - hardware/software counter profiling for ANY of the programs
+ *
+ * Include it, then mark where each phase of the run starts:
+ *
+ *     perfPhase("input");    ... read the processes / matrices ...
+ *     perfPhase("compute");  ... run the algorithm ...
+ *     perfPhase("output");   ... print the results ...
+ *
+ * Nothing happens unless the PERFPROF environment variable is set, so the
+ * programs behave exactly as before. With PERFPROF=1 the counters below
+ * are opened with perf_event_open() (covering threads created later, too)
+ * and, at exit, a table with one row per phase goes to stderr:
+ *
+ *     cycles, instructions (and IPC), cache misses, branch misses,
+ *     context switches, page faults, task clock, wall time
+ *
+ * PERFPROF=json prints the same numbers as one JSON object instead.
+ * A phase entered several times accumulates. A counter the machine does
+ * not offer (hardware counters inside many VMs) shows as n/a.
+ *
+ * Example: printf '3\n0 5\n1 3\n2 8\n' | PERFPROF=1 ./SRTF
+ */
+
+#ifndef PERFPROF_H
+#define PERFPROF_H
+
+#include <stdio.h>
+#include <stdlib.h>              // For getenv(), atexit()
+#include <string.h>              // For memset(), strcmp()
+#include <stdint.h>              // For uint64_t
+#include <time.h>                // For clock_gettime()
+#include <unistd.h>              // For read(), syscall()
+#include <sys/syscall.h>         // For SYS_perf_event_open
+#include <linux/perf_event.h>    // For struct perf_event_attr
+
+#define PERF_MAX_PHASES 16
+#define PERF_COUNTERS 7
+
+static const struct {
+    const char *name;
+    uint32_t type;
+    uint64_t config;
+} perfEvents[PERF_COUNTERS] = {
+    { "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { "cache_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { "branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { "context_switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+    { "page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+    { "task_clock_ns", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK },
+};
+
+static struct {
+    int state;                   // 0 = not started, 1 = counting, -1 = off
+    int json;
+    int fd[PERF_COUNTERS];       // -1 = not available here
+    double last[PERF_COUNTERS];  // Counter values at the last phase change
+    double lastWall;
+    int current;                 // Running phase, or -1
+    int phases;
+    const char *names[PERF_MAX_PHASES];
+    double totals[PERF_MAX_PHASES][PERF_COUNTERS];
+    double wall[PERF_MAX_PHASES]; // Milliseconds
+} perfProf;
+
+static double perfWallMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// Opens one counter for this process (and threads it creates later)
+static int perfOpen(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof attr);
+    attr.size = sizeof attr;
+    attr.type = type;
+    attr.config = config;
+    attr.inherit = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (fd == -1) {
+        // Unprivileged users may only count user space
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+    return fd;
+}
+
+// Current value, scaled up if the kernel had to multiplex the counter
+static double perfRead(int fd) {
+    uint64_t v[3]; // value, time enabled, time running
+    if (read(fd, v, sizeof v) != sizeof v || v[2] == 0) return 0;
+    return (double)v[0] * ((double)v[1] / (double)v[2]);
+}
+
+static void perfPhase(const char *name);
+
+static void perfPrintValue(double value, int available, int json) {
+    if (!available) {
+        fprintf(stderr, json ? "null" : " %14s", "n/a");
+    } else {
+        fprintf(stderr, json ? "%.0f" : " %14.0f", value);
+    }
+}
+
+// atexit() handler: closes the last phase and prints the table to stderr
+static void perfReport(void) {
+    perfPhase(NULL);
+    fflush(stdout);
+
+    int json = perfProf.json;
+    if (json) {
+        fprintf(stderr, "{\"phases\": [");
+    } else {
+        fprintf(stderr, "\n--- perfprof ---\n%-10s %10s", "phase", "wall_ms");
+        for (int k = 0; k < PERF_COUNTERS; k++) fprintf(stderr, " %14s", perfEvents[k].name);
+        fprintf(stderr, " %6s\n", "IPC");
+    }
+    for (int p = 0; p < perfProf.phases; p++) {
+        double *t = perfProf.totals[p];
+        if (json) {
+            fprintf(stderr, "%s{\"name\": \"%s\", \"wall_ms\": %.3f", p ? ", " : "",
+                    perfProf.names[p], perfProf.wall[p]);
+        } else {
+            fprintf(stderr, "%-10s %10.3f", perfProf.names[p], perfProf.wall[p]);
+        }
+        for (int k = 0; k < PERF_COUNTERS; k++) {
+            if (json) fprintf(stderr, ", \"%s\": ", perfEvents[k].name);
+            perfPrintValue(t[k], perfProf.fd[k] != -1, json);
+        }
+        int haveIpc = perfProf.fd[0] != -1 && perfProf.fd[1] != -1 && t[0] > 0;
+        if (json) {
+            if (haveIpc) fprintf(stderr, ", \"ipc\": %.3f}", t[1] / t[0]);
+            else fprintf(stderr, ", \"ipc\": null}");
+        } else if (haveIpc) {
+            fprintf(stderr, " %6.2f\n", t[1] / t[0]);
+        } else {
+            fprintf(stderr, " %6s\n", "n/a");
+        }
+    }
+    if (json) fprintf(stderr, "]}\n");
+}
+
+/**
+ * Ends the running phase (adding what the counters moved to it) and
+ * starts `name`. NULL just ends the running phase. The first call opens
+ * the counters when PERFPROF is set.
+ */
+static void perfPhase(const char *name) {
+    if (perfProf.state == 0) {
+        const char *mode = getenv("PERFPROF");
+        if (mode == NULL || *mode == '\0' || strcmp(mode, "0") == 0) {
+            perfProf.state = -1;
+            return;
+        }
+        perfProf.json = strcmp(mode, "json") == 0;
+        for (int k = 0; k < PERF_COUNTERS; k++) {
+            perfProf.fd[k] = perfOpen(perfEvents[k].type, perfEvents[k].config);
+        }
+        perfProf.current = -1;
+        perfProf.state = 1;
+        atexit(perfReport);
+    }
+    if (perfProf.state < 0) return;
+
+    // Read everything first, then do the bookkeeping
+    double now[PERF_COUNTERS];
+    for (int k = 0; k < PERF_COUNTERS; k++) {
+        now[k] = perfProf.fd[k] != -1 ? perfRead(perfProf.fd[k]) : 0;
+    }
+    double wall = perfWallMs();
+
+    if (perfProf.current >= 0) {
+        for (int k = 0; k < PERF_COUNTERS; k++) {
+            perfProf.totals[perfProf.current][k] += now[k] - perfProf.last[k];
+        }
+        perfProf.wall[perfProf.current] += wall - perfProf.lastWall;
+    }
+    perfProf.current = -1;
+    if (name != NULL) {
+        int p = 0;
+        while (p < perfProf.phases && strcmp(perfProf.names[p], name) != 0) p++;
+        if (p == perfProf.phases && p < PERF_MAX_PHASES) perfProf.names[perfProf.phases++] = name;
+        if (p < perfProf.phases) perfProf.current = p;
+    }
+
+    memcpy(perfProf.last, now, sizeof now);
+    perfProf.lastWall = perfWallMs();
+}
+
+#endif
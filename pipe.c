@@ -3,15 +3,37 @@
  * The child process reads a string from the user (stdin)
  * and sends it to the parent process through the pipe.
  * The parent process reads the string from the pipe and prints it.
+ *
+ * BULK MODE: ./pipe bulk <size> [chunk] [pipe_size]
+ * Streams <size> bytes (suffixes K, M, G allowed) from child to parent.
+ * The parent drains the pipe WHILE the child writes (no wait() first, so
+ * messages bigger than the pipe capacity cannot deadlock), the pipe is
+ * resized with F_SETPIPE_SZ, and four transfer variants are timed:
+ *   write  -> read      two copies (user -> pipe -> user)
+ *   vmsplice -> read    child maps its pages into the pipe, one copy
+ *   write  -> splice    parent moves pipe pages to /dev/null, one copy
+ *   vmsplice -> splice  no copies in user space at all
+ * The transfer itself is oskPipeTransfer() (oskernels.c), which oskbench
+ * also times.
+ *
+ * Build: make pipe  (or: gcc pipe.c oskernels.c -pthread -o pipe)
  */
 
 #include <stdio.h>    // For printf, scanf, fgets
 #include <stdlib.h>   // For exit()
 #include <unistd.h>   // For pipe(), fork(), read(), write(), close()
-#include <string.h>   // For strlen()
+#include <string.h>   // For strlen(), strerror()
+#include <errno.h>    // For errno
 #include <sys/wait.h> // For wait()
+#include "oskernels.h" // For oskPipeTransfer(), the bulk transfer itself
 
-int main() {
+int bulkMode(int argc, char *argv[]);
+
+int main(int argc, char *argv[]) {
+
+    if (argc >= 3 && strcmp(argv[1], "bulk") == 0) {
+        return bulkMode(argc, argv);
+    }
     
     // STEP 1: Define variables
     int fd[2]; // File descriptor array for the pipe
@@ -81,4 +103,55 @@ int main() {
     }
 
     return 0;
-}
\ No newline at end of file
+}
+
+/* ================================================================== */
+/*                        BULK STREAMING MODE                         */
+/* ================================================================== */
+
+// Parses sizes like "4096", "64K", "16M", "2G"
+static long long parseSize(const char *text) {
+    char *end;
+    long long value = strtoll(text, &end, 10);
+    switch (*end) {
+    case 'k': case 'K': value <<= 10; break;
+    case 'm': case 'M': value <<= 20; break;
+    case 'g': case 'G': value <<= 30; break;
+    }
+    return value;
+}
+
+/**
+ * ./pipe bulk <size> [chunk] [pipe_size]
+ * Defaults: 256K chunks and a 1M pipe.
+ */
+int bulkMode(int argc, char *argv[]) {
+    long long total = parseSize(argv[2]);
+    long long chunk = (argc >= 4) ? parseSize(argv[3]) : (256LL << 10);
+    int pipeSize = (argc >= 5) ? (int)parseSize(argv[4]) : (1 << 20);
+
+    if (total <= 0 || chunk <= 0) {
+        printf("Usage: %s bulk <size> [chunk] [pipe_size]\n", argv[0]);
+        return 1;
+    }
+
+    const char *names[4] = { "write    -> read", "vmsplice -> read",
+                             "write    -> splice", "vmsplice -> splice" };
+    int actualPipeSize = 0;
+
+    printf("--- Bulk pipe transfer: %lld bytes, %lld-byte chunks ---\n", total, chunk);
+    for (int variant = 0; variant < 4; variant++) {
+        int useVmsplice = variant & 1;
+        int useSplice = (variant & 2) != 0;
+        double seconds = oskPipeTransfer(total, chunk, pipeSize, useVmsplice, useSplice,
+                                         &actualPipeSize);
+
+        if (seconds < 0) {
+            printf("%-20s FAILED: %s\n", names[variant], strerror(errno));
+        } else {
+            printf("%-20s %8.2f GB/s  (pipe size %d)\n", names[variant], total / seconds / 1e9,
+                   actualPipeSize);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,433 @@
+/*
+ * C Program for a PREFORK WORKER POOL with orphan-safe lifecycle.
+ *
+ * orphan.c shows a child being adopted by init when its parent exits
+ * first. A long-running pool must make that impossible, and should not
+ * pay for a fork() on every request. This program:
+ *
+ *  - forks N workers ONCE and keeps them warm; tasks are handed over
+ *    through a bounded queue in MAP_SHARED memory, guarded by a robust,
+ *    process-shared mutex and condition variables;
+ *  - every worker sets PR_SET_PDEATHSIG(SIGKILL), so if the pool parent
+ *    dies the workers die with it instead of becoming orphans;
+ *  - the parent sets PR_SET_CHILD_SUBREAPER, so any process a worker
+ *    orphans is re-parented to the pool (and reaped there), not to init;
+ *  - a worker that crashes is detected with waitpid(WNOHANG), its
+ *    in-flight task is re-queued and a replacement is forked.
+ *
+ * Finally it benchmarks the pool against fork-per-task.
+ *
+ * Usage: ./prefork [workers] [tasks] [work_per_task]
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>     // For exit(), atoi()
+#include <string.h>     // For memset()
+#include <errno.h>      // For EOWNERDEAD, ETIMEDOUT
+#include <signal.h>     // For SIGKILL
+#include <unistd.h>     // For fork(), getppid(), _exit()
+#include <pthread.h>    // For process-shared mutex / condvars
+#include <sys/prctl.h>  // For PR_SET_PDEATHSIG, PR_SET_CHILD_SUBREAPER
+#include <sys/mman.h>   // For mmap()
+#include <sys/wait.h>   // For waitpid()
+#include <time.h>       // For clock_gettime()
+
+#define QUEUE_SIZE 1024
+#define MAX_WORKERS 256
+
+enum TaskKind {
+    TASK_WORK,        // Burn some CPU
+    TASK_CRASH,       // Worker dies mid-task (tests respawn)
+    TASK_GRANDCHILD,  // Worker orphans a grandchild (tests subreaper)
+    TASK_STOP         // Poison pill: worker exits cleanly
+};
+
+struct Task {
+    int id;
+    enum TaskKind kind;
+    long work;
+};
+
+/*
+ * Everything shared between the pool parent and the workers.
+ */
+struct Pool {
+    pthread_mutex_t lock;      // Robust: survives a worker dying while holding it
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+    pthread_cond_t taskDone;
+
+    struct Task queue[QUEUE_SIZE];
+    int head, tail, count;
+
+    long completed;
+    long checksum;
+
+    // inFlight[w] = task the worker in slot w is running (id -1 if idle)
+    struct Task inFlight[MAX_WORKERS];
+};
+
+struct Pool *pool;
+pid_t workerPids[MAX_WORKERS];
+int numWorkers;
+pid_t poolParent;
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Locks the pool mutex, repairing it if the previous owner died
+static void poolLock() {
+    int rc = pthread_mutex_lock(&pool->lock);
+    if (rc == EOWNERDEAD) {
+        pthread_mutex_consistent(&pool->lock);
+    }
+}
+
+static void poolUnlock() {
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Waits on a condvar for at most 'ms' milliseconds
+static void poolWait(pthread_cond_t *cond, int ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_nsec += (long)ms * 1000000L;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+    deadline.tv_nsec %= 1000000000L;
+    if (pthread_cond_timedwait(cond, &pool->lock, &deadline) == EOWNERDEAD) {
+        pthread_mutex_consistent(&pool->lock);
+    }
+}
+
+/**
+ * Maps the pool and initialises the process-shared primitives.
+ */
+static void poolCreate() {
+    pool = mmap(NULL, sizeof(struct Pool), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (pool == MAP_FAILED) {
+        perror("mmap failed");
+        exit(1);
+    }
+
+    pthread_mutexattr_t ma;
+    pthread_mutexattr_init(&ma);
+    pthread_mutexattr_setpshared(&ma, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&ma, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&pool->lock, &ma);
+    pthread_mutexattr_destroy(&ma);
+
+    pthread_condattr_t ca;
+    pthread_condattr_init(&ca);
+    pthread_condattr_setpshared(&ca, PTHREAD_PROCESS_SHARED);
+    pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+    pthread_cond_init(&pool->notEmpty, &ca);
+    pthread_cond_init(&pool->notFull, &ca);
+    pthread_cond_init(&pool->taskDone, &ca);
+    pthread_condattr_destroy(&ca);
+
+    for (int w = 0; w < MAX_WORKERS; w++) pool->inFlight[w].id = -1;
+}
+
+static void poolDestroy() {
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->notEmpty);
+    pthread_cond_destroy(&pool->notFull);
+    pthread_cond_destroy(&pool->taskDone);
+    munmap(pool, sizeof(struct Pool));
+}
+
+// Caller holds the lock and has checked count < QUEUE_SIZE
+static void enqueueLocked(struct Task task) {
+    pool->queue[pool->tail] = task;
+    pool->tail = (pool->tail + 1) % QUEUE_SIZE;
+    pool->count++;
+    pthread_cond_signal(&pool->notEmpty);
+}
+
+// The actual work: a small integer hash loop
+static long doWork(long iterations, int seed) {
+    unsigned long x = (unsigned long)seed * 2654435761u + 1;
+    for (long i = 0; i < iterations; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+    }
+    return (long)(x & 0xffff);
+}
+
+/* ================================================================== */
+/*                          Worker side                               */
+/* ================================================================== */
+
+static void workerMain(int slot) {
+    // Die with the parent instead of being adopted by init. The parent
+    // may already be gone before prctl() ran, so check once afterwards.
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() != poolParent) {
+        _exit(1);
+    }
+
+    while (1) {
+        // --- Take a task ---
+        poolLock();
+        while (pool->count == 0) {
+            poolWait(&pool->notEmpty, 100);
+        }
+        struct Task task = pool->queue[pool->head];
+        pool->head = (pool->head + 1) % QUEUE_SIZE;
+        pool->count--;
+        pool->inFlight[slot] = task;
+        pthread_cond_signal(&pool->notFull);
+        poolUnlock();
+
+        // --- Run it (outside the lock) ---
+        long result = 0;
+        switch (task.kind) {
+        case TASK_STOP:
+            poolLock();
+            pool->inFlight[slot].id = -1;
+            poolUnlock();
+            _exit(0);
+        case TASK_CRASH:
+            // Simulate a bug: die while holding a task
+            _exit(3);
+        case TASK_GRANDCHILD: {
+            // Classic double fork: the middle process exits at once, so
+            // the grandchild is orphaned. With the subreaper set it is
+            // re-parented to the pool parent instead of init.
+            pid_t middle = fork();
+            if (middle == 0) {
+                if (fork() == 0) {
+                    usleep(1000);
+                    _exit(0);
+                }
+                _exit(0);
+            }
+            waitpid(middle, NULL, 0);
+            break;
+        }
+        case TASK_WORK:
+            result = doWork(task.work, task.id);
+            break;
+        }
+
+        // --- Report completion ---
+        poolLock();
+        pool->inFlight[slot].id = -1;
+        pool->completed++;
+        pool->checksum += result;
+        pthread_cond_signal(&pool->taskDone);
+        poolUnlock();
+    }
+}
+
+static void spawnWorker(int slot) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("Fork failed");
+        exit(1);
+    }
+    if (pid == 0) {
+        workerMain(slot);
+    }
+    workerPids[slot] = pid;
+}
+
+/* ================================================================== */
+/*                          Parent side                               */
+/* ================================================================== */
+
+long respawns;
+long adoptedReaped;
+
+// Tasks lost by dead workers that did not fit in the queue. Parent-side
+// only; they go back in before any new task is submitted.
+struct Task retryTasks[MAX_WORKERS];
+int numRetries;
+
+// Caller holds the lock
+static void flushRetriesLocked() {
+    while (numRetries > 0 && pool->count < QUEUE_SIZE) {
+        enqueueLocked(retryTasks[--numRetries]);
+    }
+}
+
+/**
+ * Reaps every dead child without blocking. A dead worker has its
+ * in-flight task re-queued and is replaced; any other pid is an abandoned
+ * grandchild we adopted as subreaper.
+ * Caller must NOT hold the lock.
+ */
+static void superviseChildren(int respawn) {
+    pid_t pid;
+    int status;
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+        int slot = -1;
+        for (int w = 0; w < numWorkers; w++) {
+            if (workerPids[w] == pid) slot = w;
+        }
+        if (slot == -1) {
+            adoptedReaped++;
+            continue;
+        }
+
+        workerPids[slot] = -1;
+        poolLock();
+        struct Task lost = pool->inFlight[slot];
+        pool->inFlight[slot].id = -1;
+        if (lost.id != -1 && lost.kind != TASK_STOP) {
+            // Run it again, but do not crash twice
+            if (lost.kind == TASK_CRASH) lost.kind = TASK_WORK;
+            // Never wait for room here: we are the one who would have to
+            // replace the workers that drain the queue
+            if (pool->count < QUEUE_SIZE) {
+                enqueueLocked(lost);
+            } else if (numRetries < MAX_WORKERS) {
+                retryTasks[numRetries++] = lost;
+            } else {
+                fprintf(stderr, "Retry list overflow\n");
+                exit(1);
+            }
+        }
+        poolUnlock();
+
+        if (respawn) {
+            spawnWorker(slot);
+            respawns++;
+        }
+    }
+    poolLock();
+    flushRetriesLocked();
+    poolUnlock();
+}
+
+static void submit(struct Task task) {
+    poolLock();
+    flushRetriesLocked();
+    while (pool->count == QUEUE_SIZE || numRetries > 0) {
+        poolUnlock();
+        superviseChildren(1);
+        poolLock();
+        flushRetriesLocked();
+        if (pool->count == QUEUE_SIZE) poolWait(&pool->notFull, 10);
+    }
+    enqueueLocked(task);
+    poolUnlock();
+}
+
+/**
+ * Runs 'tasks' tasks on the prefork pool.
+ * @return Elapsed seconds.
+ */
+static double runPool(int workers, long tasks, long work, int faults) {
+    poolCreate();
+    numWorkers = workers;
+    respawns = 0;
+    adoptedReaped = 0;
+    numRetries = 0;
+
+    double start = nowSeconds();
+    for (int w = 0; w < workers; w++) spawnWorker(w);
+
+    for (long t = 0; t < tasks; t++) {
+        struct Task task = { (int)t, TASK_WORK, work };
+        // Sprinkle in crashes and abandoned grandchildren
+        if (faults && t % 1000 == 500) task.kind = TASK_CRASH;
+        if (faults && t % 1000 == 750) task.kind = TASK_GRANDCHILD;
+        submit(task);
+    }
+
+    // Wait for every task, replacing workers that die meanwhile
+    poolLock();
+    while (pool->completed < tasks) {
+        poolUnlock();
+        superviseChildren(1);
+        poolLock();
+        if (pool->completed < tasks) poolWait(&pool->taskDone, 10);
+    }
+    poolUnlock();
+    double elapsed = nowSeconds() - start;
+
+    // Shut down: one poison pill per worker, then reap everything
+    for (int w = 0; w < workers; w++) {
+        struct Task stop = { -1, TASK_STOP, 0 };
+        submit(stop);
+    }
+    for (int w = 0; w < workers; w++) {
+        if (workerPids[w] > 0) waitpid(workerPids[w], NULL, 0);
+        workerPids[w] = -1;
+    }
+    // Adopted grandchildren may still be running
+    while (waitpid(-1, NULL, 0) > 0) adoptedReaped++;
+
+    poolDestroy();
+    return elapsed;
+}
+
+/**
+ * Baseline: one fork() per task, at most 'workers' children at once.
+ */
+static double runForkPerTask(int workers, long tasks, long work) {
+    double start = nowSeconds();
+    int running = 0;
+
+    fflush(stdout);
+    for (long t = 0; t < tasks; t++) {
+        if (running == workers) {
+            wait(NULL);
+            running--;
+        }
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("Fork failed");
+            exit(1);
+        }
+        if (pid == 0) {
+            _exit((int)(doWork(work, (int)t) & 0x7f));
+        }
+        running++;
+    }
+    while (running > 0) {
+        wait(NULL);
+        running--;
+    }
+    return nowSeconds() - start;
+}
+
+int main(int argc, char *argv[]) {
+    int workers = (argc >= 2) ? atoi(argv[1]) : 4;
+    long tasks = (argc >= 3) ? atol(argv[2]) : 20000;
+    long work = (argc >= 4) ? atol(argv[3]) : 1000;
+
+    if (workers <= 0 || workers > MAX_WORKERS || tasks <= 0 || work < 0) {
+        printf("Usage: %s [workers (1-%d)] [tasks] [work_per_task]\n", argv[0], MAX_WORKERS);
+        return 1;
+    }
+
+    // STEP 1: Become the subreaper for everything below us
+    poolParent = getpid();
+    if (prctl(PR_SET_CHILD_SUBREAPER, 1) == -1) {
+        perror("PR_SET_CHILD_SUBREAPER failed");
+    }
+
+    printf("--- Prefork pool: %d workers, %ld tasks, %ld iterations each ---\n", workers, tasks, work);
+
+    // STEP 2: Fault-injection run
+    double faulty = runPool(workers, tasks, work, 1);
+    printf("With faults:   %.3f s, %ld workers respawned, %ld adopted grandchildren reaped\n",
+           faulty, respawns, adoptedReaped);
+
+    // STEP 3: Pool vs fork-per-task
+    double pooled = runPool(workers, tasks, work, 0);
+    double forked = runForkPerTask(workers, tasks, work);
+
+    printf("Prefork pool:  %.3f s  (%.0f tasks/s)\n", pooled, tasks / pooled);
+    printf("Fork per task: %.3f s  (%.0f tasks/s)\n", forked, tasks / forked);
+    printf("Speedup:       %.1fx\n", forked / pooled);
+    return 0;
+}
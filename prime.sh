@@ -1,35 +1,76 @@
 #!/bin/bash
 
 # This script checks if a given number is prime.
+#
+# ./prime.sh             asks for one number
+# ./prime.sh 7 91 97     checks every number given
+# ./prime.sh < numbers   (with no terminal) checks every number read
+#
+# If the native engine is built next to this script
+# (gcc -O2 -pthread primes.c -o primes) all the numbers are handed to it
+# in ONE call; otherwise the bash trial-division loop below is used.
 
-# 1. Prompt the user for a number
-read -p "Enter a number to check if it's prime: " num
+engine="$(dirname "$0")/primes"
+
+# Trial division for one number (the fallback path)
+check_prime() {
+  local num=$1
+
+  # Handle special cases. 0 and 1 are not prime.
+  if [ $num -lt 2 ]; then
+    echo "$num is not a prime number."
+    return
+  fi
 
-# 2. Handle special cases. 0 and 1 are not prime.
-if [ $num -lt 2 ]; then
-  echo "$num is not a prime number."
-  exit 0 # Exit the script
+  # We will use a flag variable. 1 means prime, 0 means not prime.
+  local is_prime=1
+
+  # Loop from 2 up to (num / 2).
+  # We only need to check for divisors up to half of the number.
+  for (( i=2; i<=num/2; i++ ))
+  do
+    # Check if 'num' is divisible by 'i'
+    # We use the modulo operator (%)
+    if [ $((num % i)) -eq 0 ]; then
+      # If the remainder is 0, it has a divisor, so it's not prime.
+      is_prime=0
+      break # Found a divisor, no need to check further. Exit the loop.
+    fi
+  done
+
+  # After the loop, check the flag
+  if [ $is_prime -eq 1 ]; then
+    echo "$num is a prime number."
+  else
+    echo "$num is not a prime number."
+  fi
+}
+
+# 1. Bulk mode: numbers on the command line
+if [ $# -gt 0 ]; then
+  if [ -x "$engine" ]; then
+    exec "$engine" is "$@"
+  fi
+  for num in "$@"; do check_prime $num; done
+  exit 0
 fi
 
-# 3. We will use a flag variable. 1 means prime, 0 means not prime.
-is_prime=1 
-
-# 4. Loop from 2 up to (num / 2).
-# We only need to check for divisors up to half of the number.
-for (( i=2; i<=num/2; i++ ))
-do
-  # 5. Check if 'num' is divisible by 'i'
-  # We use the modulo operator (%)
-  if [ $((num % i)) -eq 0 ]; then
-    # If the remainder is 0, it has a divisor, so it's not prime.
-    is_prime=0
-    break # Found a divisor, no need to check further. Exit the loop.
+# 2. Bulk mode: numbers piped on stdin
+if [ ! -t 0 ]; then
+  if [ -x "$engine" ]; then
+    exec "$engine" is
   fi
-done
+  while read -r num; do
+    [ -n "$num" ] && check_prime $num
+  done
+  exit 0
+fi
 
-# 6. After the loop, check the flag
-if [ $is_prime -eq 1 ]; then
-  echo "$num is a prime number."
+# 3. Interactive: prompt the user for a number
+read -p "Enter a number to check if it's prime: " num
+
+if [ -x "$engine" ]; then
+  "$engine" is "$num"
 else
-  echo "$num is not a prime number."
-fi
\ No newline at end of file
+  check_prime $num
+fi
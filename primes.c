@@ -0,0 +1,362 @@
+/*
+ * Native prime engine behind prime.sh
+ *
+ * prime.sh tests one number with a bash loop up to num/2. This program
+ * answers many queries per run:
+ *
+ *   ./primes is N [N ...]        primality of each N (or of every number
+ *                                read from stdin when no N is given)
+ *   ./primes count LO HI [T]     number of primes in [LO, HI] using T threads
+ *   ./primes list LO HI          print the primes in [LO, HI]
+ *
+ * "is" uses deterministic Miller-Rabin, exact for every 64-bit number.
+ * "count" / "list" use a segmented Sieve of Eratosthenes:
+ *  - only odd numbers are stored, one byte each, in segments that fit in
+ *    the L1/L2 cache;
+ *  - every segment starts as a copy of a pre-sieved WHEEL pattern with
+ *    the multiples of 3, 5, 7, 11 and 13 already removed, so those small
+ *    primes (which cause most of the crossing-off work) cost nothing;
+ *  - segments are independent, so threads take them from a shared counter.
+ * Ranges that are narrow next to sqrt(HI), or above about 2^50, skip the
+ * sieve and test each odd number with Miller-Rabin on one thread.
+ *
+ * Compile: gcc -O2 -pthread primes.c -o primes
+ */
+
+#include <stdio.h>
+#include <stdlib.h>    // For malloc(), strtoull()
+#include <string.h>    // For memcpy(), strcmp()
+#include <stdint.h>    // For uint64_t
+#include <ctype.h>     // For isspace()
+#include <errno.h>     // For errno, ERANGE
+#include <limits.h>    // For ULLONG_MAX
+#include <stdbool.h>   // For bool
+#include <stdatomic.h> // For the shared segment counter
+#include <pthread.h>   // For the sieve threads
+#include <unistd.h>    // For sysconf()
+
+#define SEGMENT_BYTES (32 * 1024)     // Odd numbers per segment
+#define WHEEL_PERIOD (3 * 5 * 7 * 11 * 13) // In odd-number units
+#define FIRST_SIEVING_PRIME 17
+// "count" / "list" test each odd number with Miller-Rabin instead of
+// sieving when there are fewer than sqrt(HI) / DIRECT_TEST_RATIO of them,
+// or when sqrt(HI) >= DIRECT_TEST_ROOT: past that, scanning every base
+// prime once per segment costs more than testing the segment's numbers
+#define DIRECT_TEST_RATIO 64
+#define DIRECT_TEST_ROOT (1ULL << 25)
+
+/* ================================================================== */
+/*                        Miller-Rabin                                */
+/* ================================================================== */
+
+static uint64_t mulMod(uint64_t a, uint64_t b, uint64_t m) {
+    return (uint64_t)((unsigned __int128)a * b % m);
+}
+
+static uint64_t powMod(uint64_t base, uint64_t exp, uint64_t m) {
+    uint64_t result = 1;
+    base %= m;
+    while (exp > 0) {
+        if (exp & 1) result = mulMod(result, base, m);
+        base = mulMod(base, base, m);
+        exp >>= 1;
+    }
+    return result;
+}
+
+/**
+ * Deterministic for all n < 2^64 with these seven bases (Jim Sinclair).
+ */
+bool isPrime(uint64_t n) {
+    if (n < 2) return false;
+    static const uint64_t small[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+    for (int i = 0; i < 12; i++) {
+        if (n == small[i]) return true;
+        if (n % small[i] == 0) return false;
+    }
+
+    // n - 1 = d * 2^r with d odd
+    uint64_t d = n - 1;
+    int r = 0;
+    while ((d & 1) == 0) {
+        d >>= 1;
+        r++;
+    }
+
+    static const uint64_t bases[] = { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+    for (int i = 0; i < 7; i++) {
+        uint64_t a = bases[i] % n;
+        if (a == 0) continue;
+
+        uint64_t x = powMod(a, d, n);
+        if (x == 1 || x == n - 1) continue;
+
+        bool composite = true;
+        for (int k = 1; k < r; k++) {
+            x = mulMod(x, x, n);
+            if (x == n - 1) {
+                composite = false;
+                break;
+            }
+        }
+        if (composite) return false;
+    }
+    return true;
+}
+
+/* ================================================================== */
+/*                        Segmented sieve                             */
+/* ================================================================== */
+
+// Odd number 2*i + 1 is stored at index i
+unsigned char wheel[WHEEL_PERIOD];
+uint32_t *basePrimes;   // Sieving primes >= FIRST_SIEVING_PRIME
+int numBasePrimes;
+
+uint64_t rangeLo, rangeHi;      // Inclusive bounds requested
+uint64_t firstIndex, lastIndex; // Odd-index bounds covering the range
+uint64_t numSegments;
+atomic_ulong nextSegment;
+bool listMode;
+
+/**
+ * Builds the wheel pattern: 1 for odd numbers not divisible by 3..13.
+ */
+static void buildWheel() {
+    for (int i = 0; i < WHEEL_PERIOD; i++) {
+        uint64_t value = 2 * (uint64_t)i + 1;
+        wheel[i] = (value % 3 && value % 5 && value % 7 && value % 11 && value % 13) ? 1 : 0;
+    }
+}
+
+/**
+ * floor(sqrt(n)), one bit at a time. The root fits in 32 bits, so the
+ * squares never wrap.
+ */
+static uint64_t isqrt64(uint64_t n) {
+    uint64_t r = 0;
+    for (int bit = 31; bit >= 0; bit--) {
+        uint64_t candidate = r | (1ULL << bit);
+        if (candidate * candidate <= n) r = candidate;
+    }
+    return r;
+}
+
+/**
+ * Simple sieve for the primes up to limit = sqrt(HI).
+ */
+static void buildBasePrimes(uint64_t limit) {
+    unsigned char *composite = calloc(limit + 1, 1);
+    basePrimes = malloc((limit / 2 + 2) * sizeof(uint32_t));
+    if (composite == NULL || basePrimes == NULL) {
+        perror("malloc failed");
+        exit(1);
+    }
+
+    numBasePrimes = 0;
+    for (uint64_t i = 2; i <= limit; i++) {
+        if (composite[i]) continue;
+        if (i >= FIRST_SIEVING_PRIME) basePrimes[numBasePrimes++] = (uint32_t)i;
+        for (uint64_t j = i * i; j <= limit; j += i) composite[j] = 1;
+    }
+    free(composite);
+}
+
+/**
+ * Sieves segment 'seg' into 'buffer' and returns its prime count
+ * (printing the primes in list mode). Small primes 2..13 are handled by
+ * the caller.
+ */
+static uint64_t sieveSegment(uint64_t seg, unsigned char *buffer) {
+    uint64_t start = firstIndex + seg * SEGMENT_BYTES;
+    uint64_t end = start + SEGMENT_BYTES;
+    if (end > lastIndex + 1) end = lastIndex + 1;
+    uint64_t length = end - start;
+
+    // --- 1. Start from the wheel: multiples of 3..13 already gone ---
+    uint64_t offset = start % WHEEL_PERIOD;
+    uint64_t filled = 0;
+    while (filled < length) {
+        uint64_t chunk = WHEEL_PERIOD - offset;
+        if (chunk > length - filled) chunk = length - filled;
+        memcpy(buffer + filled, wheel + offset, chunk);
+        filled += chunk;
+        offset = 0;
+    }
+
+    // --- 2. Cross off odd multiples of the remaining primes ---
+    uint64_t lowValue = 2 * start + 1;
+    uint64_t highValue = 2 * (end - 1) + 1;
+    for (int k = 0; k < numBasePrimes; k++) {
+        uint64_t p = basePrimes[k];
+        if (p * p > highValue) break;
+
+        // First odd multiple of p that is >= max(p*p, lowValue)
+        uint64_t m = p * p;
+        if (m < lowValue) {
+            m = (lowValue + p - 1) / p * p;
+            if ((m & 1) == 0) m += p;
+        }
+        for (uint64_t i = (m - 1) / 2 - start; i < length; i += p) {
+            buffer[i] = 0;
+        }
+    }
+
+    // --- 3. Count (and optionally print) inside [rangeLo, rangeHi] ---
+    uint64_t count = 0;
+    uint64_t from = 0, to = length;
+    if (lowValue < rangeLo) from = (rangeLo - lowValue + 1) / 2;
+    if (highValue > rangeHi) to = length - (highValue - rangeHi + 1) / 2;
+
+    for (uint64_t i = from; i < to; i++) {
+        count += buffer[i];
+    }
+
+    if (listMode) {
+        for (uint64_t i = from; i < to; i++) {
+            uint64_t value = 2 * (start + i) + 1;
+            if (buffer[i]) printf("%llu\n", (unsigned long long)value);
+        }
+    }
+    return count;
+}
+
+static void *sieveWorker(void *arg) {
+    uint64_t *total = arg;
+    unsigned char *buffer = malloc(SEGMENT_BYTES);
+    if (buffer == NULL) {
+        perror("malloc failed");
+        exit(1);
+    }
+
+    uint64_t seg;
+    while ((seg = atomic_fetch_add(&nextSegment, 1)) < numSegments) {
+        *total += sieveSegment(seg, buffer);
+    }
+    free(buffer);
+    return NULL;
+}
+
+/**
+ * Tests the odd numbers in [lo, hi] one by one, for ranges where the sieve
+ * would spend its time on base primes rather than on the range.
+ */
+static uint64_t testRange(uint64_t lo, uint64_t hi, bool list) {
+    uint64_t count = 0;
+    for (uint64_t n = lo | 1; n <= hi; n += 2) {
+        if (isPrime(n)) {
+            count++;
+            if (list) printf("%llu\n", (unsigned long long)n);
+        }
+        if (n > hi - 2) break; // n + 2 would wrap past 2^64 - 1
+    }
+    return count;
+}
+
+/**
+ * Counts (or lists) the primes in [lo, hi].
+ */
+uint64_t sieveRange(uint64_t lo, uint64_t hi, int threads, bool list) {
+    if (hi < lo || hi < 2) return 0;
+
+    uint64_t count = 0;
+    static const uint64_t small[] = { 2, 3, 5, 7, 11, 13 };
+    for (int i = 0; i < 6; i++) {
+        if (small[i] >= lo && small[i] <= hi) {
+            count++;
+            if (list) printf("%llu\n", (unsigned long long)small[i]);
+        }
+    }
+
+    rangeLo = lo < 17 ? 17 : lo;
+    rangeHi = hi;
+    if (rangeLo > rangeHi) return count;
+
+    uint64_t limit = isqrt64(hi);
+    if (limit >= DIRECT_TEST_ROOT || (rangeHi - rangeLo) / 2 < limit / DIRECT_TEST_RATIO) {
+        return count + testRange(rangeLo, rangeHi, list);
+    }
+
+    buildWheel();
+    buildBasePrimes(limit);
+
+    firstIndex = (rangeLo - 1) / 2;
+    lastIndex = (rangeHi - 1) / 2;
+    numSegments = (lastIndex - firstIndex) / SEGMENT_BYTES + 1;
+    atomic_store(&nextSegment, 0);
+    listMode = list;
+
+    // Listing must stay in order, so it runs on one thread
+    if (list || threads < 1) threads = 1;
+
+    pthread_t tids[threads];
+    uint64_t totals[threads];
+    for (int t = 0; t < threads; t++) {
+        totals[t] = 0;
+        if (pthread_create(&tids[t], NULL, sieveWorker, &totals[t]) != 0) {
+            perror("pthread_create failed");
+            exit(1);
+        }
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(tids[t], NULL);
+        count += totals[t];
+    }
+
+    free(basePrimes);
+    return count;
+}
+
+/* ================================================================== */
+/*                        Command line                                */
+/* ================================================================== */
+
+static void answer(const char *text) {
+    char *end;
+    while (isspace((unsigned char)*text)) text++;
+    // strtoull() would wrap "-7" to 2^64 - 7. Negative numbers are not
+    // prime, which is also what the bash fallback in prime.sh says.
+    if (*text == '-') {
+        strtoll(text, &end, 10);
+        if (end != text) printf("%.*s is not a prime number.\n", (int)(end - text), text);
+        return;
+    }
+    errno = 0;
+    unsigned long long n = strtoull(text, &end, 10);
+    if (end == text) return;
+    if (errno == ERANGE) {
+        fprintf(stderr, "%.*s is out of range (max %llu)\n", (int)(end - text), text, ULLONG_MAX);
+        return;
+    }
+    printf("%llu is %sa prime number.\n", n, isPrime(n) ? "" : "not ");
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 2 && strcmp(argv[1], "is") == 0) {
+        if (argc > 2) {
+            for (int i = 2; i < argc; i++) answer(argv[i]);
+        } else {
+            // Bulk mode: one query per line (or whitespace separated)
+            char word[64];
+            while (scanf("%63s", word) == 1) answer(word);
+        }
+        return 0;
+    }
+
+    if (argc >= 4 && (strcmp(argv[1], "count") == 0 || strcmp(argv[1], "list") == 0)) {
+        uint64_t lo = strtoull(argv[2], NULL, 10);
+        uint64_t hi = strtoull(argv[3], NULL, 10);
+        bool list = strcmp(argv[1], "list") == 0;
+        int threads = (argc >= 5) ? atoi(argv[4]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+        uint64_t count = sieveRange(lo, hi, threads, list);
+        if (!list) printf("%llu\n", (unsigned long long)count);
+        return 0;
+    }
+
+    printf("Usage:\n");
+    printf("  %s is N [N ...]       (reads N from stdin if none given)\n", argv[0]);
+    printf("  %s count LO HI [threads]\n", argv[0]);
+    printf("  %s list LO HI\n", argv[0]);
+    return 1;
+}
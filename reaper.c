@@ -0,0 +1,531 @@
+/*
+ * C Program for a SCALABLE CHILD REAPER.
+ *
+ * zombie.c shows what happens when a parent never calls wait(): the dead
+ * child stays in the process table as a zombie. fork.c and pipe.c avoid
+ * that with a single blocking wait(NULL), which only works for one child.
+ *
+ * This file contains a small reusable SUPERVISOR that tracks thousands of
+ * children from ONE epoll loop and reaps each one as soon as it dies:
+ *
+ *   pidfd mode:    every child gets a pidfd (pidfd_open), which becomes
+ *                  readable when that child exits. The event tells us
+ *                  exactly which child to wait4().
+ *   signalfd mode: SIGCHLD is blocked and read through a signalfd; each
+ *                  wakeup drains every dead child the supervisor spawned
+ *                  (signals coalesce, so one SIGCHLD may stand for many).
+ *                  Children it did not spawn are never reaped.
+ *
+ * Either way the exit status and resource usage (rusage from wait4) are
+ * recorded, and zombies never pile up. The demo keeps N children alive
+ * under heavy churn and reports how long each dead child waited before
+ * it was reaped.
+ *
+ * Usage: ./reaper [pidfd|signalfd|both] [concurrent] [total]
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>        // For malloc(), exit(), atoi()
+#include <string.h>        // For strcmp(), memset()
+#include <stdint.h>        // For uint64_t
+#include <errno.h>         // For errno
+#include <signal.h>        // For sigprocmask(), SIGCHLD
+#include <unistd.h>        // For fork(), close(), usleep()
+#include <sys/epoll.h>     // For epoll_*()
+#include <sys/signalfd.h>  // For signalfd()
+#include <sys/syscall.h>   // For SYS_pidfd_open
+#include <sys/wait.h>      // For wait4()
+#include <sys/resource.h>  // For struct rusage, setrlimit()
+#include <sys/mman.h>      // For mmap()
+#include <time.h>          // For clock_gettime()
+
+#define MAX_EVENTS 256
+#define SIGNAL_TAG UINT32_MAX // epoll tag of the signalfd
+
+enum ReapMode { REAP_PIDFD, REAP_SIGNALFD };
+
+// What the supervisor remembers about one finished child
+struct ExitRecord {
+    pid_t pid;
+    int slot;
+    int status;            // As returned by wait4()
+    struct rusage usage;
+    uint64_t reapedNs;
+};
+
+typedef void (*ExitCallback)(const struct ExitRecord *record, void *context);
+
+// One tracked child
+struct Child {
+    pid_t pid;
+    int pidfd;      // pidfd mode only
+    int inUse;
+    int nextFree;
+};
+
+/*
+ * The supervisor. Children live in slots; in signalfd mode a small
+ * open-addressing table maps a pid back to its slot.
+ */
+struct Supervisor {
+    enum ReapMode mode;
+    int epfd;
+    int sigfd;
+    int capacity;
+    int live;
+    struct Child *children;
+    int freeHead;
+
+    int *pidTable;   // signalfd mode: slot index per hash bucket, -1 empty
+    int tableSize;
+
+    ExitCallback onExit;
+    void *context;
+};
+
+static uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/* ================================================================== */
+/*                    pid -> slot table (signalfd mode)               */
+/* ================================================================== */
+
+static unsigned int hashPid(pid_t pid, int size) {
+    return ((unsigned int)pid * 2654435761u) & (size - 1);
+}
+
+static void tableInsert(struct Supervisor *s, pid_t pid, int slot) {
+    unsigned int h = hashPid(pid, s->tableSize);
+    while (s->pidTable[h] != -1) h = (h + 1) & (s->tableSize - 1);
+    s->pidTable[h] = slot;
+}
+
+// Removes 'pid' and returns its slot, or -1 if it is not ours
+static int tableRemove(struct Supervisor *s, pid_t pid) {
+    unsigned int mask = s->tableSize - 1;
+    unsigned int h = hashPid(pid, s->tableSize);
+
+    while (s->pidTable[h] != -1 && s->children[s->pidTable[h]].pid != pid) h = (h + 1) & mask;
+    if (s->pidTable[h] == -1) return -1;
+
+    int slot = s->pidTable[h];
+    s->pidTable[h] = -1;
+
+    // Re-insert the rest of the cluster so lookups stay correct
+    for (unsigned int k = (h + 1) & mask; s->pidTable[k] != -1; k = (k + 1) & mask) {
+        int moved = s->pidTable[k];
+        s->pidTable[k] = -1;
+        tableInsert(s, s->children[moved].pid, moved);
+    }
+    return slot;
+}
+
+/* ================================================================== */
+/*                          Supervisor API                            */
+/* ================================================================== */
+
+/**
+ * Creates a supervisor for up to 'capacity' live children.
+ * @return NULL if pidfd mode was requested but the kernel lacks pidfd_open.
+ */
+struct Supervisor *supervisorCreate(enum ReapMode mode, int capacity, ExitCallback onExit, void *context) {
+    if (mode == REAP_PIDFD) {
+        // Probe for pidfd_open (Linux 5.3+) on ourselves
+        int probe = syscall(SYS_pidfd_open, getpid(), 0);
+        if (probe < 0) return NULL;
+        close(probe);
+    }
+
+    struct Supervisor *s = calloc(1, sizeof(struct Supervisor));
+    if (s == NULL) {
+        perror("malloc failed");
+        exit(1);
+    }
+    s->mode = mode;
+    s->capacity = capacity;
+    s->onExit = onExit;
+    s->context = context;
+    s->sigfd = -1;
+
+    s->children = calloc(capacity, sizeof(struct Child));
+    if (s->children == NULL) {
+        perror("malloc failed");
+        exit(1);
+    }
+    for (int i = 0; i < capacity; i++) {
+        s->children[i].nextFree = (i + 1 < capacity) ? i + 1 : -1;
+        s->children[i].pidfd = -1;
+    }
+    s->freeHead = 0;
+
+    s->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (s->epfd == -1) {
+        perror("epoll_create1 failed");
+        exit(1);
+    }
+
+    if (mode == REAP_SIGNALFD) {
+        s->tableSize = 1;
+        while (s->tableSize < capacity * 2) s->tableSize <<= 1;
+        s->pidTable = malloc(s->tableSize * sizeof(int));
+        if (s->pidTable == NULL) {
+            perror("malloc failed");
+            exit(1);
+        }
+        memset(s->pidTable, -1, s->tableSize * sizeof(int));
+
+        // SIGCHLD must be blocked so it is only delivered through the fd
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGCHLD);
+        sigprocmask(SIG_BLOCK, &mask, NULL);
+        s->sigfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+        if (s->sigfd == -1) {
+            perror("signalfd failed");
+            exit(1);
+        }
+        struct epoll_event ev = { .events = EPOLLIN, .data.u32 = SIGNAL_TAG };
+        epoll_ctl(s->epfd, EPOLL_CTL_ADD, s->sigfd, &ev);
+    }
+    return s;
+}
+
+/**
+ * Frees the supervisor. All children must have been reaped.
+ */
+void supervisorDestroy(struct Supervisor *s) {
+    if (s->sigfd != -1) {
+        close(s->sigfd);
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGCHLD);
+        sigprocmask(SIG_UNBLOCK, &mask, NULL);
+    }
+    close(s->epfd);
+    free(s->pidTable);
+    free(s->children);
+    free(s);
+}
+
+/**
+ * Forks a child that runs fn(slot, arg) and exits with its return value.
+ * @return The child's slot, or -1 if the supervisor is full.
+ */
+int supervisorSpawn(struct Supervisor *s, int (*fn)(int slot, void *arg), void *arg) {
+    if (s->freeHead == -1) return -1;
+
+    int slot = s->freeHead;
+    struct Child *c = &s->children[slot];
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("Fork failed");
+        exit(1);
+    }
+    if (pid == 0) {
+        _exit(fn(slot, arg));
+    }
+
+    s->freeHead = c->nextFree;
+    c->pid = pid;
+    c->inUse = 1;
+    s->live++;
+
+    if (s->mode == REAP_PIDFD) {
+        // Even if the child already died, its pidfd is valid and readable
+        c->pidfd = syscall(SYS_pidfd_open, pid, 0);
+        if (c->pidfd < 0) {
+            perror("pidfd_open failed");
+            exit(1);
+        }
+        struct epoll_event ev = { .events = EPOLLIN, .data.u32 = (uint32_t)slot };
+        epoll_ctl(s->epfd, EPOLL_CTL_ADD, c->pidfd, &ev);
+    } else {
+        tableInsert(s, pid, slot);
+    }
+    return slot;
+}
+
+// Records the exit and frees the slot
+static void finishChild(struct Supervisor *s, int slot, int status, const struct rusage *usage) {
+    struct Child *c = &s->children[slot];
+    struct ExitRecord record = { c->pid, slot, status, *usage, nowNs() };
+
+    if (c->pidfd != -1) {
+        close(c->pidfd); // Also removes it from the epoll set
+        c->pidfd = -1;
+    }
+    c->inUse = 0;
+    c->nextFree = s->freeHead;
+    s->freeHead = slot;
+    s->live--;
+
+    if (s->onExit) s->onExit(&record, s->context);
+}
+
+/**
+ * signalfd mode: reaps every dead child of OURS. Other children of this
+ * process (not spawned by the supervisor) are left for their owner.
+ * waitid(WNOWAIT) peeks at the next zombie without reaping it; if it is
+ * not ours it would come back on every peek, so fall back to asking each
+ * tracked child in turn.
+ * @return The number of children reaped.
+ */
+static int drainTracked(struct Supervisor *s) {
+    int reaped = 0;
+    int status;
+    struct rusage usage;
+    siginfo_t info;
+
+    while (1) {
+        info.si_pid = 0;
+        if (waitid(P_ALL, 0, &info, WEXITED | WNOHANG | WNOWAIT) == -1 || info.si_pid == 0) {
+            return reaped; // No children, or none dead
+        }
+        pid_t pid = info.si_pid;
+        int slot = tableRemove(s, pid);
+        if (slot < 0) break; // Not ours
+        if (wait4(pid, &status, WNOHANG, &usage) == pid) {
+            finishChild(s, slot, status, &usage);
+            reaped++;
+        }
+    }
+
+    for (int slot = 0; slot < s->capacity; slot++) {
+        struct Child *c = &s->children[slot];
+        if (!c->inUse) continue;
+        if (wait4(c->pid, &status, WNOHANG, &usage) == c->pid) {
+            tableRemove(s, c->pid);
+            finishChild(s, slot, status, &usage);
+            reaped++;
+        }
+    }
+    return reaped;
+}
+
+/**
+ * Waits up to 'timeoutMs' (-1 = forever) and reaps every child that died.
+ * @return The number of children reaped.
+ */
+int supervisorPoll(struct Supervisor *s, int timeoutMs) {
+    struct epoll_event events[MAX_EVENTS];
+    int reaped = 0;
+
+    int ready = epoll_wait(s->epfd, events, MAX_EVENTS, timeoutMs);
+    if (ready < 0) {
+        if (errno == EINTR) return 0;
+        perror("epoll_wait failed");
+        exit(1);
+    }
+
+    for (int e = 0; e < ready; e++) {
+        uint32_t tag = events[e].data.u32;
+        int status;
+        struct rusage usage;
+
+        if (tag != SIGNAL_TAG) {
+            // pidfd mode: the event names the child
+            struct Child *c = &s->children[tag];
+            if (!c->inUse) continue;
+            if (wait4(c->pid, &status, WNOHANG, &usage) == c->pid) {
+                finishChild(s, tag, status, &usage);
+                reaped++;
+            }
+            continue;
+        }
+
+        // signalfd mode: drain the pending signals, then every dead child
+        struct signalfd_siginfo info;
+        while (read(s->sigfd, &info, sizeof(info)) == sizeof(info));
+
+        reaped += drainTracked(s);
+    }
+    return reaped;
+}
+
+/* ================================================================== */
+/*                          Churn benchmark                           */
+/* ================================================================== */
+
+// Shared with the children: when each slot's child was about to exit
+uint64_t *exitStamp;
+
+struct ChurnStats {
+    long reaped;
+    long badStatus;
+    long latencyCount;
+    uint64_t latencySum;
+    uint64_t latencyMax;
+    uint64_t *latencies;
+    double childUserMs;
+    double childSysMs;
+    uint64_t checkStart, checkEnd; // Last zombie spot check, not timed
+};
+
+// The child: work for up to ~1 ms, stamp the time, exit with a known status
+static int churnChild(int slot, void *arg) {
+    (void)arg;
+    usleep((unsigned int)(slot * 37 % 1000));
+    exitStamp[slot] = nowNs();
+    return slot & 0x7f;
+}
+
+static void onChildExit(const struct ExitRecord *record, void *context) {
+    struct ChurnStats *stats = context;
+
+    if (!WIFEXITED(record->status) || WEXITSTATUS(record->status) != (record->slot & 0x7f)) {
+        stats->badStatus++;
+    }
+
+    uint64_t stamp = exitStamp[record->slot];
+    uint64_t latency = record->reapedNs > stamp ? record->reapedNs - stamp : 0;
+    // A child that died before or during the spot check waited through
+    // it; that time is the check's, not the reaper's
+    uint64_t from = stamp > stats->checkStart ? stamp : stats->checkStart;
+    uint64_t to = record->reapedNs < stats->checkEnd ? record->reapedNs : stats->checkEnd;
+    if (to > from && latency >= to - from) latency -= to - from;
+    stats->latencies[stats->latencyCount++] = latency;
+    stats->latencySum += latency;
+    if (latency > stats->latencyMax) stats->latencyMax = latency;
+
+    stats->childUserMs += record->usage.ru_utime.tv_sec * 1e3 + record->usage.ru_utime.tv_usec / 1e3;
+    stats->childSysMs += record->usage.ru_stime.tv_sec * 1e3 + record->usage.ru_stime.tv_usec / 1e3;
+    stats->reaped++;
+}
+
+static int compareU64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Counts our children that are zombies right now: the pids listed in
+// /proc/self/task/<pid>/children whose /proc/<pid>/stat state is 'Z'
+static int countZombies() {
+    char path[64], line[512];
+    snprintf(path, sizeof(path), "/proc/self/task/%d/children", (int)getpid());
+    FILE *list = fopen(path, "r");
+    if (list == NULL) return -1;
+
+    int zombies = 0, pid;
+    while (fscanf(list, "%d", &pid) == 1) {
+        snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+        FILE *f = fopen(path, "r");
+        if (f == NULL) continue; // Reaped in the meantime
+        // The state follows the last ')', since the name may contain one
+        if (fgets(line, sizeof(line), f) != NULL) {
+            char *close = strrchr(line, ')');
+            if (close != NULL && close[1] == ' ' && close[2] == 'Z') zombies++;
+        }
+        fclose(f);
+    }
+    fclose(list);
+    return zombies;
+}
+
+static void runChurn(enum ReapMode mode, int concurrent, long total) {
+    struct ChurnStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.latencies = malloc(total * sizeof(uint64_t));
+    if (stats.latencies == NULL) {
+        perror("malloc failed");
+        exit(1);
+    }
+
+    struct Supervisor *s = supervisorCreate(mode, concurrent, onChildExit, &stats);
+    const char *name = (mode == REAP_PIDFD) ? "pidfd" : "signalfd";
+    if (s == NULL) {
+        printf("%-10s not supported by this kernel (pidfd_open failed)\n", name);
+        free(stats.latencies);
+        return;
+    }
+
+    fflush(stdout);
+    uint64_t start = nowNs();
+    long spawned = 0;
+    int maxZombies = 0;
+    // Spot-check for lingering zombies every quarter of the spawns, with
+    // the clock stopped
+    long checkEvery = total / 4 + 1, nextCheck = checkEvery;
+    uint64_t checkNs = 0;
+
+    // Keep 'concurrent' children alive until 'total' have been started
+    while (stats.reaped < total) {
+        // Reap after every fork(), so children that die while we are
+        // spawning do not wait for the end of a batch
+        int batch = 0;
+        while (batch < 32 && spawned < total && supervisorSpawn(s, churnChild, NULL) >= 0) {
+            spawned++;
+            batch++;
+            supervisorPoll(s, 0);
+        }
+        if (batch == 0) supervisorPoll(s, -1);
+
+        if (spawned >= nextCheck) {
+            stats.checkStart = nowNs();
+            int z = countZombies();
+            if (z > maxZombies) maxZombies = z;
+            stats.checkEnd = nowNs();
+            checkNs += stats.checkEnd - stats.checkStart;
+            nextCheck += checkEvery;
+        }
+    }
+
+    double seconds = (nowNs() - start - checkNs) / 1e9;
+    qsort(stats.latencies, stats.latencyCount, sizeof(uint64_t), compareU64);
+
+    printf("%-10s %8ld %10.0f %10.1f %10.1f %10.1f %10.1f %8d %8ld\n",
+           name, stats.reaped, stats.reaped / seconds,
+           stats.latencySum / (double)stats.latencyCount / 1e3,
+           stats.latencies[stats.latencyCount / 2] / 1e3,
+           stats.latencies[(long)(stats.latencyCount * 0.99)] / 1e3,
+           stats.latencyMax / 1e3, maxZombies, stats.badStatus);
+    printf("%-10s children used %.1f ms user / %.1f ms sys (from wait4 rusage)\n", "",
+           stats.childUserMs, stats.childSysMs);
+
+    supervisorDestroy(s);
+    free(stats.latencies);
+}
+
+int main(int argc, char *argv[]) {
+    const char *which = (argc >= 2) ? argv[1] : "both";
+    int concurrent = (argc >= 3) ? atoi(argv[2]) : 1000;
+    long total = (argc >= 4) ? atol(argv[3]) : 20000;
+
+    if (concurrent <= 0 || total <= 0) {
+        printf("Usage: %s [pidfd|signalfd|both] [concurrent] [total]\n", argv[0]);
+        return 1;
+    }
+
+    // One pidfd per live child
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    exitStamp = mmap(NULL, concurrent * sizeof(uint64_t), PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (exitStamp == MAP_FAILED) {
+        perror("mmap failed");
+        return 1;
+    }
+
+    printf("--- Child reaping under churn: %d live children, %ld total ---\n", concurrent, total);
+    printf("%-10s %8s %10s %10s %10s %10s %10s %8s %8s\n", "mode", "reaped", "reaps/s",
+           "mean(us)", "p50(us)", "p99(us)", "max(us)", "zombies", "badexit");
+
+    if (strcmp(which, "pidfd") == 0 || strcmp(which, "both") == 0) {
+        runChurn(REAP_PIDFD, concurrent, total);
+    }
+    if (strcmp(which, "signalfd") == 0 || strcmp(which, "both") == 0) {
+        runChurn(REAP_SIGNALFD, concurrent, total);
+    }
+
+    munmap(exitStamp, concurrent * sizeof(uint64_t));
+    return 0;
+}
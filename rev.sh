@@ -1,14 +1,36 @@
 #!/bin/bash
 
 # This script reverses a string given by the user.
+#
+# ./rev.sh               asks for one string
+# ./rev.sh file ...      reverses every line of the files
+# ./rev.sh < file        (with no terminal) reverses every line read
+#
+# If the native reverser is built next to this script
+# (gcc -O2 -pthread revstream.c -o revstream, or make) it does the
+# work in one process; otherwise the standard 'rev' utility is used.
 
-# 1. Prompt the user for a string
+engine="$(dirname "$0")/revstream"
+if [ -x "$engine" ]; then
+  reverse="$engine"
+else
+  reverse="rev"
+fi
+
+# 1. Bulk mode: files on the command line, or lines piped on stdin
+if [ $# -gt 0 ]; then
+  exec $reverse "$@"
+fi
+if [ ! -t 0 ]; then
+  exec $reverse
+fi
+
+# 2. Prompt the user for a string
 read -p "Enter a string to reverse: " input_string
 
-# 2. Use the 'rev' command, which is a standard Linux utility for reversing.
-# We 'echo' the string and 'pipe' it (|) as input to the 'rev' command.
-reversed_string=$(echo "$input_string" | rev)
+# 3. We 'echo' the string and 'pipe' it (|) as input to the reverser.
+reversed_string=$(echo "$input_string" | $reverse)
 
-# 3. Print the result
+# 4. Print the result
 echo "Original string: $input_string"
-echo "Reversed string: $reversed_string"
\ No newline at end of file
+echo "Reversed string: $reversed_string"
@@ -0,0 +1,587 @@
+/*
+ * C Program to demonstrate a SHARED-MEMORY RING BUFFER for
+ * Inter-Process Communication (IPC), as an alternative to pipe().
+ *
+ * Like pipe.c, the child reads a string from the user (stdin) and sends
+ * it to the parent, which prints it. Instead of a kernel pipe (one write()
+ * and one read() syscall and two copies per message), the message goes
+ * through a single-producer / single-consumer ring in a MAP_SHARED region
+ * created before fork():
+ *
+ *  - head (consumer) and tail (producer) live on separate cache lines,
+ *    so the two sides never fight over the same line;
+ *  - both sides publish their index in batches, not once per message;
+ *  - a side that finds nothing to do spins briefly and then sleeps on a
+ *    futex. The other side only makes the futex_wake() syscall when it
+ *    sees the parked flag, so in the common case no syscall happens.
+ *
+ * ./shmRing          interactive demo (same usage as pipe.c)
+ * ./shmRing bench    latency / throughput comparison against a pipe
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>      // For exit()
+#include <string.h>      // For memcpy(), strlen() and strcmp()
+#include <stdint.h>      // For uint32_t
+#include <stdatomic.h>   // For the shared indices and flags
+#include <unistd.h>      // For fork(), pipe(), read(), write()
+#include <sys/mman.h>    // For mmap()
+#include <sys/wait.h>    // For wait()
+#include <sys/syscall.h> // For SYS_futex
+#include <linux/futex.h> // For FUTEX_WAIT / FUTEX_WAKE
+#include <time.h>        // For clock_gettime()
+
+#define RING_BYTES (8u << 20)     // Data area, power of two
+#define CACHE_LINE 64
+#define PUBLISH_BATCH 32          // Publish the index every N records...
+#define PUBLISH_BYTES (RING_BYTES / 8) // ...or every N bytes
+#define SPIN_LIMIT 200            // Polls before parking on the futex
+#define WRAP_MARKER 0xFFFFFFFFu   // Header meaning "skip to the start"
+#define MAX_MESSAGE (RING_BYTES / 4)
+
+/*
+ * The shared control block, followed by RING_BYTES of data.
+ * Indices count bytes forever and are masked on use.
+ */
+struct Ring {
+    // --- Written by the producer ---
+    _Alignas(CACHE_LINE) atomic_ulong tail;
+    atomic_uint dataSeq;        // Futex word the consumer sleeps on
+    atomic_uint producerParked; // Producer is asleep waiting for space
+    atomic_uint closed;         // No more messages will come
+
+    // --- Written by the consumer ---
+    _Alignas(CACHE_LINE) atomic_ulong head;
+    atomic_uint spaceSeq;       // Futex word the producer sleeps on
+    atomic_uint consumerParked; // Consumer is asleep waiting for data
+
+    _Alignas(CACHE_LINE) unsigned char data[];
+};
+
+// Spinning only helps if the other side is running on another core
+static int spinLimit = SPIN_LIMIT;
+
+// Private (not shared) state of each side
+struct Producer {
+    struct Ring *ring;
+    unsigned long tail;      // Next byte to write (may be ahead of ring->tail)
+    unsigned long headCache; // Last head we saw
+    int pendingRecords;
+    unsigned long pendingBytes;
+};
+
+struct Consumer {
+    struct Ring *ring;
+    unsigned long head;      // Next byte to read (may be ahead of ring->head)
+    unsigned long tailCache; // Last tail we saw
+    int pendingRecords;
+    unsigned long pendingBytes;
+};
+
+// --- Function Prototypes ---
+struct Ring *ringCreate();
+void producerInit(struct Producer *p, struct Ring *ring);
+void consumerInit(struct Consumer *c, struct Ring *ring);
+void ringSend(struct Producer *p, const void *message, uint32_t length);
+void ringFlush(struct Producer *p);
+void ringClose(struct Producer *p);
+long ringRecv(struct Consumer *c, void *buffer, uint32_t capacity);
+int runBenchmark();
+
+/* ================================================================== */
+/*                          Futex helpers                             */
+/* ================================================================== */
+
+// Not FUTEX_PRIVATE: the word is shared between two processes
+static void futexWait(atomic_uint *word, unsigned int expected) {
+    syscall(SYS_futex, word, FUTEX_WAIT, expected, NULL, NULL, 0);
+}
+
+static void futexWake(atomic_uint *word) {
+    syscall(SYS_futex, word, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+static inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+static inline uint32_t alignRecord(uint32_t length) {
+    return (8 + length + 7) & ~7u; // 8-byte header, payload padded to 8
+}
+
+/* ================================================================== */
+/*                          Setup                                     */
+/* ================================================================== */
+
+/**
+ * Maps the ring as MAP_SHARED | MAP_ANONYMOUS so that it survives fork()
+ * and both processes see the same pages.
+ */
+struct Ring *ringCreate() {
+    struct Ring *ring = mmap(NULL, sizeof(struct Ring) + RING_BYTES, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED) {
+        perror("mmap failed");
+        exit(1);
+    }
+    // Fresh anonymous pages are already zero: every index and flag starts at 0.
+
+    if (sysconf(_SC_NPROCESSORS_ONLN) <= 1) {
+        spinLimit = 0;
+    }
+    return ring;
+}
+
+void producerInit(struct Producer *p, struct Ring *ring) {
+    p->ring = ring;
+    p->tail = 0;
+    p->headCache = 0;
+    p->pendingRecords = 0;
+    p->pendingBytes = 0;
+}
+
+void consumerInit(struct Consumer *c, struct Ring *ring) {
+    c->ring = ring;
+    c->head = 0;
+    c->tailCache = 0;
+    c->pendingRecords = 0;
+    c->pendingBytes = 0;
+}
+
+/* ================================================================== */
+/*                          Producer side                             */
+/* ================================================================== */
+
+/**
+ * Makes everything written so far visible to the consumer, and wakes it
+ * up only if it went to sleep.
+ */
+void ringFlush(struct Producer *p) {
+    struct Ring *r = p->ring;
+
+    // seq_cst store + seq_cst load: either we see consumerParked, or the
+    // consumer sees our new tail before it sleeps.
+    atomic_store(&r->tail, p->tail);
+    p->pendingRecords = 0;
+    p->pendingBytes = 0;
+
+    if (atomic_load(&r->consumerParked)) {
+        atomic_fetch_add(&r->dataSeq, 1);
+        futexWake(&r->dataSeq);
+    }
+}
+
+// Blocks until 'needed' bytes are free at the producer's tail
+static void waitForSpace(struct Producer *p, unsigned long needed) {
+    struct Ring *r = p->ring;
+    int spins = 0;
+
+    while (p->tail + needed - p->headCache > RING_BYTES) {
+        p->headCache = atomic_load_explicit(&r->head, memory_order_acquire);
+        if (p->tail + needed - p->headCache <= RING_BYTES) {
+            return;
+        }
+
+        // The consumer can only free space for data it can see
+        if (p->pendingRecords > 0) {
+            ringFlush(p);
+        }
+
+        if (++spins < spinLimit) {
+            cpuRelax();
+            continue;
+        }
+
+        // Park until the consumer publishes a new head
+        unsigned int seq = atomic_load(&r->spaceSeq);
+        atomic_store(&r->producerParked, 1);
+        if (p->tail + needed - atomic_load(&r->head) > RING_BYTES) {
+            futexWait(&r->spaceSeq, seq);
+        }
+        atomic_store(&r->producerParked, 0);
+        spins = 0;
+    }
+}
+
+/**
+ * Copies one message into the ring. It becomes visible to the consumer at
+ * the next batch boundary or ringFlush().
+ */
+void ringSend(struct Producer *p, const void *message, uint32_t length) {
+    if (length > MAX_MESSAGE) {
+        fprintf(stderr, "Message of %u bytes exceeds the ring limit of %u\n", length, MAX_MESSAGE);
+        exit(1);
+    }
+
+    uint32_t record = alignRecord(length);
+    unsigned long pos = p->tail & (RING_BYTES - 1);
+    unsigned long toEnd = RING_BYTES - pos;
+
+    // A record never wraps: if it does not fit before the end, skip there
+    unsigned long needed = record + (toEnd < record ? toEnd : 0);
+    waitForSpace(p, needed);
+
+    if (toEnd < record) {
+        *(uint32_t *)&p->ring->data[pos] = WRAP_MARKER;
+        p->tail += toEnd;
+        pos = 0;
+    }
+
+    *(uint32_t *)&p->ring->data[pos] = length;
+    memcpy(&p->ring->data[pos + 8], message, length);
+    p->tail += record;
+
+    p->pendingRecords++;
+    p->pendingBytes += record;
+    if (p->pendingRecords >= PUBLISH_BATCH || p->pendingBytes >= PUBLISH_BYTES) {
+        ringFlush(p);
+    }
+}
+
+/**
+ * Flushes and tells the consumer no more messages will arrive.
+ */
+void ringClose(struct Producer *p) {
+    ringFlush(p);
+    atomic_store(&p->ring->closed, 1);
+    atomic_fetch_add(&p->ring->dataSeq, 1);
+    futexWake(&p->ring->dataSeq);
+}
+
+/* ================================================================== */
+/*                          Consumer side                             */
+/* ================================================================== */
+
+// Gives consumed space back to the producer
+static void consumerPublish(struct Consumer *c) {
+    struct Ring *r = c->ring;
+
+    atomic_store(&r->head, c->head);
+    c->pendingRecords = 0;
+    c->pendingBytes = 0;
+
+    if (atomic_load(&r->producerParked)) {
+        atomic_fetch_add(&r->spaceSeq, 1);
+        futexWake(&r->spaceSeq);
+    }
+}
+
+/**
+ * Receives the next message into 'buffer'.
+ * @return The message length, or -1 once the producer closed the ring
+ *         and every message has been read.
+ */
+long ringRecv(struct Consumer *c, void *buffer, uint32_t capacity) {
+    struct Ring *r = c->ring;
+    int spins = 0;
+
+    while (1) {
+        // --- Wait for data ---
+        while (c->head == c->tailCache) {
+            c->tailCache = atomic_load_explicit(&r->tail, memory_order_acquire);
+            if (c->head != c->tailCache) break;
+
+            // Let the producer reuse what we already read
+            if (c->pendingRecords > 0) {
+                consumerPublish(c);
+            }
+            if (atomic_load(&r->closed)) {
+                c->tailCache = atomic_load(&r->tail);
+                if (c->head == c->tailCache) return -1;
+                break;
+            }
+
+            if (++spins < spinLimit) {
+                cpuRelax();
+                continue;
+            }
+
+            // Park until the producer publishes a new tail
+            unsigned int seq = atomic_load(&r->dataSeq);
+            atomic_store(&r->consumerParked, 1);
+            if (atomic_load(&r->tail) == c->head && !atomic_load(&r->closed)) {
+                futexWait(&r->dataSeq, seq);
+            }
+            atomic_store(&r->consumerParked, 0);
+            spins = 0;
+        }
+
+        // --- Read one record ---
+        unsigned long pos = c->head & (RING_BYTES - 1);
+        uint32_t length = *(uint32_t *)&r->data[pos];
+        if (length == WRAP_MARKER) {
+            c->head += RING_BYTES - pos;
+            continue;
+        }
+
+        uint32_t record = alignRecord(length);
+        memcpy(buffer, &r->data[pos + 8], length < capacity ? length : capacity);
+        c->head += record;
+
+        c->pendingRecords++;
+        c->pendingBytes += record;
+        if (c->pendingRecords >= PUBLISH_BATCH || c->pendingBytes >= PUBLISH_BYTES) {
+            consumerPublish(c);
+        }
+        return length;
+    }
+}
+
+/* ================================================================== */
+/*                          Demo (like pipe.c)                        */
+/* ================================================================== */
+
+int main(int argc, char *argv[]) {
+
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0) {
+        return runBenchmark();
+    }
+
+    // STEP 1: Create the shared ring BEFORE fork(), so both processes map it
+    struct Ring *ring = ringCreate();
+    char write_buffer[100];
+    char read_buffer[100];
+
+    // STEP 2: Fork the process to create a child
+    pid_t pid = fork();
+
+    if (pid < 0) { // Fork Failed
+        perror("Fork failed");
+        exit(1);
+    }
+
+    // STEP 3: Child Process Logic (the producer)
+    if (pid == 0) {
+        struct Producer producer;
+        producerInit(&producer, ring);
+
+        printf("CHILD: Process started. Enter a string: ");
+        fflush(stdout);
+        if (fgets(write_buffer, sizeof(write_buffer), stdin) == NULL) {
+            write_buffer[0] = '\0';
+        }
+
+        // Send the string including its null terminator, then close
+        printf("CHILD: Writing string to ring...\n");
+        ringSend(&producer, write_buffer, strlen(write_buffer) + 1);
+        ringClose(&producer);
+        exit(0);
+    }
+
+    // STEP 4: Parent Process Logic (the consumer)
+    // No wait() needed first: ringRecv() sleeps until the message arrives.
+    struct Consumer consumer;
+    consumerInit(&consumer, ring);
+
+    if (ringRecv(&consumer, read_buffer, sizeof(read_buffer)) >= 0) {
+        read_buffer[sizeof(read_buffer) - 1] = '\0';
+        printf("PARENT: Received string from child: %s\n", read_buffer);
+    }
+    wait(NULL);
+
+    munmap(ring, sizeof(struct Ring) + RING_BYTES);
+    return 0;
+}
+
+/* ================================================================== */
+/*                          Benchmark                                 */
+/* ================================================================== */
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Reads exactly 'length' bytes from a pipe
+static int readFull(int fd, void *buffer, size_t length) {
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = read(fd, (char *)buffer + done, length - done);
+        if (n <= 0) return -1;
+        done += n;
+    }
+    return 0;
+}
+
+static void writeFull(int fd, const void *buffer, size_t length) {
+    size_t done = 0;
+    while (done < length) {
+        ssize_t n = write(fd, (const char *)buffer + done, length - done);
+        if (n <= 0) {
+            perror("write failed");
+            exit(1);
+        }
+        done += n;
+    }
+}
+
+/**
+ * Child streams 'count' messages of 'size' bytes to the parent.
+ * @return Messages per second.
+ */
+static double ringThroughput(uint32_t size, long count) {
+    struct Ring *ring = ringCreate();
+    char *buffer = calloc(1, size);
+
+    fflush(stdout);
+    double start = nowSeconds();
+    if (fork() == 0) {
+        struct Producer p;
+        producerInit(&p, ring);
+        for (long i = 0; i < count; i++) ringSend(&p, buffer, size);
+        ringClose(&p);
+        _exit(0);
+    }
+
+    struct Consumer c;
+    consumerInit(&c, ring);
+    long received = 0;
+    while (ringRecv(&c, buffer, size) >= 0) received++;
+    wait(NULL);
+    double elapsed = nowSeconds() - start;
+
+    free(buffer);
+    munmap(ring, sizeof(struct Ring) + RING_BYTES);
+    return received == count ? count / elapsed : -1;
+}
+
+static double pipeThroughput(uint32_t size, long count) {
+    int fd[2];
+    if (pipe(fd) == -1) {
+        perror("Pipe failed");
+        exit(1);
+    }
+    char *buffer = calloc(1, size + sizeof(uint32_t));
+
+    fflush(stdout);
+    double start = nowSeconds();
+    if (fork() == 0) {
+        close(fd[0]);
+        memcpy(buffer, &size, sizeof(uint32_t));
+        for (long i = 0; i < count; i++) writeFull(fd[1], buffer, size + sizeof(uint32_t));
+        close(fd[1]);
+        _exit(0);
+    }
+
+    close(fd[1]);
+    long received = 0;
+    uint32_t length;
+    while (readFull(fd[0], &length, sizeof(length)) == 0 && readFull(fd[0], buffer, length) == 0) {
+        received++;
+    }
+    close(fd[0]);
+    wait(NULL);
+    double elapsed = nowSeconds() - start;
+
+    free(buffer);
+    return received == count ? count / elapsed : -1;
+}
+
+/**
+ * Ping-pong: the parent sends a message, the child echoes it back.
+ * @return Average one-way latency in microseconds (round trip / 2).
+ */
+static double ringLatency(uint32_t size, long iterations) {
+    struct Ring *toChild = ringCreate();
+    struct Ring *toParent = ringCreate();
+    char *buffer = calloc(1, size);
+
+    fflush(stdout);
+    if (fork() == 0) {
+        struct Consumer in;
+        struct Producer out;
+        consumerInit(&in, toChild);
+        producerInit(&out, toParent);
+        long n;
+        while ((n = ringRecv(&in, buffer, size)) >= 0) {
+            ringSend(&out, buffer, (uint32_t)n);
+            ringFlush(&out);
+        }
+        ringClose(&out);
+        _exit(0);
+    }
+
+    struct Producer out;
+    struct Consumer in;
+    producerInit(&out, toChild);
+    consumerInit(&in, toParent);
+
+    double start = nowSeconds();
+    for (long i = 0; i < iterations; i++) {
+        ringSend(&out, buffer, size);
+        ringFlush(&out); // Latency test: publish every message
+        ringRecv(&in, buffer, size);
+    }
+    double elapsed = nowSeconds() - start;
+
+    ringClose(&out);
+    wait(NULL);
+    free(buffer);
+    munmap(toChild, sizeof(struct Ring) + RING_BYTES);
+    munmap(toParent, sizeof(struct Ring) + RING_BYTES);
+    return elapsed / iterations / 2 * 1e6;
+}
+
+static double pipeLatency(uint32_t size, long iterations) {
+    int down[2], up[2];
+    if (pipe(down) == -1 || pipe(up) == -1) {
+        perror("Pipe failed");
+        exit(1);
+    }
+    char *buffer = calloc(1, size);
+
+    fflush(stdout);
+    if (fork() == 0) {
+        close(down[1]);
+        close(up[0]);
+        while (readFull(down[0], buffer, size) == 0) writeFull(up[1], buffer, size);
+        _exit(0);
+    }
+    close(down[0]);
+    close(up[1]);
+
+    double start = nowSeconds();
+    for (long i = 0; i < iterations; i++) {
+        writeFull(down[1], buffer, size);
+        readFull(up[0], buffer, size);
+    }
+    double elapsed = nowSeconds() - start;
+
+    close(down[1]);
+    close(up[0]);
+    wait(NULL);
+    free(buffer);
+    return elapsed / iterations / 2 * 1e6;
+}
+
+/**
+ * Compares the ring against a pipe for small and large messages.
+ */
+int runBenchmark() {
+    uint32_t sizes[] = { 64, 4096, 65536, 1u << 20 };
+    int numSizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    printf("--- Throughput (child -> parent) ---\n");
+    printf("%-10s %16s %16s %12s %12s\n", "size", "ring msg/s", "pipe msg/s", "ring GB/s", "pipe GB/s");
+    for (int i = 0; i < numSizes; i++) {
+        long count = (long)((1ULL << 30) / sizes[i]);
+        if (count > 2000000) count = 2000000;
+        double ring = ringThroughput(sizes[i], count);
+        double pipeRate = pipeThroughput(sizes[i], count);
+        printf("%-10u %16.0f %16.0f %12.2f %12.2f\n", sizes[i], ring, pipeRate,
+               ring * sizes[i] / 1e9, pipeRate * sizes[i] / 1e9);
+    }
+
+    printf("\n--- One-way latency (ping-pong / 2) ---\n");
+    printf("%-10s %14s %14s\n", "size", "ring (us)", "pipe (us)");
+    for (int i = 0; i < numSizes; i++) {
+        long iterations = sizes[i] >= 65536 ? 2000 : 20000;
+        printf("%-10u %14.2f %14.2f\n", sizes[i], ringLatency(sizes[i], iterations),
+               pipeLatency(sizes[i], iterations));
+    }
+    return 0;
+}
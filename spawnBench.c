@@ -0,0 +1,198 @@
+/*
+ * C Program to benchmark PROCESS CREATION methods.
+ *
+ * fork.c, orphan.c and zombie.c all create processes with plain fork().
+ * fork() copies the parent's page tables, so its cost grows with the
+ * parent's resident memory, and every page the parent writes afterwards
+ * takes a copy-on-write (COW) fault. This program measures, for parent
+ * heaps from 1 MB up to the size given on the command line:
+ *
+ *   fork        child calls _exit(0) immediately
+ *   vfork       parent is suspended, child shares memory, _exit(0)
+ *   clone       clone(CLONE_VM | CLONE_VFORK) with a small private stack
+ *   posix_spawn spawn /bin/true (glibc uses CLONE_VM | CLONE_VFORK inside)
+ *   fork+exec   fork() then execv("/bin/true")
+ *
+ * For each it reports the mean creation-to-exit latency (spawn call until
+ * waitpid() returns) and spawns per second. Finally it counts the COW
+ * page faults the parent takes when it writes its heap after a fork().
+ *
+ * Usage: ./spawnBench [max_heap_MB] [iterations]
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>       // For malloc(), exit(), atol()
+#include <string.h>       // For memset()
+#include <unistd.h>       // For fork(), vfork(), execv(), pipe()
+#include <sched.h>        // For clone()
+#include <spawn.h>        // For posix_spawn()
+#include <signal.h>       // For SIGCHLD
+#include <sys/types.h>    // For pid_t
+#include <sys/wait.h>     // For waitpid()
+#include <sys/resource.h> // For getrusage()
+#include <time.h>         // For clock_gettime()
+
+#define CHILD_STACK (64 * 1024)
+#define PAGE 4096
+
+extern char **environ;
+
+enum Method { M_FORK, M_VFORK, M_CLONE, M_POSIX_SPAWN, M_FORK_EXEC, NUM_METHODS };
+const char *methodNames[NUM_METHODS] = { "fork", "vfork", "clone", "posix_spawn", "fork+exec" };
+
+static char *cloneStack;
+
+static double nowSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Entry point of the clone() child: nothing to do but exit
+static int cloneChild(void *arg) {
+    (void)arg;
+    _exit(0);
+}
+
+/**
+ * Creates one child with the given method and waits for it to exit.
+ * @return The elapsed time in seconds.
+ */
+static double spawnOnce(enum Method method) {
+    char *argv[] = { "/bin/true", NULL };
+    pid_t pid = -1;
+
+    double start = nowSeconds();
+    switch (method) {
+    case M_FORK:
+        pid = fork();
+        if (pid == 0) _exit(0);
+        break;
+    case M_VFORK:
+        pid = vfork();
+        if (pid == 0) _exit(0);
+        break;
+    case M_CLONE:
+        // The stack grows down on every common architecture
+        pid = clone(cloneChild, cloneStack + CHILD_STACK, CLONE_VM | CLONE_VFORK | SIGCHLD, NULL);
+        break;
+    case M_POSIX_SPAWN:
+        if (posix_spawn(&pid, "/bin/true", NULL, NULL, argv, environ) != 0) pid = -1;
+        break;
+    case M_FORK_EXEC:
+        pid = fork();
+        if (pid == 0) {
+            execv("/bin/true", argv);
+            _exit(127);
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (pid < 0) {
+        perror("spawn failed");
+        exit(1);
+    }
+    waitpid(pid, NULL, 0);
+    return nowSeconds() - start;
+}
+
+/**
+ * Forks while the child stays alive, then writes one byte per page of the
+ * heap and counts the minor faults the parent takes: each one is a
+ * copy-on-write break.
+ */
+static void measureCow(char *heap, size_t bytes) {
+    int gate[2];
+    if (pipe(gate) == -1) {
+        perror("Pipe failed");
+        exit(1);
+    }
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("Fork failed");
+        exit(1);
+    }
+    if (pid == 0) {
+        // Keep the pages shared until the parent is done writing
+        char c;
+        close(gate[1]);
+        while (read(gate[0], &c, 1) > 0);
+        _exit(0);
+    }
+    close(gate[0]);
+
+    struct rusage before, after;
+    getrusage(RUSAGE_SELF, &before);
+    double start = nowSeconds();
+    for (size_t off = 0; off < bytes; off += PAGE) {
+        heap[off]++;
+    }
+    double elapsed = nowSeconds() - start;
+    getrusage(RUSAGE_SELF, &after);
+
+    close(gate[1]);
+    waitpid(pid, NULL, 0);
+
+    long faults = after.ru_minflt - before.ru_minflt;
+    printf("   COW after fork: %ld faults for %zu pages written, %.2f ms (%.0f ns/fault)\n",
+           faults, bytes / PAGE, elapsed * 1e3, faults > 0 ? elapsed * 1e9 / faults : 0.0);
+}
+
+int main(int argc, char *argv[]) {
+    long maxMB = (argc >= 2) ? atol(argv[1]) : 1024;
+    int iterations = (argc >= 3) ? atoi(argv[2]) : 200;
+
+    if (maxMB < 1 || iterations < 1) {
+        printf("Usage: %s [max_heap_MB] [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    cloneStack = malloc(CHILD_STACK);
+    if (cloneStack == NULL) {
+        perror("malloc failed");
+        return 1;
+    }
+
+    printf("--- Process spawn benchmark (%d spawns per cell) ---\n", iterations);
+
+    for (long mb = 1; mb <= maxMB; mb *= 4) {
+        size_t bytes = (size_t)mb << 20;
+
+        // Make the whole heap resident: untouched pages cost fork() nothing
+        char *heap = malloc(bytes);
+        if (heap == NULL) {
+            printf("Cannot allocate %ld MB, stopping.\n", mb);
+            break;
+        }
+        memset(heap, 1, bytes);
+
+        printf("\nParent heap: %ld MB\n", mb);
+        printf("   %-12s %14s %14s\n", "method", "latency (us)", "spawns/s");
+
+        for (int m = 0; m < NUM_METHODS; m++) {
+            fflush(stdout); // fork() would duplicate buffered output
+
+            // fork() of a multi-GB parent takes milliseconds: scale down
+            int runs = iterations;
+            if ((m == M_FORK || m == M_FORK_EXEC) && mb >= 256) {
+                runs = iterations / 10 > 0 ? iterations / 10 : 1;
+            }
+
+            double total = 0;
+            for (int i = 0; i < runs; i++) {
+                total += spawnOnce((enum Method)m);
+            }
+            printf("   %-12s %14.1f %14.0f\n", methodNames[m], total / runs * 1e6, runs / total);
+        }
+
+        measureCow(heap, bytes);
+        free(heap);
+    }
+
+    free(cloneStack);
+    return 0;
+}
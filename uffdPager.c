@@ -0,0 +1,464 @@
+/*
+ * A REAL user-space pager built on userfaultfd.
+ *
+ * PgFCFS.c and pgLRU.c count faults on a list of integers. Here the pages
+ * are real memory and the faults are real:
+ *
+ *  1. A region of PAGES pages is mmap'd and registered with userfaultfd
+ *     (UFFD_USER_MODE_ONLY, so no privileges are needed). Touching a page
+ *     that is not resident blocks the toucher and sends a message to us.
+ *  2. A PAGER THREAD reads those messages. If all FRAMES are in use it
+ *     picks a victim with the same FIFO / LRU logic as PgFCFS.c and
+ *     pgLRU.c, copies the victim out to the backing store and drops it
+ *     with MADV_DONTNEED. Then it fills the faulting page with UFFDIO_COPY
+ *     (from the store, from the backing file, or zeros) and the toucher
+ *     continues.
+ *  3. The backing store keeps evicted pages RUN-LENGTH COMPRESSED, so a
+ *     mostly-empty page costs a few bytes instead of a full page.
+ *  4. Every access is TIMED. We print hits, faults, and the latency of a
+ *     faulting access (what the program feels) next to the pager's own
+ *     service time (what the handler spends).
+ *
+ * The workload writes a sequence number into each page it touches and
+ * checks it on the next touch, so a page that comes back wrong from the
+ * store is reported.
+ *
+ * Usage: ./uffdPager [fifo|lru]
+ *            then enter frames and a reference string like PgFCFS.c
+ *        ./uffdPager [fifo|lru] generate frames pages refs [file] [seed]
+ *            random references with locality; page i of FILE (if given)
+ *            is the initial content of page i
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>        // For malloc(), exit(), atoi()
+#include <string.h>        // For memcpy(), strcmp()
+#include <stdint.h>        // For uint64_t
+#include <errno.h>         // For errno
+#include <fcntl.h>         // For open(), O_CLOEXEC
+#include <poll.h>          // For poll()
+#include <pthread.h>       // For the pager thread
+#include <sched.h>         // For sched_yield()
+#include <time.h>          // For clock_gettime()
+#include <unistd.h>        // For sysconf(), pread(), syscall()
+#include <sys/ioctl.h>     // For ioctl()
+#include <sys/mman.h>      // For mmap(), madvise()
+#include <sys/syscall.h>   // For SYS_userfaultfd
+#include <linux/userfaultfd.h>
+
+#ifndef UFFD_USER_MODE_ONLY
+#define UFFD_USER_MODE_ONLY 1
+#endif
+
+#define PRINT_LIMIT 64 // Print the frames after each reference up to this many
+
+enum Policy { FIFO, LRU };
+
+/* ================================================================== */
+/*                        1. The pager's state                        */
+/* ================================================================== */
+
+static enum Policy policy = FIFO;
+static long pageSize;
+static int pageCount, frameCount;
+static char *region;             // The uffd-registered memory
+static int uffd;
+static int backingFd = -1;       // Optional file with initial contents
+
+// Frames, exactly like PgFCFS.c / pgLRU.c: which page each frame holds
+static int *frames;              // -1 = empty
+static long *lastUsedTime;       // LRU: "time" of the last access
+static int victimFrame = 0;      // FIFO: the next frame to replace
+static int *frameOf;             // Page -> frame, or -1 if not resident
+static long timeCounter = 0;
+
+// Backing store: one compressed copy per evicted page
+struct Slot {
+    unsigned char *data;
+    int length;
+};
+static struct Slot *store;
+static long storeBytes = 0, storedPages = 0;
+
+// Statistics
+static long faults = 0, hits = 0, evictions = 0;
+static double *serviceNs;        // Time the pager spent on each fault
+static long serviced = 0;        // serviceNs[] entries written so far
+static char *copyBuffer;         // One page, reused by the pager
+
+static double nowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* ================================================================== */
+/*                    2. Run-length compressed store                  */
+/* ================================================================== */
+
+/**
+ * Compresses one page as (count, byte) pairs, count 1..255. A page that
+ * does not shrink is stored as is (length == pageSize means raw).
+ * @return Stored length in bytes.
+ */
+static int compressPage(const unsigned char *in, unsigned char *out) {
+    int length = 0;
+    for (long i = 0; i < pageSize;) {
+        if (length + 2 >= pageSize) {
+            memcpy(out, in, pageSize);
+            return (int)pageSize;
+        }
+        long run = 1;
+        while (i + run < pageSize && run < 255 && in[i + run] == in[i]) run++;
+        out[length++] = (unsigned char)run;
+        out[length++] = in[i];
+        i += run;
+    }
+    return length;
+}
+
+static void decompressPage(const unsigned char *in, int length, unsigned char *out) {
+    if (length == pageSize) {
+        memcpy(out, in, pageSize);
+        return;
+    }
+    for (int i = 0; i < length; i += 2) {
+        memset(out, in[i + 1], in[i]);
+        out += in[i];
+    }
+}
+
+// Copies a resident page out to the store
+static void saveToStore(int page) {
+    static unsigned char *scratch;
+    if (!scratch) scratch = malloc(2 * pageSize);
+
+    int length = compressPage((unsigned char *)region + (long)page * pageSize, scratch);
+    struct Slot *s = &store[page];
+    if (s->data) {
+        storeBytes -= s->length;
+        storedPages--;
+    }
+    s->data = realloc(s->data, length);
+    if (!s->data) {
+        perror("Store allocation failed");
+        exit(1);
+    }
+    memcpy(s->data, scratch, length);
+    s->length = length;
+    storeBytes += length;
+    storedPages++;
+}
+
+/* ================================================================== */
+/*                          3. The pager thread                       */
+/* ================================================================== */
+
+/**
+ * Picks the frame for a new page: an empty one first, otherwise the
+ * FIFO pointer or the least recently used frame (same as PgFCFS/pgLRU).
+ */
+static int chooseFrame(void) {
+    for (int j = 0; j < frameCount; j++) {
+        if (frames[j] == -1) return j;
+    }
+    if (policy == FIFO) {
+        int j = victimFrame;
+        victimFrame = (victimFrame + 1) % frameCount;
+        return j;
+    }
+    int lruIndex = 0;
+    for (int j = 1; j < frameCount; j++) {
+        if (lastUsedTime[j] < lastUsedTime[lruIndex]) lruIndex = j;
+    }
+    return lruIndex;
+}
+
+// Services one fault on `page`
+static void servicePage(int page) {
+    double start = nowNs();
+    int j = chooseFrame();
+
+    // 1. Evict the victim: save it, then drop it from the address space
+    if (frames[j] != -1) {
+        int victim = frames[j];
+        saveToStore(victim);
+        if (madvise(region + (long)victim * pageSize, pageSize, MADV_DONTNEED) == -1) {
+            perror("madvise failed");
+            exit(1);
+        }
+        frameOf[victim] = -1;
+        evictions++;
+    }
+
+    // 2. Fill the page: store, backing file, or zeros
+    struct Slot *s = &store[page];
+    if (s->data) {
+        decompressPage(s->data, s->length, (unsigned char *)copyBuffer);
+    } else if (backingFd != -1) {
+        ssize_t got = pread(backingFd, copyBuffer, pageSize, (off_t)page * pageSize);
+        if (got < 0) got = 0;
+        memset(copyBuffer + got, 0, pageSize - got);
+    } else {
+        memset(copyBuffer, 0, pageSize);
+    }
+
+    frames[j] = page;
+    frameOf[page] = j;
+    lastUsedTime[j] = timeCounter;
+
+    // 3. Map it in and wake the faulting thread. Count the fault first:
+    //    the toucher may run (and read the counters) as soon as it is mapped.
+    long k = faults++;
+    struct uffdio_copy copy = {
+        .dst = (unsigned long)(region + (long)page * pageSize),
+        .src = (unsigned long)copyBuffer,
+        .len = pageSize,
+        .mode = 0,
+    };
+    if (ioctl(uffd, UFFDIO_COPY, &copy) == -1 && errno != EEXIST) {
+        perror("UFFDIO_COPY failed");
+        exit(1);
+    }
+    serviceNs[k] = nowNs() - start;
+    __atomic_store_n(&serviced, k + 1, __ATOMIC_RELEASE);
+}
+
+static void *pagerThread(void *arg) {
+    (void)arg;
+    struct pollfd pfd = { .fd = uffd, .events = POLLIN };
+    while (1) {
+        if (poll(&pfd, 1, -1) == -1) {
+            if (errno == EINTR) continue;
+            perror("poll failed");
+            exit(1);
+        }
+        struct uffd_msg msg;
+        ssize_t got = read(uffd, &msg, sizeof msg);
+        if (got == -1 && errno == EAGAIN) continue;
+        if (got != sizeof msg) {
+            perror("Reading userfaultfd failed");
+            exit(1);
+        }
+        if (msg.event != UFFD_EVENT_PAGEFAULT) continue;
+
+        long offset = (long)((char *)(uintptr_t)msg.arg.pagefault.address - region);
+        servicePage((int)(offset / pageSize));
+    }
+    return NULL;
+}
+
+/* ================================================================== */
+/*                              4. Setup                              */
+/* ================================================================== */
+
+static void setupRegion(void) {
+    region = mmap(NULL, (size_t)pageCount * pageSize, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+        perror("mmap failed");
+        exit(1);
+    }
+
+    // User-mode-only faults need no privilege; older kernels lack the flag
+    uffd = syscall(SYS_userfaultfd, O_CLOEXEC | O_NONBLOCK | UFFD_USER_MODE_ONLY);
+    if (uffd == -1 && errno == EINVAL) uffd = syscall(SYS_userfaultfd, O_CLOEXEC | O_NONBLOCK);
+    if (uffd == -1) {
+        perror("userfaultfd failed");
+        exit(1);
+    }
+
+    struct uffdio_api api = { .api = UFFD_API, .features = 0 };
+    if (ioctl(uffd, UFFDIO_API, &api) == -1) {
+        perror("UFFDIO_API failed");
+        exit(1);
+    }
+    struct uffdio_register reg = {
+        .range = { .start = (unsigned long)region, .len = (unsigned long)pageCount * pageSize },
+        .mode = UFFDIO_REGISTER_MODE_MISSING,
+    };
+    if (ioctl(uffd, UFFDIO_REGISTER, &reg) == -1) {
+        perror("UFFDIO_REGISTER failed");
+        exit(1);
+    }
+
+    frames = malloc(frameCount * sizeof(int));
+    lastUsedTime = calloc(frameCount, sizeof(long));
+    frameOf = malloc(pageCount * sizeof(int));
+    store = calloc(pageCount, sizeof(struct Slot));
+    copyBuffer = aligned_alloc(pageSize, pageSize);
+    if (!frames || !lastUsedTime || !frameOf || !store || !copyBuffer) {
+        perror("Allocation failed");
+        exit(1);
+    }
+    for (int j = 0; j < frameCount; j++) frames[j] = -1;
+    for (int i = 0; i < pageCount; i++) frameOf[i] = -1;
+}
+
+/* ================================================================== */
+/*                      5. The workload and the report                */
+/* ================================================================== */
+
+// Helper function to print the frames (same format as PgFCFS.c)
+static void printFrames(void) {
+    for (int j = 0; j < frameCount; j++) {
+        if (frames[j] == -1) {
+            printf("[_] ");
+        } else {
+            printf("[%d] ", frames[j]);
+        }
+    }
+    printf("\n");
+}
+
+static int compareDouble(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void printLatency(const char *name, double *ns, long count) {
+    if (count == 0) return;
+    double sum = 0;
+    for (long i = 0; i < count; i++) sum += ns[i];
+    qsort(ns, count, sizeof(double), compareDouble);
+    printf("%-18s avg %8.2f us   p50 %8.2f   p99 %8.2f   max %8.2f\n", name,
+           sum / count / 1e3, ns[count / 2] / 1e3, ns[(long)(count * 0.99)] / 1e3,
+           ns[count - 1] / 1e3);
+}
+
+/**
+ * Touches every page of the reference string: checks the sequence number
+ * the last touch left there, then writes a new one.
+ */
+static void runWorkload(const int *refs, long refCount) {
+    uint64_t *expected = calloc(pageCount, sizeof(uint64_t));
+    double *accessNs = malloc(refCount * sizeof(double));
+    if (!expected || !accessNs) {
+        perror("Allocation failed");
+        exit(1);
+    }
+    // With a backing file, the first touch must see the file's bytes
+    for (int i = 0; backingFd != -1 && i < pageCount; i++) {
+        if (pread(backingFd, &expected[i], sizeof(uint64_t), (off_t)i * pageSize) <= 0) expected[i] = 0;
+    }
+
+    long faultedAccesses = 0, corrupt = 0;
+    int verbose = refCount <= PRINT_LIMIT;
+    double start = nowNs();
+    for (long i = 0; i < refCount; i++) {
+        int page = refs[i];
+        timeCounter++;
+        int resident = frameOf[page] != -1;
+        if (resident) {
+            hits++;
+            lastUsedTime[frameOf[page]] = timeCounter; // Our "reference bit"
+        }
+
+        volatile uint64_t *word = (uint64_t *)(region + (long)page * pageSize);
+        double t = nowNs();
+        uint64_t seen = *word; // May fault; the pager thread fills the page
+        *word = (uint64_t)i + 1;
+        double spent = nowNs() - t;
+
+        if (seen != expected[page]) corrupt++;
+        expected[page] = (uint64_t)i + 1;
+        if (!resident) accessNs[faultedAccesses++] = spent;
+
+        if (verbose) {
+            printf("%s (Page %d): ", resident ? "Hit  " : "Fault", page);
+            printFrames();
+        }
+    }
+    double elapsed = nowNs() - start;
+    // The pager records the last service time after waking us
+    while (__atomic_load_n(&serviced, __ATOMIC_ACQUIRE) < faults) sched_yield();
+
+    printf("\n--- %s user-space pager: %d frames, %d pages of %ld bytes ---\n",
+           policy == FIFO ? "FIFO" : "LRU", frameCount, pageCount, pageSize);
+    printf("References: %ld   Hits: %ld   Faults: %ld   Evictions: %ld\n",
+           refCount, hits, faults, evictions);
+    printf("Total Page Faults: %ld\n", faults);
+    printLatency("Faulting access:", accessNs, faultedAccesses);
+    printLatency("Pager service:", serviceNs, faults);
+    printf("Store: %ld pages, %ld bytes compressed (%.1f%% of raw)\n", storedPages,
+           storeBytes, storedPages ? 100.0 * storeBytes / (storedPages * pageSize) : 0.0);
+    printf("Run time: %.3f ms (%.0f references/s)\n", elapsed / 1e6, refCount / (elapsed / 1e9));
+    if (corrupt) printf("ERROR: %ld accesses saw wrong page contents\n", corrupt);
+    free(expected);
+    free(accessNs);
+}
+
+int main(int argc, char *argv[]) {
+    pageSize = sysconf(_SC_PAGESIZE);
+    int a = 1;
+    if (a < argc && strcmp(argv[a], "lru") == 0) policy = LRU, a++;
+    else if (a < argc && strcmp(argv[a], "fifo") == 0) a++;
+
+    int *refs;
+    long refCount;
+    if (a < argc && strcmp(argv[a], "generate") == 0) {
+        if (argc - a < 4) {
+            fprintf(stderr, "Usage: %s [fifo|lru] generate frames pages refs [file] [seed]\n", argv[0]);
+            return 1;
+        }
+        frameCount = atoi(argv[a + 1]);
+        pageCount = atoi(argv[a + 2]);
+        refCount = atol(argv[a + 3]);
+        if (argc - a > 4 && strcmp(argv[a + 4], "-") != 0) {
+            backingFd = open(argv[a + 4], O_RDONLY | O_CLOEXEC);
+            if (backingFd == -1) {
+                perror("Opening backing file failed");
+                return 1;
+            }
+        }
+        srand(argc - a > 5 ? atoi(argv[a + 5]) : 1);
+        if (frameCount <= 0 || pageCount <= 0 || refCount <= 0) {
+            fprintf(stderr, "frames, pages and refs must be positive\n");
+            return 1;
+        }
+        refs = malloc(refCount * sizeof(int));
+        if (!refs) {
+            perror("Allocation failed");
+            return 1;
+        }
+        // Locality: mostly stay near a slowly moving working set
+        int base = 0, window = frameCount + frameCount / 4 + 1;
+        for (long i = 0; i < refCount; i++) {
+            if (rand() % 100 == 0) base = rand() % pageCount;
+            refs[i] = rand() % 10 == 0 ? rand() % pageCount : (base + rand() % window) % pageCount;
+        }
+    } else {
+        printf("Enter number of page frames: ");
+        if (scanf("%d", &frameCount) != 1 || frameCount <= 0) return 1;
+        printf("Enter length of reference string: ");
+        if (scanf("%ld", &refCount) != 1 || refCount <= 0) return 1;
+        refs = malloc(refCount * sizeof(int));
+        if (!refs) {
+            perror("Allocation failed");
+            return 1;
+        }
+        printf("Enter the reference string (e.g., 1 2 3 4...): ");
+        pageCount = 0;
+        for (long i = 0; i < refCount; i++) {
+            if (scanf("%d", &refs[i]) != 1 || refs[i] < 0) return 1;
+            if (refs[i] >= pageCount) pageCount = refs[i] + 1;
+        }
+        printf("\n");
+    }
+
+    serviceNs = malloc(refCount * sizeof(double));
+    if (!serviceNs) {
+        perror("Allocation failed");
+        return 1;
+    }
+    setupRegion();
+
+    pthread_t pager;
+    if (pthread_create(&pager, NULL, pagerThread, NULL) != 0) {
+        perror("Creating the pager thread failed");
+        return 1;
+    }
+    runWorkload(refs, refCount);
+    return 0;
+}